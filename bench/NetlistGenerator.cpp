@@ -0,0 +1,229 @@
+// File: bench/NetlistGenerator.cpp
+
+#include "NetlistGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct CellMaster {
+    const char* name;
+    const char* inputs[4];
+    unsigned num_inputs;
+    const char* output;
+    bool sequential;
+};
+
+// A slice of a Nangate45-like library, weighted roughly like gcd_nangate45.v.
+const CellMaster kMasters[] = {
+    {"NAND2_X1", {"A1", "A2"}, 2, "ZN", false},
+    {"NAND2_X1", {"A1", "A2"}, 2, "ZN", false},
+    {"INV_X1", {"A"}, 1, "ZN", false},
+    {"OAI21_X1", {"A", "B1", "B2"}, 3, "ZN", false},
+    {"DFF_X1", {"CK", "D"}, 2, "Q", true},
+    {"XNOR2_X1", {"A", "B"}, 2, "ZN", false},
+    {"NAND3_X1", {"A1", "A2", "A3"}, 3, "ZN", false},
+    {"MUX2_X1", {"A", "B", "S"}, 3, "Z", false},
+    {"OAI22_X1", {"A1", "A2", "B1", "B2"}, 4, "ZN", false},
+    {"NOR2_X1", {"A1", "A2"}, 2, "ZN", false},
+    {"AOI21_X1", {"A", "B1", "B2"}, 3, "ZN", false},
+    {"BUF_X4", {"A"}, 1, "Z", false},
+};
+constexpr uint64_t kNumMasters = sizeof(kMasters) / sizeof(kMasters[0]);
+
+enum Salt : uint64_t {
+    kMaster = 1,
+    kBus,
+    kEscapedNet,
+    kEscapedInst,
+    kMultiline,
+    kDriver,
+    kPortPick,
+    kAttribute,
+};
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+void flush(std::string& buf, std::FILE* out, bool force = false) {
+    if (force || buf.size() >= (1u << 20)) {
+        std::fwrite(buf.data(), 1, buf.size(), out);
+        buf.clear();
+    }
+}
+
+}  // namespace
+
+NetlistGenerator::NetlistGenerator(const NetlistGeneratorConfig& config) : config_(config) {
+    config_.bus_width = std::max(1u, config_.bus_width);
+    config_.fanout_skew = std::max(1.0, config_.fanout_skew);
+}
+
+uint64_t NetlistGenerator::hash(uint64_t salt, uint64_t index) const {
+    return splitmix64(config_.seed * 0x100000001b3ull ^ splitmix64(salt * 0x9e3779b97f4a7c15ull ^ index));
+}
+
+double NetlistGenerator::uniform(uint64_t salt, uint64_t index) const {
+    return (hash(salt, index) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint64_t NetlistGenerator::cellCount() const {
+    return config_.instances + config_.bus_width;
+}
+
+uint64_t NetlistGenerator::masterIndex(uint64_t instance) const {
+    return hash(kMaster, instance) % kNumMasters;
+}
+
+bool NetlistGenerator::isBusGroup(uint64_t group) const {
+    return config_.bus_width > 1 && uniform(kBus, group) < config_.bus_ratio;
+}
+
+// Net i is driven by instance i. Nets come in groups of bus_width ids; a
+// group is either one bus wire or bus_width scalar wires.
+void NetlistGenerator::appendNetName(std::string& out, uint64_t net) const {
+    const uint64_t group = net / config_.bus_width;
+    if (isBusGroup(group)) {
+        out += "bus_";
+        out += std::to_string(group);
+        out += '[';
+        out += std::to_string(net % config_.bus_width);
+        out += ']';
+    } else if (uniform(kEscapedNet, net) < config_.escaped_ratio) {
+        out += "\\u_blk";
+        out += std::to_string(group % 64);
+        out += ".n";
+        out += std::to_string(net);
+        out += "[0] ";
+    } else {
+        out += '_';
+        out += std::to_string(net);
+        out += '_';
+    }
+}
+
+void NetlistGenerator::appendInstanceName(std::string& out, uint64_t instance) const {
+    if (uniform(kEscapedInst, instance) < config_.escaped_ratio) {
+        out += "\\u_blk";
+        out += std::to_string((instance / config_.bus_width) % 64);
+        out += ".g";
+        out += std::to_string(instance);
+        out += ' ';
+    } else {
+        out += "_g";
+        out += std::to_string(instance);
+        out += '_';
+    }
+}
+
+// Picks what drives input `pin` of `instance`: an earlier net, chosen with a
+// bias towards low ids so fanout follows a heavy-tailed distribution, or a
+// primary input bit.
+void NetlistGenerator::appendDriver(std::string& out, uint64_t instance, unsigned pin) const {
+    const uint64_t key = instance * 4 + pin;
+    const double u = uniform(kDriver, key);
+    if (instance == 0 || uniform(kPortPick, key) < 0.02) {
+        out += "din[";
+        out += std::to_string(hash(kPortPick, key) % config_.bus_width);
+        out += ']';
+        return;
+    }
+    const uint64_t source = static_cast<uint64_t>(instance * std::pow(u, config_.fanout_skew));
+    appendNetName(out, std::min(source, instance - 1));
+}
+
+// Yosys puts a source location in front of most wires and cells.
+void NetlistGenerator::appendAttribute(std::string& out, uint64_t salt, uint64_t index) const {
+    if (uniform(kAttribute, salt * 0x10000000000ull + index) >= config_.attribute_ratio) return;
+    out += "(* src = \"rtl/top.v:";
+    out += std::to_string(index % 10000 + 1);
+    out += ".5-";
+    out += std::to_string(index % 10000 + 1);
+    out += ".27\" *)\n  ";
+}
+
+bool NetlistGenerator::writeFile(const std::string& path) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+    write(out);
+    return std::fclose(out) == 0;
+}
+
+void NetlistGenerator::write(std::FILE* out) const {
+    const unsigned width = config_.bus_width;
+    const uint64_t n = config_.instances;
+    std::string buf;
+    buf.reserve(2u << 20);
+
+    buf += "/* Generated by bench_parser NetlistGenerator: instances=" + std::to_string(n) +
+           " seed=" + std::to_string(config_.seed) + " */\n\n";
+    buf += "module top(clk, rst, din, dout);\n";
+    buf += "  input clk;\n  input rst;\n";
+    buf += "  input [" + std::to_string(width - 1) + ":0] din;\n";
+    buf += "  output [" + std::to_string(width - 1) + ":0] dout;\n";
+
+    for (uint64_t group = 0; group * width < n; ++group) {
+        if (isBusGroup(group)) {
+            buf += "  wire [" + std::to_string(width - 1) + ":0] bus_" + std::to_string(group) + ";\n";
+        } else {
+            for (uint64_t net = group * width; net < std::min(n, (group + 1) * width); ++net) {
+                buf += "  ";
+                appendAttribute(buf, kBus, net);
+                buf += "wire ";
+                appendNetName(buf, net);
+                buf += ";\n";
+            }
+        }
+        flush(buf, out);
+    }
+
+    for (uint64_t i = 0; i < n; ++i) {
+        const CellMaster& m = kMasters[masterIndex(i)];
+        const bool multiline = uniform(kMultiline, i) < config_.multiline_ratio;
+        const char* sep = multiline ? ",\n    ." : ", .";
+
+        buf += "  ";
+        appendAttribute(buf, kMaster, i);
+        buf += m.name;
+        buf += ' ';
+        appendInstanceName(buf, i);
+        buf += multiline ? " (\n    ." : " (.";
+        for (unsigned p = 0; p < m.num_inputs; ++p) {
+            buf += m.inputs[p];
+            buf += '(';
+            if (m.sequential && p == 0)
+                buf += "clk";
+            else
+                appendDriver(buf, i, p);
+            buf += ')';
+            buf += sep;
+        }
+        buf += m.output;
+        buf += '(';
+        appendNetName(buf, i);
+        buf += ')';
+        if (m.sequential) {
+            buf += sep;
+            buf += "QN()";
+        }
+        buf += multiline ? "\n  );\n" : ");\n";
+        flush(buf, out);
+    }
+
+    // Output port bits are buffered from the last nets in the design.
+    for (unsigned b = 0; b < width; ++b) {
+        buf += "  BUF_X2 _dout" + std::to_string(b) + "_ (\n    .A(";
+        if (n == 0)
+            buf += "din[" + std::to_string(b) + "]";
+        else
+            appendNetName(buf, n - 1 - (b % n));
+        buf += "),\n    .Z(dout[" + std::to_string(b) + "])\n  );\n";
+    }
+    buf += "endmodule\n";
+    flush(buf, out, true);
+}
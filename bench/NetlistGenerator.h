@@ -0,0 +1,44 @@
+// File: bench/NetlistGenerator.h
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+struct NetlistGeneratorConfig {
+    uint64_t instances = 10000;
+    uint64_t seed = 1;
+    double fanout_skew = 2.0;       // 1 = uniform driver choice, larger = heavier-tailed fanout
+    unsigned bus_width = 32;        // width of bus wires and of the din/dout ports
+    double bus_ratio = 0.2;         // fraction of internal nets declared as bus bits
+    double escaped_ratio = 0.1;     // fraction of instance and net names written escaped
+    double multiline_ratio = 0.9;   // fraction of instances in Yosys multi-line layout
+    double attribute_ratio = 0.1;   // fraction of wires and instances with a (* src = ... *) attribute
+};
+
+// Deterministic generator for Yosys-style flat gate-level netlists. Every
+// choice is a pure hash of (seed, index), so the same config always yields
+// the same bytes and nothing is kept in memory per instance or net.
+class NetlistGenerator {
+public:
+    explicit NetlistGenerator(const NetlistGeneratorConfig& config);
+
+    bool writeFile(const std::string& path) const;
+    void write(std::FILE* out) const;
+
+    // Cells the parser should report: generated gates plus output buffers.
+    uint64_t cellCount() const;
+
+private:
+    uint64_t hash(uint64_t salt, uint64_t index) const;
+    double uniform(uint64_t salt, uint64_t index) const;
+
+    uint64_t masterIndex(uint64_t instance) const;
+    bool isBusGroup(uint64_t group) const;
+    void appendNetName(std::string& out, uint64_t net) const;
+    void appendInstanceName(std::string& out, uint64_t instance) const;
+    void appendDriver(std::string& out, uint64_t instance, unsigned pin) const;
+    void appendAttribute(std::string& out, uint64_t salt, uint64_t index) const;
+
+    NetlistGeneratorConfig config_;
+};
@@ -0,0 +1,293 @@
+// File: bench/bench_parser.cpp
+//
+// Parser benchmark suite. Generates deterministic Yosys-style netlists with
+// NetlistGenerator, then times parseFile and parseFileMultithreaded over a
+// range of design sizes and thread counts. Every load runs in a forked child
+// so peak RSS is measured per run. A load that finds a different number of
+// cells than were generated, or a multithreaded load that builds a different
+// database than parseFile, is reported FAILED. Results go to stdout as a
+// table and to a JSON file for regression tracking.
+//
+//   bench_parser [--instances 10000,100000,1000000] [--full]
+//                [--threads 1,2,4,8] [--repeat N] [--seed N]
+//                [--fanout-skew X] [--bus-width N] [--bus-ratio X]
+//                [--escaped-ratio X] [--multiline-ratio X] [--attribute-ratio X]
+//                [--file netlist.v] [--dir /tmp] [--keep] [--out results.json]
+
+#include "NetlistGenerator.h"
+#include "VerilogParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<uint64_t> instances{10000, 100000, 1000000};
+    std::vector<int> threads{1, 2, 4, 8};
+    int repeat = 1;
+    NetlistGeneratorConfig gen;
+    std::string file;
+    std::string dir = "/tmp";
+    std::string out = "bench_parser_results.json";
+    bool keep = false;
+};
+
+struct RunResult {
+    bool ok = false;
+    double seconds = 0.0;
+    uint64_t cells = 0;
+    uint64_t fingerprint = 0;  // databaseFingerprint() of what was loaded
+    long peak_rss_kb = 0;
+};
+
+struct Record {
+    std::string input;
+    uint64_t instances;
+    uint64_t bytes;
+    std::string mode;
+    int threads;
+    RunResult run;
+};
+
+template <class T>
+std::vector<T> parseList(const char* text) {
+    std::vector<T> values;
+    for (const char* p = text; *p;) {
+        char* end = nullptr;
+        values.push_back(static_cast<T>(std::strtod(p, &end)));
+        p = (*end == ',') ? end + 1 : end;
+        if (end == p && *p) break;
+    }
+    return values;
+}
+
+bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (a == "--instances") opt.instances = parseList<uint64_t>(next());
+        else if (a == "--full") opt.instances = {10000, 100000, 1000000, 10000000, 50000000};
+        else if (a == "--threads") opt.threads = parseList<int>(next());
+        else if (a == "--repeat") opt.repeat = std::max(1, std::atoi(next()));
+        else if (a == "--seed") opt.gen.seed = std::strtoull(next(), nullptr, 10);
+        else if (a == "--fanout-skew") opt.gen.fanout_skew = std::atof(next());
+        else if (a == "--bus-width") opt.gen.bus_width = static_cast<unsigned>(std::atoi(next()));
+        else if (a == "--bus-ratio") opt.gen.bus_ratio = std::atof(next());
+        else if (a == "--escaped-ratio") opt.gen.escaped_ratio = std::atof(next());
+        else if (a == "--multiline-ratio") opt.gen.multiline_ratio = std::atof(next());
+        else if (a == "--attribute-ratio") opt.gen.attribute_ratio = std::atof(next());
+        else if (a == "--file") opt.file = next();
+        else if (a == "--dir") opt.dir = next();
+        else if (a == "--out") opt.out = next();
+        else if (a == "--keep") opt.keep = true;
+        else {
+            std::fprintf(stderr, "Unknown option: %s\n", a.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+// FNV-1a over every cell's name and master and every pin's name and net, in
+// ID order; equal databases hash equal.
+uint64_t databaseFingerprint(const NetlistDb& db) {
+    uint64_t h = 14695981039346656037ull;
+    auto add = [&h](std::string_view text) {
+        for (char c : text) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        h = (h ^ 0xff) * 1099511628211ull;  // separator, so "ab","c" differs from "a","bc"
+    };
+    for (NetlistDb::Id cell = 0; cell < db.cellCount(); ++cell) {
+        add(db.cellName(cell));
+        add(db.cellMaster(cell));
+        for (NetlistDb::Id pin = db.pinBegin(cell); pin < db.pinEnd(cell); ++pin) {
+            add(db.pinName(pin));
+            add(db.netName(db.pinNet(pin)));
+        }
+    }
+    return h;
+}
+
+// Loads `path` in a child process and reports time, cell count, database
+// fingerprint and the child's own peak RSS.
+RunResult runInChild(const std::string& path, int threads) {
+    RunResult result;
+    int fds[2];
+    if (pipe(fds) != 0) return result;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) dup2(devnull, STDOUT_FILENO);
+
+        VerilogParser parser;
+        auto start = std::chrono::steady_clock::now();
+        bool ok = threads == 0 ? parser.parseFile(path) : parser.parseFileMultithreaded(path, threads);
+        RunResult child;
+        child.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        child.ok = ok;
+        child.cells = parser.snapshot()->cellCount();
+        child.fingerprint = databaseFingerprint(*parser.snapshot());
+        ssize_t written = write(fds[1], &child, sizeof(child));
+        _exit(written == sizeof(child) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return result;
+    }
+
+    RunResult child;
+    bool got = read(fds[0], &child, sizeof(child)) == sizeof(child);
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == pid && got && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        result = child;
+        result.peak_rss_kb = usage.ru_maxrss;
+    }
+    return result;
+}
+
+// Best of `repeat` runs by wall time.
+RunResult measure(const std::string& path, int threads, int repeat) {
+    RunResult best;
+    for (int r = 0; r < repeat; ++r) {
+        RunResult run = runInChild(path, threads);
+        if (run.ok && (!best.ok || run.seconds < best.seconds)) best = run;
+    }
+    return best;
+}
+
+void printRecord(const Record& r) {
+    const double mb = r.bytes / 1048576.0;
+    if (!r.run.ok) {
+        std::printf("%12llu %-24s %7d  FAILED\n", static_cast<unsigned long long>(r.instances),
+                    r.mode.c_str(), r.threads);
+        return;
+    }
+    std::printf("%12llu %-24s %7d %10.3f %10.1f %12.0f %12ld\n",
+                static_cast<unsigned long long>(r.instances), r.mode.c_str(), r.threads,
+                r.run.seconds, mb / r.run.seconds, r.run.cells / r.run.seconds, r.run.peak_rss_kb);
+    std::fflush(stdout);
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool writeJson(const std::string& path, const Options& opt, const std::vector<Record>& records) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "{\n  \"benchmark\": \"bench_parser\",\n");
+    std::fprintf(f, "  \"generator\": {\"seed\": %llu, \"fanout_skew\": %g, \"bus_width\": %u, "
+                    "\"bus_ratio\": %g, \"escaped_ratio\": %g, \"multiline_ratio\": %g, \"attribute_ratio\": %g},\n",
+                 static_cast<unsigned long long>(opt.gen.seed), opt.gen.fanout_skew, opt.gen.bus_width,
+                 opt.gen.bus_ratio, opt.gen.escaped_ratio, opt.gen.multiline_ratio, opt.gen.attribute_ratio);
+    std::fprintf(f, "  \"runs\": [\n");
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        std::fprintf(f, "    {\"input\": \"%s\", \"instances\": %llu, \"bytes\": %llu, \"mode\": \"%s\", "
+                        "\"threads\": %d, \"ok\": %s, \"seconds\": %.6f, \"cells\": %llu, "
+                        "\"mb_per_s\": %.3f, \"cells_per_s\": %.1f, \"peak_rss_kb\": %ld}%s\n",
+                     jsonEscape(r.input).c_str(), static_cast<unsigned long long>(r.instances),
+                     static_cast<unsigned long long>(r.bytes), r.mode.c_str(), r.threads,
+                     r.run.ok ? "true" : "false", r.run.seconds,
+                     static_cast<unsigned long long>(r.run.cells),
+                     r.run.ok ? r.bytes / 1048576.0 / r.run.seconds : 0.0,
+                     r.run.ok ? r.run.cells / r.run.seconds : 0.0, r.run.peak_rss_kb,
+                     i + 1 < records.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// Fails a run whose cell count differs from `expected_cells`, when known.
+void checkCells(Record& r, uint64_t expected_cells) {
+    if (!r.run.ok || expected_cells == 0 || r.run.cells == expected_cells) return;
+    std::fprintf(stderr, "[ERROR] %s with %d threads loaded %llu cells, expected %llu\n", r.mode.c_str(),
+                 r.threads, static_cast<unsigned long long>(r.run.cells),
+                 static_cast<unsigned long long>(expected_cells));
+    r.run.ok = false;
+}
+
+// `expected_cells` is 0 for a file the generator did not write.
+void benchInput(const std::string& path, uint64_t instances, uint64_t expected_cells, const Options& opt,
+                std::vector<Record>& records) {
+    const uint64_t bytes = fileSize(path);
+    std::printf("# %s (%.1f MB)\n", path.c_str(), bytes / 1048576.0);
+
+    Record single{path, instances, bytes, "parseFile", 1, measure(path, 0, opt.repeat)};
+    checkCells(single, expected_cells);
+    printRecord(single);
+    records.push_back(single);
+
+    for (int t : opt.threads) {
+        Record multi{path, instances, bytes, "parseFileMultithreaded", t, measure(path, t, opt.repeat)};
+        checkCells(multi, expected_cells);
+        if (multi.run.ok && single.run.ok && multi.run.fingerprint != single.run.fingerprint) {
+            std::fprintf(stderr, "[ERROR] %d threads built a different database than parseFile\n", t);
+            multi.run.ok = false;
+        }
+        printRecord(multi);
+        records.push_back(multi);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+
+    std::printf("%12s %-24s %7s %10s %10s %12s %12s\n",
+                "instances", "mode", "threads", "seconds", "MB/s", "cells/s", "peak_rss_kb");
+
+    std::vector<Record> records;
+    if (!opt.file.empty()) {
+        benchInput(opt.file, 0, 0, opt, records);
+    } else {
+        for (uint64_t n : opt.instances) {
+            NetlistGeneratorConfig cfg = opt.gen;
+            cfg.instances = n;
+            const std::string path = opt.dir + "/bench_parser_" + std::to_string(n) + "_" +
+                                     std::to_string(cfg.seed) + ".v";
+            const NetlistGenerator generator(cfg);
+            if (!generator.writeFile(path)) {
+                std::fprintf(stderr, "[ERROR] Failed to write %s\n", path.c_str());
+                return 1;
+            }
+            benchInput(path, n, generator.cellCount(), opt, records);
+            if (!opt.keep) std::remove(path.c_str());
+        }
+    }
+
+    if (!writeJson(opt.out, opt, records)) {
+        std::fprintf(stderr, "[ERROR] Failed to write %s\n", opt.out.c_str());
+        return 1;
+    }
+    std::printf("# results written to %s\n", opt.out.c_str());
+    return 0;
+}
@@ -0,0 +1,123 @@
+// File: bench/bench_scanner.cpp
+//
+// Microbenchmark for the structural scanner. Replicates a netlist in memory
+// (gcd_nangate45.v up to 1 GB by default) and compares the line-oriented
+// getline/find path the parser used to take against every scan kernel the
+// CPU supports, both for raw classification and for full tokenization.
+//
+//   bench_scanner [netlist.v] [size_mb]
+
+#include "NetlistTokenizer.h"
+#include "StructuralScanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifndef BENCH_DEFAULT_NETLIST
+#define BENCH_DEFAULT_NETLIST "gcd_nangate45.v"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char* name, size_t bytes, double seconds, size_t checksum) {
+    std::printf("%-28s %8.3f s  %8.2f GB/s  (checksum %zu)\n",
+                name, seconds, bytes / seconds / 1e9, checksum);
+}
+
+// The old hot loop: split into lines, strip // comments, look for ");".
+size_t legacyLineScan(const std::string& text) {
+    std::istringstream in(text);
+    std::string line;
+    size_t hits = 0;
+    while (std::getline(in, line)) {
+        auto pos = line.find("//");
+        if (pos != std::string::npos) line.resize(pos);
+        if (line.find(");") != std::string::npos) ++hits;
+        hits += std::count(line.begin(), line.end(), '(');
+    }
+    return hits;
+}
+
+size_t kernelScan(const StructuralScanner& scanner, const std::string& text) {
+    StructuralBlock block;
+    size_t count = 0;
+    size_t full = text.size() & ~size_t{63};
+    for (size_t i = 0; i < full; i += 64) {
+        scanner.scanBlock(text.data() + i, block);
+        count += __builtin_popcountll(block.semicolon | block.open_paren | block.close_paren |
+                                      block.dot | block.slash | block.backslash | block.newline);
+    }
+    if (full < text.size()) {
+        scanner.scanPartialBlock(text.data() + full, text.size() - full, block);
+        count += __builtin_popcountll(block.semicolon | block.open_paren | block.close_paren |
+                                      block.dot | block.slash | block.backslash | block.newline);
+    }
+    return count;
+}
+
+size_t kernelTokenize(const StructuralScanner& scanner, const std::string& text) {
+    ParsedChunk chunk;
+    NetlistTokenizer(scanner, chunk).tokenize(text.data(), text.size());
+    return chunk.cells.size() + chunk.pins.size();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : BENCH_DEFAULT_NETLIST;
+    size_t size_mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Failed to open file: " << path << std::endl;
+        return 1;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string unit = ss.str();
+    if (unit.empty()) {
+        std::cerr << "[ERROR] Empty netlist: " << path << std::endl;
+        return 1;
+    }
+
+    std::string text;
+    const size_t target = size_mb << 20;
+    text.reserve(target + unit.size());
+    while (text.size() < target) text += unit;
+
+    std::printf("input: %s x %zu = %.1f MB\n", path, text.size() / unit.size(), text.size() / 1048576.0);
+
+    auto start = Clock::now();
+    size_t checksum = legacyLineScan(text);
+    report("getline+find (legacy)", text.size(), secondsSince(start), checksum);
+
+    for (ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::SSE42, ScanKernel::AVX2}) {
+        if (!StructuralScanner::isSupported(kernel)) {
+            std::printf("%-28s unsupported on this CPU\n", StructuralScanner::kernelName(kernel));
+            continue;
+        }
+        StructuralScanner scanner(kernel);
+        std::string name = std::string("scan/") + StructuralScanner::kernelName(kernel);
+        start = Clock::now();
+        checksum = kernelScan(scanner, text);
+        report(name.c_str(), text.size(), secondsSince(start), checksum);
+
+        name = std::string("tokenize/") + StructuralScanner::kernelName(kernel);
+        start = Clock::now();
+        checksum = kernelTokenize(scanner, text);
+        report(name.c_str(), text.size(), secondsSince(start), checksum);
+    }
+    return 0;
+}
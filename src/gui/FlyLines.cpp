@@ -0,0 +1,106 @@
+// File: src/gui/FlyLines.cpp
+
+#include "FlyLines.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+
+namespace FlyLines {
+
+std::vector<Edge> star(const std::vector<Point>& points) {
+    std::vector<Edge> edges;
+    if (points.size() < 2) return edges;
+    int64_t sx = 0, sy = 0;
+    for (const Point& p : points) {
+        sx += p.x;
+        sy += p.y;
+    }
+    const int64_t n = static_cast<int64_t>(points.size());
+    uint32_t hub = 0;
+    int64_t best = INT64_MAX;
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        const int64_t d = std::llabs(points[i].x * n - sx) + std::llabs(points[i].y * n - sy);
+        if (d < best) {
+            best = d;
+            hub = i;
+        }
+    }
+    edges.reserve(points.size() - 1);
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        if (i != hub) edges.emplace_back(hub, i);
+    }
+    return edges;
+}
+
+namespace {
+
+struct DisjointSets {
+    explicit DisjointSets(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), 0u); }
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    }
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        parent[a] = b;
+        return true;
+    }
+    std::vector<uint32_t> parent;
+};
+
+}  // namespace
+
+std::vector<Edge> spanningTree(const std::vector<Point>& points) {
+    std::vector<Edge> tree;
+    if (points.size() < 2) return tree;
+
+    struct Candidate {
+        int64_t length;
+        uint32_t a, b;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<Point> p(points);
+    std::vector<uint32_t> order(p.size());
+    std::iota(order.begin(), order.end(), 0u);
+
+    // Four reflections of the plane cover all eight octants, since each
+    // candidate edge is found from one of its two ends.
+    for (int k = 0; k < 4; ++k) {
+        std::sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) {
+            return int64_t(p[i].x) + p[i].y < int64_t(p[j].x) + p[j].y;
+        });
+        std::map<int, uint32_t> sweep;  // -y -> point still looking for its neighbour
+        for (uint32_t i : order) {
+            for (auto it = sweep.lower_bound(-p[i].y); it != sweep.end(); it = sweep.erase(it)) {
+                const uint32_t j = it->second;
+                const int64_t dx = int64_t(p[i].x) - p[j].x;
+                const int64_t dy = int64_t(p[i].y) - p[j].y;
+                if (dy > dx) break;
+                candidates.push_back({dx + dy, i, j});
+            }
+            sweep[-p[i].y] = i;
+        }
+        for (Point& q : p) {
+            if (k & 1)
+                q.x = -q.x;
+            else
+                std::swap(q.x, q.y);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.length < b.length; });
+    DisjointSets sets(points.size());
+    tree.reserve(points.size() - 1);
+    for (const Candidate& c : candidates) {
+        if (sets.unite(c.a, c.b)) tree.emplace_back(c.a, c.b);
+        if (tree.size() == points.size() - 1) break;
+    }
+    return tree;
+}
+
+}  // namespace FlyLines
@@ -0,0 +1,27 @@
+// File: src/gui/FlyLines.h
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Which pin pairs of one net get a fly-line. Plain geometry on integer
+// scene coordinates, no Qt.
+namespace FlyLines {
+
+struct Point {
+    int x;
+    int y;
+};
+
+using Edge = std::pair<uint32_t, uint32_t>;  // indices into the point list
+
+// Every pin to the pin nearest the centroid.
+std::vector<Edge> star(const std::vector<Point>& points);
+
+// Rectilinear minimum spanning tree, O(P log P): an octant sweep keeps
+// only each point's nearest neighbour per octant as a candidate, then
+// Kruskal picks the tree from those.
+std::vector<Edge> spanningTree(const std::vector<Point>& points);
+
+}  // namespace FlyLines
@@ -0,0 +1,310 @@
+// File: src/gui/HierarchyClusters.cpp
+
+#include "HierarchyClusters.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+constexpr size_t kGrain = 1 << 16;
+constexpr size_t kNetGrain = 1 << 12;
+// A net touching more nodes than this joins them as a star from one of
+// them instead of pairwise.
+constexpr size_t kMaxClique = 8;
+
+std::string_view parentPrefix(std::string_view name) {
+    const size_t pos = name.find_last_of("./");
+    return pos == std::string_view::npos ? std::string_view() : name.substr(0, pos);
+}
+
+std::string_view prefixOf(std::string_view cell) {
+    if (!cell.empty() && cell.front() == '\\') cell.remove_prefix(1);
+    return parentPrefix(cell);
+}
+
+}  // namespace
+
+void HierarchyClusters::build(const NetlistDb& db) {
+    TraceScope trace("gui", "hierarchy clusters", std::to_string(db.cellCount()) + " cells");
+    ThreadPool& pool = ThreadPool::instance();
+    const size_t cells = db.cellCount();
+    const size_t chunks = (cells + kGrain - 1) / kGrain;
+
+    // Each chunk interns its cells' prefixes locally; the distinct ones are
+    // few and get merged below.
+    std::vector<std::vector<std::string_view>> chunk_prefixes(chunks);
+    std::vector<uint32_t> local(cells);
+    pool.parallelFor(0, cells, kGrain, [&](size_t b, size_t e) {
+        std::vector<std::string_view>& prefixes = chunk_prefixes[b / kGrain];
+        std::unordered_map<std::string_view, uint32_t> ids;
+        for (size_t c = b; c < e; ++c) {
+            const std::string_view prefix = prefixOf(db.cellName(static_cast<NetlistDb::Id>(c)));
+            const auto inserted = ids.emplace(prefix, static_cast<uint32_t>(prefixes.size()));
+            if (inserted.second) prefixes.push_back(prefix);
+            local[c] = inserted.first->second;
+        }
+    });
+
+    // Tree nodes by prefix, with every ancestor; node 0 is the root.
+    std::unordered_map<std::string_view, uint32_t> node_of;
+    std::vector<std::string_view> node_name;
+    std::vector<uint32_t> node_parent;
+    std::vector<uint8_t> node_glue;
+    auto intern = [&](std::string_view prefix) {
+        std::vector<std::string_view> missing;
+        for (std::string_view p = prefix;; p = parentPrefix(p)) {
+            if (node_of.count(p)) break;
+            missing.push_back(p);
+            if (p.empty()) break;
+        }
+        for (auto it = missing.rbegin(); it != missing.rend(); ++it) {
+            node_of.emplace(*it, static_cast<uint32_t>(node_name.size()));
+            node_parent.push_back(it->empty() ? kNone : node_of.at(parentPrefix(*it)));
+            node_name.push_back(*it);
+            node_glue.push_back(0);
+        }
+        return node_of.at(prefix);
+    };
+    intern(std::string_view());
+    std::vector<std::vector<uint32_t>> remap(chunks);
+    for (size_t ch = 0; ch < chunks; ++ch) {
+        for (std::string_view prefix : chunk_prefixes[ch]) remap[ch].push_back(intern(prefix));
+    }
+    std::vector<uint32_t> leaf(cells);
+    pool.parallelFor(0, cells, kGrain, [&](size_t b, size_t e) {
+        const std::vector<uint32_t>& ids = remap[b / kGrain];
+        for (size_t c = b; c < e; ++c) leaf[c] = ids[local[c]];
+    });
+
+    // Cells next to sub-clusters move into a glue child.
+    const uint32_t named = static_cast<uint32_t>(node_name.size());
+    std::vector<uint8_t> has_children(named, 0), has_cells(named, 0);
+    for (uint32_t n = 1; n < named; ++n) has_children[node_parent[n]] = 1;
+    for (uint32_t n : leaf) has_cells[n] = 1;
+    std::vector<uint32_t> glue_of(named, kNone);
+    for (uint32_t n = 0; n < named; ++n) {
+        if (!has_children[n] || !has_cells[n]) continue;
+        glue_of[n] = static_cast<uint32_t>(node_name.size());
+        node_name.push_back(node_name[n]);
+        node_parent.push_back(n);
+        node_glue.push_back(1);
+    }
+    pool.parallelFor(0, cells, kGrain, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) {
+            if (glue_of[leaf[c]] != kNone) leaf[c] = glue_of[leaf[c]];
+        }
+    });
+
+    // Depth-first numbering, glue first, then children by name.
+    const uint32_t nodes = static_cast<uint32_t>(node_name.size());
+    std::vector<std::vector<uint32_t>> children(nodes);
+    for (uint32_t n = 1; n < nodes; ++n) children[node_parent[n]].push_back(n);
+    for (auto& list : children) {
+        std::sort(list.begin(), list.end(), [&](uint32_t a, uint32_t b) {
+            if (node_glue[a] != node_glue[b]) return node_glue[a] > node_glue[b];
+            return node_name[a] < node_name[b];
+        });
+    }
+    std::vector<uint32_t> order;  // DFS position -> node
+    std::vector<uint32_t> id_of(nodes);
+    order.reserve(nodes);
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const uint32_t n = stack.back();
+        stack.pop_back();
+        id_of[n] = static_cast<uint32_t>(order.size());
+        order.push_back(n);
+        for (auto it = children[n].rbegin(); it != children[n].rend(); ++it) stack.push_back(*it);
+    }
+
+    parent_.assign(nodes, kNone);
+    end_.assign(nodes, 0);
+    name_.assign(nodes, std::string());
+    glue_.assign(nodes, 0);
+    for (uint32_t id = 0; id < nodes; ++id) {
+        const uint32_t n = order[id];
+        parent_[id] = n == 0 ? kNone : id_of[node_parent[n]];
+        name_[id] = std::string(node_name[n]);
+        glue_[id] = node_glue[n];
+    }
+    // A subtree ends where the next node that is not below it starts.
+    for (uint32_t id = nodes; id-- > 0;) {
+        uint32_t end = id + 1;
+        while (end < nodes && parent_[end] == id) end = end_[end];
+        end_[id] = end;
+    }
+
+    cluster_of_.resize(cells);
+    pool.parallelFor(0, cells, kGrain, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) cluster_of_[c] = id_of[leaf[c]];
+    });
+    cell_offset_.assign(nodes + 1, 0);
+    for (uint32_t id : cluster_of_) ++cell_offset_[id + 1];
+    for (uint32_t id = 0; id < nodes; ++id) cell_offset_[id + 1] += cell_offset_[id];
+    cells_.resize(cells);
+    std::vector<uint32_t> fill(cell_offset_.begin(), cell_offset_.end() - 1);
+    for (uint32_t c = 0; c < cells; ++c) cells_[fill[cluster_of_[c]]++] = c;
+}
+
+std::string HierarchyClusters::label(uint32_t cluster) const {
+    const std::string& full = name_[cluster];
+    if (glue_[cluster]) return full.empty() ? "top-level cells" : "cells of " + full;
+    if (cluster == kRoot) return "top";
+    const size_t pos = full.find_last_of("./");
+    return pos == std::string::npos ? full : full.substr(pos + 1);
+}
+
+size_t HierarchyClusters::memoryBytes() const {
+    size_t bytes = (parent_.capacity() + end_.capacity() + cell_offset_.capacity()) * sizeof(uint32_t);
+    bytes += (cells_.capacity() + cluster_of_.capacity()) * sizeof(uint32_t) + glue_.capacity();
+    for (const std::string& name : name_) bytes += sizeof(std::string) + name.capacity();
+    return bytes;
+}
+
+ClusterView::ClusterView(std::shared_ptr<const HierarchyClusters> tree, std::shared_ptr<const NetlistDb> db,
+                         size_t max_fanout)
+    : tree_(std::move(tree)), db_(std::move(db)), max_fanout_(max_fanout) {
+    open_.assign(tree_->clusterCount(), 0);
+    rep_.assign(tree_->clusterCount(), HierarchyClusters::kRoot);
+    addNode(HierarchyClusters::kRoot);
+    expand(HierarchyClusters::kRoot);
+}
+
+uint32_t ClusterView::parentOf(uint32_t node) const {
+    return node & kCellFlag ? tree_->clusterOf(node & ~kCellFlag) : tree_->parent(node);
+}
+
+bool ClusterView::expand(uint32_t cluster) {
+    if (cluster >= tree_->clusterCount() || open_[cluster] || rep_[cluster] != cluster) return false;
+    TraceScope trace("gui", "expand cluster", std::to_string(tree_->cellCount(cluster)) + " cells");
+    const std::vector<uint32_t> nets = netsOf(cluster);
+    addEdges(nets, -1);
+    open(cluster);
+    while (!tree_->isLeaf(cluster) && tree_->subtreeEnd(cluster + 1) == tree_->subtreeEnd(cluster)) {
+        ++cluster;  // the only child
+        open(cluster);
+    }
+    addEdges(nets, +1);
+    return true;
+}
+
+bool ClusterView::collapse(uint32_t cluster) {
+    if (cluster >= tree_->clusterCount() || !open_[cluster]) return false;
+    TraceScope trace("gui", "collapse cluster", std::to_string(tree_->cellCount(cluster)) + " cells");
+    const std::vector<uint32_t> nets = netsOf(cluster);
+    addEdges(nets, -1);
+    const uint32_t end = tree_->subtreeEnd(cluster);
+    for (uint32_t d = cluster; d < end; ++d) {
+        if (rep_[d] == d) removeNode(d);
+        if (open_[d] && tree_->isLeaf(d)) {
+            for (uint32_t i = tree_->cellBegin(d); i < tree_->cellEnd(d); ++i) removeNode(tree_->cells()[i] | kCellFlag);
+        }
+    }
+    for (uint32_t d = cluster; d < end; ++d) {
+        open_[d] = 0;
+        rep_[d] = cluster;
+    }
+    addNode(cluster);
+    addEdges(nets, +1);
+    return true;
+}
+
+void ClusterView::open(uint32_t cluster) {
+    removeNode(cluster);
+    open_[cluster] = 1;
+    rep_[cluster] = HierarchyClusters::kNone;
+    if (tree_->isLeaf(cluster)) {
+        for (uint32_t i = tree_->cellBegin(cluster); i < tree_->cellEnd(cluster); ++i)
+            addNode(tree_->cells()[i] | kCellFlag);
+        return;
+    }
+    const uint32_t end = tree_->subtreeEnd(cluster);
+    for (uint32_t child = cluster + 1; child < end; child = tree_->subtreeEnd(child)) {
+        for (uint32_t d = child; d < tree_->subtreeEnd(child); ++d) rep_[d] = child;
+        addNode(child);
+    }
+}
+
+std::vector<uint32_t> ClusterView::netsOf(uint32_t cluster) const {
+    const NetlistDb& db = *db_;
+    std::vector<uint32_t> nets;
+    for (uint32_t i = tree_->cellBegin(cluster); i < tree_->cellEnd(cluster); ++i) {
+        const uint32_t cell = tree_->cells()[i];
+        for (NetlistDb::Id p = db.pinBegin(cell); p < db.pinEnd(cell); ++p) {
+            const NetlistDb::Id net = db.pinNet(p);
+            if (net == NetlistDb::kNone) continue;
+            const size_t pins = db.netPins(net).size();
+            if (pins < 2 || pins > max_fanout_ || db.netName(net).empty()) continue;
+            nets.push_back(net);
+        }
+    }
+    // Most of the design: a flag per net beats sorting.
+    if (nets.size() > db.netCount() / 4) {
+        std::vector<uint8_t> seen(db.netCount(), 0);
+        size_t kept = 0;
+        for (uint32_t net : nets) {
+            if (!seen[net]) {
+                seen[net] = 1;
+                nets[kept++] = net;
+            }
+        }
+        nets.resize(kept);
+    } else {
+        std::sort(nets.begin(), nets.end());
+        nets.erase(std::unique(nets.begin(), nets.end()), nets.end());
+    }
+    return nets;
+}
+
+void ClusterView::addEdges(const std::vector<uint32_t>& nets, int sign) {
+    const NetlistDb& db = *db_;
+    std::vector<std::vector<uint64_t>> parts((nets.size() + kNetGrain - 1) / kNetGrain);
+    ThreadPool::instance().parallelFor(0, nets.size(), kNetGrain, [&](size_t b, size_t e) {
+        std::vector<uint64_t>& out = parts[b / kNetGrain];
+        std::vector<uint32_t> nodes;
+        for (size_t i = b; i < e; ++i) {
+            nodes.clear();
+            for (NetlistDb::Id pin : db.netPins(nets[i])) nodes.push_back(nodeOf(db.pinCell(pin)));
+            std::sort(nodes.begin(), nodes.end());
+            nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+            if (nodes.size() < 2) continue;
+            if (nodes.size() > kMaxClique) {
+                for (size_t k = 1; k < nodes.size(); ++k) out.push_back(edgeKey(nodes[0], nodes[k]));
+                continue;
+            }
+            for (size_t a = 0; a < nodes.size(); ++a) {
+                for (size_t k = a + 1; k < nodes.size(); ++k) out.push_back(edgeKey(nodes[a], nodes[k]));
+            }
+        }
+    });
+    for (const auto& part : parts) {
+        for (uint64_t key : part) {
+            if (sign > 0) {
+                ++edges_[key];
+                continue;
+            }
+            auto it = edges_.find(key);
+            if (it != edges_.end() && --it->second == 0) edges_.erase(it);
+        }
+    }
+}
+
+void ClusterView::addNode(uint32_t node) {
+    node_index_.emplace(node, static_cast<uint32_t>(nodes_.size()));
+    nodes_.push_back(node);
+}
+
+void ClusterView::removeNode(uint32_t node) {
+    auto it = node_index_.find(node);
+    if (it == node_index_.end()) return;
+    const uint32_t index = it->second;
+    node_index_.erase(it);
+    if (index + 1 != nodes_.size()) {
+        nodes_[index] = nodes_.back();
+        node_index_[nodes_[index]] = index;
+    }
+    nodes_.pop_back();
+}
@@ -0,0 +1,118 @@
+// File: src/gui/HierarchyClusters.h
+#pragma once
+
+#include "verilog_parser/NetlistDb.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Instances grouped into a tree of clusters by hierarchical name prefix:
+// "dpath.alu.add_1" is in cluster "dpath.alu", under "dpath", under the
+// root. Both '.' and '/' separate levels; a leading '\' is ignored.
+//
+// A cluster holds either sub-clusters or cells. Cells that sit next to
+// sub-clusters are moved into a "glue" child of their own.
+//
+// Clusters are numbered in depth-first order, so a subtree is a range
+// of clusters. Cells are ordered the same way, so a subtree's cells are
+// a range of cells().
+class HierarchyClusters {
+public:
+    static constexpr uint32_t kRoot = 0;
+    static constexpr uint32_t kNone = ~0u;
+
+    // Builds the tree for `db`, scanning the names in parallel.
+    void build(const NetlistDb& db);
+
+    size_t clusterCount() const { return parent_.size(); }
+    uint32_t parent(uint32_t cluster) const { return parent_[cluster]; }
+    // Subtree of `cluster` is [cluster, subtreeEnd(cluster)). Children
+    // are cluster + 1, subtreeEnd(cluster + 1), ... while below the end.
+    uint32_t subtreeEnd(uint32_t cluster) const { return end_[cluster]; }
+    bool isLeaf(uint32_t cluster) const { return end_[cluster] == cluster + 1; }
+    // Cells of the subtree, as a range of cells().
+    uint32_t cellBegin(uint32_t cluster) const { return cell_offset_[cluster]; }
+    uint32_t cellEnd(uint32_t cluster) const { return cell_offset_[end_[cluster]]; }
+    uint32_t cellCount(uint32_t cluster) const { return cellEnd(cluster) - cellBegin(cluster); }
+    const std::vector<uint32_t>& cells() const { return cells_; }
+    // The leaf cluster of a cell.
+    uint32_t clusterOf(uint32_t cell) const { return cluster_of_[cell]; }
+
+    // Full prefix ("dpath.alu"; empty for the root) and what to show for
+    // it: the last level, or "cells of <parent>" for glue clusters.
+    const std::string& name(uint32_t cluster) const { return name_[cluster]; }
+    std::string label(uint32_t cluster) const;
+
+    size_t memoryBytes() const;
+
+private:
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> end_;
+    std::vector<uint32_t> cell_offset_;  // clusterCount() + 1 entries
+    std::vector<std::string> name_;
+    std::vector<uint8_t> glue_;
+    std::vector<uint32_t> cells_;
+    std::vector<uint32_t> cluster_of_;
+};
+
+// The design as the user has opened it: each closed cluster is one node,
+// and each cell of an open leaf cluster is a node. Edges join nodes that
+// share nets, weighted by how many nets they share.
+//
+// Opening or closing a cluster only revisits the nets of that cluster's
+// cells: their old contributions are taken out and their new ones added.
+// The work is proportional to the block, not to the design.
+class ClusterView {
+public:
+    // Node IDs: a cluster ID, or a cell ID with kCellFlag set.
+    static constexpr uint32_t kCellFlag = 1u << 31;
+
+    // Starts with the root open. Nets with more than `max_fanout` pins,
+    // and the unconnected-pin net, make no edges.
+    ClusterView(std::shared_ptr<const HierarchyClusters> tree, std::shared_ptr<const NetlistDb> db,
+                size_t max_fanout);
+
+    const HierarchyClusters& tree() const { return *tree_; }
+    const std::vector<uint32_t>& nodes() const { return nodes_; }
+    // Weight per edge, keyed by edgeKey(a, b).
+    const std::unordered_map<uint64_t, uint32_t>& edges() const { return edges_; }
+    static uint64_t edgeKey(uint32_t a, uint32_t b) {
+        return a < b ? uint64_t(a) << 32 | b : uint64_t(b) << 32 | a;
+    }
+
+    bool isOpen(uint32_t cluster) const { return open_[cluster] != 0; }
+    // The node a cell is drawn as.
+    uint32_t nodeOf(uint32_t cell) const {
+        const uint32_t rep = rep_[tree_->clusterOf(cell)];
+        return rep == HierarchyClusters::kNone ? cell | kCellFlag : rep;
+    }
+    // The cluster a node sits in, or kNone for the root.
+    uint32_t parentOf(uint32_t node) const;
+
+    // Opens a closed, visible cluster; a lone sub-cluster opens with it.
+    // False if `cluster` is not a closed node.
+    bool expand(uint32_t cluster);
+    // Closes an open cluster and everything under it into one node.
+    bool collapse(uint32_t cluster);
+
+private:
+    std::vector<uint32_t> netsOf(uint32_t cluster) const;
+    void addEdges(const std::vector<uint32_t>& nets, int sign);
+    void addNode(uint32_t node);
+    void removeNode(uint32_t node);
+    void open(uint32_t cluster);
+
+    std::shared_ptr<const HierarchyClusters> tree_;
+    std::shared_ptr<const NetlistDb> db_;
+    size_t max_fanout_;
+    std::vector<uint8_t> open_;
+    // Topmost closed cluster at or above each cluster, kNone if none.
+    std::vector<uint32_t> rep_;
+    std::vector<uint32_t> nodes_;
+    std::unordered_map<uint32_t, uint32_t> node_index_;
+    std::unordered_map<uint64_t, uint32_t> edges_;
+};
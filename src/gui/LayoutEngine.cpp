@@ -0,0 +1,669 @@
+// File: src/gui/LayoutEngine.cpp
+
+#include "LayoutEngine.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr uint32_t kNone = ~0u;
+// Minimum time between intermediate placements handed to the sink.
+constexpr auto kEmitInterval = std::chrono::milliseconds(250);
+// Where the top-left-most cell ends up.
+constexpr float kMargin = 50;
+
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// Deterministic value in [-1, 1) per (index, salt).
+float jitter(uint32_t index, uint32_t salt) {
+    uint64_t x = (uint64_t(index) << 32 | salt) + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<float>(x >> 40) / float(1 << 23) - 1.0f;
+}
+
+// Hands placements to the sink, at most one per kEmitInterval (or per
+// twice what the sink took last time) except the final one. Positions are
+// shifted so the layout starts at (kMargin, kMargin).
+class Emitter {
+public:
+    Emitter(LayoutEngine::Sink& sink, const std::atomic<bool>& cancel) : sink_(sink), cancel_(cancel) {}
+
+    bool due() const { return first_ || Clock::now() - last_ >= std::max<Clock::duration>(kEmitInterval, 2 * cost_); }
+
+    void emit(std::vector<float> x, std::vector<float> y, bool final) {
+        if (cancel_.load(std::memory_order_relaxed)) return;
+        if (!x.empty()) {
+            const float dx = kMargin - *std::min_element(x.begin(), x.end());
+            const float dy = kMargin - *std::min_element(y.begin(), y.end());
+            for (float& v : x) v += dx;
+            for (float& v : y) v += dy;
+        }
+        const Clock::time_point start = Clock::now();
+        sink_(std::move(x), std::move(y), final);
+        first_ = false;
+        last_ = Clock::now();
+        cost_ = last_ - start;
+    }
+
+private:
+    LayoutEngine::Sink& sink_;
+    const std::atomic<bool>& cancel_;
+    Clock::time_point last_;
+    Clock::duration cost_{};
+    bool first_ = true;
+};
+
+// The cell of each net's first output pin, or kNone.
+std::vector<uint32_t> netDrivers(const SchematicLayout& layout, const std::vector<uint8_t>& pin_output) {
+    std::vector<uint32_t> driver(layout.netCount(), kNone);
+    for (size_t n = 0; n < layout.netCount(); ++n) {
+        for (uint32_t i = layout.net_offset[n]; i < layout.net_offset[n + 1]; ++i) {
+            const uint32_t pin = layout.net_pins[i];
+            if (pin < pin_output.size() && pin_output[pin]) {
+                driver[n] = layout.pin_cell[pin];
+                break;
+            }
+        }
+    }
+    return driver;
+}
+
+// One edge from each net's driver to each of its other cells. Nets without
+// a driver use their first cell, unless `driven_only` is set.
+EdgeList netEdges(const SchematicLayout& layout, const std::vector<uint32_t>& drivers, size_t max_fanout,
+                  bool driven_only) {
+    EdgeList edges;
+    std::vector<uint32_t> cells;
+    for (size_t n = 0; n < layout.netCount(); ++n) {
+        const size_t pins = layout.net_offset[n + 1] - layout.net_offset[n];
+        if (pins < 2 || pins > max_fanout) continue;
+        cells.clear();
+        for (uint32_t i = layout.net_offset[n]; i < layout.net_offset[n + 1]; ++i)
+            cells.push_back(layout.pin_cell[layout.net_pins[i]]);
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        uint32_t hub = drivers[n];
+        if (hub == kNone) {
+            if (driven_only) continue;
+            hub = cells[0];
+        }
+        for (uint32_t c : cells) {
+            if (c != hub) edges.emplace_back(hub, c);
+        }
+    }
+    return edges;
+}
+
+// Compressed adjacency of `edges` over nodes [0, n), counting sort by
+// source. Parallel edges stay.
+void adjacency(uint32_t n, const EdgeList& edges, bool reverse, std::vector<uint32_t>& offset,
+               std::vector<uint32_t>& adj) {
+    offset.assign(n + 1, 0);
+    for (const auto& e : edges) ++offset[(reverse ? e.second : e.first) + 1];
+    for (uint32_t i = 0; i < n; ++i) offset[i + 1] += offset[i];
+    adj.resize(edges.size());
+    std::vector<uint32_t> fill(offset.begin(), offset.end() - 1);
+    for (const auto& e : edges) {
+        if (reverse)
+            adj[fill[e.second]++] = e.first;
+        else
+            adj[fill[e.first]++] = e.second;
+    }
+}
+
+// Weighted undirected graph; mass is the number of cells a node stands for.
+struct Graph {
+    std::vector<uint32_t> offset{0};
+    std::vector<uint32_t> adj;
+    std::vector<float> weight;
+    std::vector<float> mass;
+
+    uint32_t size() const { return static_cast<uint32_t>(mass.size()); }
+};
+
+// Both directions of every edge, parallel edges merged into weights.
+Graph cellGraph(uint32_t n, const EdgeList& edges) {
+    EdgeList both;
+    both.reserve(edges.size() * 2);
+    for (const auto& e : edges) {
+        both.push_back(e);
+        both.emplace_back(e.second, e.first);
+    }
+    std::vector<uint32_t> offset, adj;
+    adjacency(n, both, false, offset, adj);
+    ThreadPool::instance().parallelFor(0, n, 1 << 14, [&](size_t b, size_t e) {
+        for (size_t u = b; u < e; ++u) std::sort(adj.begin() + offset[u], adj.begin() + offset[u + 1]);
+    });
+
+    Graph g;
+    g.mass.assign(n, 1.0f);
+    g.offset.reserve(n + 1);
+    for (uint32_t u = 0; u < n; ++u) {
+        for (uint32_t e = offset[u]; e < offset[u + 1]; ++e) {
+            if (e > offset[u] && adj[e] == adj[e - 1]) {
+                g.weight.back() += 1.0f;
+                continue;
+            }
+            g.adj.push_back(adj[e]);
+            g.weight.push_back(1.0f);
+        }
+        g.offset.push_back(static_cast<uint32_t>(g.adj.size()));
+    }
+    return g;
+}
+
+// Heavy-edge matching: each node pairs up with the unmatched neighbour it
+// shares the heaviest edge with relative to their masses. `parent` maps
+// the nodes of `g` to those of the returned graph.
+Graph coarsen(const Graph& g, std::vector<uint32_t>& parent, std::mt19937& rng) {
+    const uint32_t n = g.size();
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    parent.assign(n, kNone);
+    uint32_t m = 0;
+    for (uint32_t u : order) {
+        if (parent[u] != kNone) continue;
+        uint32_t best = kNone;
+        float best_score = 0;
+        for (uint32_t e = g.offset[u]; e < g.offset[u + 1]; ++e) {
+            const uint32_t v = g.adj[e];
+            if (parent[v] != kNone) continue;
+            const float score = g.weight[e] / (g.mass[u] * g.mass[v]);
+            if (score > best_score) {
+                best_score = score;
+                best = v;
+            }
+        }
+        parent[u] = m;
+        if (best != kNone) parent[best] = m;
+        ++m;
+    }
+
+    Graph c;
+    c.mass.assign(m, 0.0f);
+    std::vector<uint32_t> child_offset(m + 1, 0), children(n);
+    for (uint32_t u = 0; u < n; ++u) {
+        c.mass[parent[u]] += g.mass[u];
+        ++child_offset[parent[u] + 1];
+    }
+    for (uint32_t i = 0; i < m; ++i) child_offset[i + 1] += child_offset[i];
+    std::vector<uint32_t> fill(child_offset.begin(), child_offset.end() - 1);
+    for (uint32_t u = 0; u < n; ++u) children[fill[parent[u]]++] = u;
+
+    std::vector<uint32_t> slot(m, kNone);
+    c.offset.reserve(m + 1);
+    for (uint32_t cu = 0; cu < m; ++cu) {
+        const size_t begin = c.adj.size();
+        for (uint32_t k = child_offset[cu]; k < child_offset[cu + 1]; ++k) {
+            const uint32_t u = children[k];
+            for (uint32_t e = g.offset[u]; e < g.offset[u + 1]; ++e) {
+                const uint32_t cv = parent[g.adj[e]];
+                if (cv == cu) continue;
+                if (slot[cv] == kNone) {
+                    slot[cv] = static_cast<uint32_t>(c.adj.size());
+                    c.adj.push_back(cv);
+                    c.weight.push_back(g.weight[e]);
+                } else {
+                    c.weight[slot[cv]] += g.weight[e];
+                }
+            }
+        }
+        for (size_t k = begin; k < c.adj.size(); ++k) slot[c.adj[k]] = kNone;
+        c.offset.push_back(static_cast<uint32_t>(c.adj.size()));
+    }
+    return c;
+}
+
+// Barnes-Hut quadtree over weighted points.
+class QuadTree {
+public:
+    void build(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& mass) {
+        nodes_.clear();
+        if (x.empty()) return;
+        float x0 = x[0], y0 = y[0], x1 = x[0], y1 = y[0];
+        for (size_t i = 1; i < x.size(); ++i) {
+            x0 = std::min(x0, x[i]);
+            y0 = std::min(y0, y[i]);
+            x1 = std::max(x1, x[i]);
+            y1 = std::max(y1, y[i]);
+        }
+        const float size = std::max({x1 - x0, y1 - y0, 1.0f}) * 1.0001f;
+        // Points closer than this share a leaf.
+        const float min_size = size * (1.0f / (1 << 24));
+        nodes_.reserve(2 * x.size());
+        nodes_.push_back({0, 0, 0, x0, y0, size, -1, -1});
+
+        for (uint32_t i = 0; i < x.size(); ++i) {
+            int32_t idx = 0;
+            while (true) {
+                Node& node = nodes_[idx];
+                const float prev_mass = node.mass, prev_sx = node.sx, prev_sy = node.sy;
+                node.mass += mass[i];
+                node.sx += mass[i] * x[i];
+                node.sy += mass[i] * y[i];
+                if (node.child >= 0) {
+                    idx = childOf(idx, x[i], y[i]);
+                    continue;
+                }
+                if (prev_mass == 0) {
+                    node.point = static_cast<int32_t>(i);
+                    break;
+                }
+                if (node.size < min_size) break;  // coincident points share the leaf
+
+                // Split the leaf; what it held moves into one of the children.
+                const int32_t old = node.point;
+                const float half = node.size / 2, nx = node.x0, ny = node.y0;
+                node.point = -1;
+                node.child = static_cast<int32_t>(nodes_.size());
+                for (int q = 0; q < 4; ++q)
+                    nodes_.push_back({0, 0, 0, nx + (q & 1) * half, ny + (q >> 1) * half, half, -1, -1});
+                Node& moved = nodes_[childOf(idx, x[old], y[old])];
+                moved.mass = prev_mass;
+                moved.sx = prev_sx;
+                moved.sy = prev_sy;
+                moved.point = old;
+                idx = childOf(idx, x[i], y[i]);
+            }
+        }
+        for (Node& node : nodes_) {
+            if (node.mass > 0) {
+                node.sx /= node.mass;
+                node.sy /= node.mass;
+            }
+        }
+    }
+
+    // Sum of m_j (p - p_j) / |p - p_j|^2 over the points, with groups that
+    // look smaller than theta from p taken as one body.
+    void repulsion(float px, float py, float theta2, float& fx, float& fy) const {
+        fx = fy = 0;
+        if (nodes_.empty()) return;
+        int32_t stack[256];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes_[stack[--top]];
+            if (node.mass == 0) continue;
+            const float dx = px - node.sx, dy = py - node.sy;
+            const float d2 = dx * dx + dy * dy;
+            if (node.child < 0 || node.size * node.size < theta2 * d2) {
+                if (d2 < 1e-6f) continue;  // the point itself
+                fx += node.mass * dx / d2;
+                fy += node.mass * dy / d2;
+                continue;
+            }
+            for (int q = 0; q < 4; ++q) stack[top++] = node.child + q;
+        }
+    }
+
+    // Centre of mass of all points.
+    float centerX() const { return nodes_.empty() ? 0 : nodes_[0].sx; }
+    float centerY() const { return nodes_.empty() ? 0 : nodes_[0].sy; }
+
+private:
+    struct Node {
+        float sx, sy, mass;  // centre of mass once built
+        float x0, y0, size;
+        int32_t child;  // first of four, or -1 for a leaf
+        int32_t point;
+    };
+
+    int32_t childOf(int32_t idx, float px, float py) const {
+        const Node& node = nodes_[idx];
+        const float half = node.size / 2;
+        return node.child + (px >= node.x0 + half ? 1 : 0) + (py >= node.y0 + half ? 2 : 0);
+    }
+
+    std::vector<Node> nodes_;
+};
+
+// Spring-electrical relaxation with Hu's adaptive step length. A pull
+// toward the centre of mass, growing like a spring's, keeps disconnected
+// parts from drifting off.
+// Calls `tick` after every iteration.
+template <class Tick>
+void relax(const Graph& g, std::vector<float>& x, std::vector<float>& y, float k, int iterations, float step,
+           const std::atomic<bool>& cancel, Tick&& tick) {
+    constexpr float kRepulsion = 0.2f;
+    constexpr float kGravity = 0.1f;
+    constexpr float kTheta2 = 1.0f;
+    constexpr float kCooling = 0.9f;
+    constexpr size_t kGrain = 1 << 12;
+    const uint32_t n = g.size();
+    std::vector<float> nx(n), ny(n);
+    std::vector<double> energy_part((n + kGrain - 1) / kGrain);
+    double last_energy = std::numeric_limits<double>::max();
+    int progress = 0;
+    QuadTree tree;
+
+    for (int it = 0; it < iterations && !cancel.load(std::memory_order_relaxed); ++it) {
+        tree.build(x, y, g.mass);
+        const float cx = tree.centerX(), cy = tree.centerY();
+        ThreadPool::instance().parallelFor(0, n, kGrain, [&](size_t b, size_t e) {
+            double energy = 0;
+            for (size_t i = b; i < e; ++i) {
+                float rx, ry;
+                tree.repulsion(x[i], y[i], kTheta2, rx, ry);
+                const float gx = cx - x[i], gy = cy - y[i];
+                const float gravity = kGravity * g.mass[i] * std::sqrt(gx * gx + gy * gy) / k;
+                float fx = kRepulsion * k * k * g.mass[i] * rx + gravity * gx;
+                float fy = kRepulsion * k * k * g.mass[i] * ry + gravity * gy;
+                for (uint32_t a = g.offset[i]; a < g.offset[i + 1]; ++a) {
+                    const uint32_t j = g.adj[a];
+                    const float dx = x[j] - x[i], dy = y[j] - y[i];
+                    const float pull = g.weight[a] * std::sqrt(dx * dx + dy * dy) / k;
+                    fx += pull * dx;
+                    fy += pull * dy;
+                }
+                const float len = std::sqrt(fx * fx + fy * fy);
+                nx[i] = len > 0 ? x[i] + step * fx / len : x[i];
+                ny[i] = len > 0 ? y[i] + step * fy / len : y[i];
+                energy += double(len) * len;
+            }
+            energy_part[b / kGrain] = energy;
+        });
+        x.swap(nx);
+        y.swap(ny);
+
+        const double energy = std::accumulate(energy_part.begin(), energy_part.end(), 0.0);
+        if (energy < last_energy) {
+            if (++progress >= 5) {
+                progress = 0;
+                step /= kCooling;
+            }
+        } else {
+            progress = 0;
+            step *= kCooling;
+        }
+        last_energy = energy;
+        tick();
+        if (step < k * 1e-3f) break;
+    }
+}
+
+void forceDirected(const SchematicLayout& layout, const std::vector<uint32_t>& drivers,
+                   const LayoutEngine::Options& options, const std::atomic<bool>& cancel, Emitter& emitter) {
+    constexpr float kRowGap = 40;
+    const uint32_t cells = static_cast<uint32_t>(layout.cellCount());
+
+    // Only connected cells take part; the loose ones would just be pushed
+    // out to a ring around the rest, so they are packed below it instead.
+    std::vector<uint32_t> node_of(cells, kNone), loose;
+    uint32_t nodes = 0;
+    std::vector<Graph> graphs;
+    std::vector<std::vector<uint32_t>> parents;  // level l node -> level l + 1 node
+    {
+        TraceScope trace("gui", "layout coarsen");
+        EdgeList edges = netEdges(layout, drivers, options.max_fanout, false);
+        for (const auto& e : edges) node_of[e.first] = node_of[e.second] = 0;
+        for (uint32_t c = 0; c < cells; ++c) {
+            if (node_of[c] == kNone)
+                loose.push_back(c);
+            else
+                node_of[c] = nodes++;
+        }
+        for (auto& e : edges) e = {node_of[e.first], node_of[e.second]};
+        graphs.push_back(cellGraph(nodes, edges));
+        std::mt19937 rng(1);
+        while (graphs.back().size() > 64 && !cancel.load(std::memory_order_relaxed)) {
+            std::vector<uint32_t> parent;
+            Graph coarse = coarsen(graphs.back(), parent, rng);
+            if (coarse.size() > graphs.back().size() * 0.9) break;  // matching has stalled
+            parents.push_back(std::move(parent));
+            graphs.push_back(std::move(coarse));
+        }
+    }
+
+    // Each coarser level spreads its nodes further apart (Hu's sqrt(7/4)).
+    const float level_ratio = std::sqrt(7.0f / 4.0f);
+    const int top = static_cast<int>(graphs.size()) - 1;
+    float k = options.spacing * std::pow(level_ratio, static_cast<float>(top));
+
+    float pitch_x = 0, pitch_y = 0;
+    for (uint32_t c : loose) {
+        pitch_x = std::max(pitch_x, layout.cell_w[c]);
+        pitch_y = std::max(pitch_y, layout.cell_h[c]);
+    }
+    pitch_x += options.spacing / 4;
+    pitch_y += kRowGap;
+
+    // Placement of every cell at `level`: the position of its ancestor
+    // there, spread a little so merged cells do not stack.
+    auto emitLevel = [&](int level, const std::vector<float>& x, const std::vector<float>& y, float level_k,
+                         bool final) {
+        std::vector<float> cx(cells), cy(cells);
+        ThreadPool::instance().parallelFor(0, cells, 1 << 14, [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) {
+                uint32_t node = node_of[c];
+                if (node == kNone) continue;
+                for (int l = 0; l < level; ++l) node = parents[l][node];
+                const float spread = level > 0 ? level_k * 0.25f : 0.0f;
+                cx[c] = x[node] + spread * jitter(static_cast<uint32_t>(c), 1) - layout.cell_w[c] / 2;
+                cy[c] = y[node] + spread * jitter(static_cast<uint32_t>(c), 2) - layout.cell_h[c] / 2;
+            }
+        });
+
+        // Loose cells in rows under the rest, about as wide as it is.
+        float left = 0, right = 0, bottom = 0;
+        if (nodes > 0) {
+            left = std::numeric_limits<float>::max();
+            right = bottom = std::numeric_limits<float>::lowest();
+            for (uint32_t c = 0; c < cells; ++c) {
+                if (node_of[c] == kNone) continue;
+                left = std::min(left, cx[c]);
+                right = std::max(right, cx[c] + layout.cell_w[c]);
+                bottom = std::max(bottom, cy[c] + layout.cell_h[c]);
+            }
+            bottom += options.spacing;
+        }
+        const float width = std::max(right - left, pitch_x * std::ceil(std::sqrt(static_cast<float>(loose.size()))));
+        const size_t per_row = std::max<size_t>(1, static_cast<size_t>(width / pitch_x));
+        for (size_t i = 0; i < loose.size(); ++i) {
+            cx[loose[i]] = left + (i % per_row) * pitch_x;
+            cy[loose[i]] = bottom + (i / per_row) * pitch_y;
+        }
+        emitter.emit(std::move(cx), std::move(cy), final);
+    };
+    if (nodes == 0) {
+        emitLevel(0, {}, {}, k, true);
+        return;
+    }
+
+    std::vector<float> x(graphs[top].size()), y(graphs[top].size());
+    const float side = k * std::sqrt(static_cast<float>(graphs[top].size()));
+    for (uint32_t i = 0; i < x.size(); ++i) {
+        x[i] = side * 0.5f * (jitter(i, 3) + 1);
+        y[i] = side * 0.5f * (jitter(i, 4) + 1);
+    }
+
+    for (int level = top; level >= 0; --level) {
+        const Graph& g = graphs[level];
+        if (level < top) {
+            // Children start where their parent ended up.
+            std::vector<float> fx(g.size()), fy(g.size());
+            for (uint32_t u = 0; u < g.size(); ++u) {
+                const uint32_t p = parents[level][u];
+                fx[u] = x[p] + 0.1f * k * jitter(u, 5 + level);
+                fy[u] = y[p] + 0.1f * k * jitter(u, 6 + level);
+            }
+            x.swap(fx);
+            y.swap(fy);
+        }
+        TraceScope trace("gui", "layout level", std::to_string(g.size()) + " nodes");
+        const int iterations = g.size() <= 1000 ? 300 : g.size() <= 10000 ? 100 : g.size() <= 100000 ? 50 : 20;
+        relax(g, x, y, k, iterations, level == top ? k : k * 0.5f, cancel, [&]() {
+            if (emitter.due()) emitLevel(level, x, y, k, false);
+        });
+        if (cancel.load(std::memory_order_relaxed)) return;
+        if (level > 0) {
+            if (emitter.due()) emitLevel(level, x, y, k, false);
+            k /= level_ratio;
+        }
+    }
+    emitLevel(0, x, y, k, true);
+}
+
+void layered(const SchematicLayout& layout, const std::vector<uint32_t>& drivers,
+             const LayoutEngine::Options& options, const std::atomic<bool>& cancel, Emitter& emitter) {
+    constexpr int kSweeps = 8;
+    constexpr float kRowGap = 40;
+    const uint32_t n = static_cast<uint32_t>(layout.cellCount());
+    const EdgeList edges = netEdges(layout, drivers, options.max_fanout, true);
+    std::vector<uint32_t> out_offset, out_adj, in_offset, in_adj;
+    adjacency(n, edges, false, out_offset, out_adj);
+    adjacency(n, edges, true, in_offset, in_adj);
+
+    // Rank = longest path from the sources (Kahn's algorithm). When only
+    // cycles are left, the lowest-numbered waiting cell is released, which
+    // drops the rest of its incoming (feedback) edges.
+    std::vector<uint32_t> rank(n, 0), indegree(n);
+    for (uint32_t v = 0; v < n; ++v) indegree[v] = in_offset[v + 1] - in_offset[v];
+    std::vector<uint8_t> queued(n, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        if (indegree[v] == 0) {
+            queued[v] = 1;
+            queue.push_back(v);
+        }
+    }
+    uint32_t forced = 0;
+    for (size_t head = 0; head < n; ++head) {
+        if (head == queue.size()) {
+            while (queued[forced]) ++forced;
+            queued[forced] = 1;
+            queue.push_back(forced);
+        }
+        const uint32_t u = queue[head];
+        for (uint32_t e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+            const uint32_t v = out_adj[e];
+            if (queued[v]) continue;
+            rank[v] = std::max(rank[v], rank[u] + 1);
+            if (--indegree[v] == 0) {
+                queued[v] = 1;
+                queue.push_back(v);
+            }
+        }
+    }
+    if (cancel.load(std::memory_order_relaxed)) return;
+
+    const uint32_t ranks = n ? *std::max_element(rank.begin(), rank.end()) + 1 : 0;
+    std::vector<std::vector<uint32_t>> layers(ranks);
+    for (uint32_t v = 0; v < n; ++v) layers[rank[v]].push_back(v);
+    std::vector<float> order(n);  // position within the rank, scaled to [0, 1)
+    auto number = [&](const std::vector<uint32_t>& layer) {
+        for (size_t i = 0; i < layer.size(); ++i) order[layer[i]] = static_cast<float>(i) / layer.size();
+    };
+    for (const auto& layer : layers) number(layer);
+
+    // Ranks become columns, left to right, each centred on the tallest.
+    float column = 0;
+    for (float w : layout.cell_w) column = std::max(column, w);
+    column += options.spacing / 2;
+    auto place = [&](bool final) {
+        std::vector<float> x(n), y(n), height(ranks, 0);
+        for (uint32_t r = 0; r < ranks; ++r) {
+            for (uint32_t v : layers[r]) height[r] += layout.cell_h[v] + kRowGap;
+        }
+        const float tallest = ranks ? *std::max_element(height.begin(), height.end()) : 0;
+        for (uint32_t r = 0; r < ranks; ++r) {
+            float top = (tallest - height[r]) / 2;
+            for (uint32_t v : layers[r]) {
+                x[v] = r * column;
+                y[v] = top;
+                top += layout.cell_h[v] + kRowGap;
+            }
+        }
+        emitter.emit(std::move(x), std::move(y), final);
+    };
+    place(false);
+
+    // Barycenter sweeps, alternately ordering each rank by its fanin and by
+    // its fanout. Cells with no neighbours on that side keep their place.
+    std::vector<float> key(n);
+    for (int sweep = 0; sweep < kSweeps && !cancel.load(std::memory_order_relaxed); ++sweep) {
+        TraceScope trace("gui", "layout sweep");
+        const bool down = sweep % 2 == 0;
+        const std::vector<uint32_t>& offset = down ? in_offset : out_offset;
+        const std::vector<uint32_t>& adj = down ? in_adj : out_adj;
+        for (uint32_t i = 0; i < ranks; ++i) {
+            std::vector<uint32_t>& layer = layers[down ? i : ranks - 1 - i];
+            ThreadPool::instance().parallelFor(0, layer.size(), 1 << 12, [&](size_t b, size_t e) {
+                for (size_t k = b; k < e; ++k) {
+                    const uint32_t v = layer[k];
+                    if (offset[v] == offset[v + 1]) {
+                        key[v] = order[v];
+                        continue;
+                    }
+                    float sum = 0;
+                    for (uint32_t a = offset[v]; a < offset[v + 1]; ++a) sum += order[adj[a]];
+                    key[v] = sum / (offset[v + 1] - offset[v]);
+                }
+            });
+            std::stable_sort(layer.begin(), layer.end(), [&](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+            number(layer);
+        }
+        if (emitter.due()) place(false);
+    }
+    if (!cancel.load(std::memory_order_relaxed)) place(true);
+}
+
+void runLayout(const SchematicLayout& layout, const std::vector<uint8_t>& pin_output,
+               const LayoutEngine::Options& options, const std::atomic<bool>& cancel, LayoutEngine::Sink& sink) {
+    TraceScope trace("gui",
+                     options.mode == LayoutEngine::Mode::Layered ? "layered layout" : "force-directed layout",
+                     std::to_string(layout.cellCount()) + " cells");
+    Emitter emitter(sink, cancel);
+    const std::vector<uint32_t> drivers = netDrivers(layout, pin_output);
+    if (layout.cellCount() == 0)
+        emitter.emit({}, {}, true);
+    else if (options.mode == LayoutEngine::Mode::Layered)
+        layered(layout, drivers, options, cancel, emitter);
+    else
+        forceDirected(layout, drivers, options, cancel, emitter);
+}
+
+}  // namespace
+
+LayoutEngine::~LayoutEngine() {
+    cancel();
+}
+
+void LayoutEngine::cancel() {
+    cancel_.store(true, std::memory_order_relaxed);
+    if (worker_.joinable()) worker_.join();
+    cancel_.store(false, std::memory_order_relaxed);
+    running_.store(false, std::memory_order_release);
+}
+
+void LayoutEngine::run(const SchematicLayout& layout, const std::vector<uint8_t>& pin_output,
+                       const Options& options, Sink sink) {
+    const std::atomic<bool> never{false};
+    runLayout(layout, pin_output, options, never, sink);
+}
+
+void LayoutEngine::start(std::shared_ptr<const SchematicLayout> layout, std::vector<uint8_t> pin_output,
+                         const Options& options, Sink sink) {
+    cancel();
+    running_.store(true, std::memory_order_release);
+    worker_ = std::thread([this, layout = std::move(layout), pin_output = std::move(pin_output), options,
+                           sink = std::move(sink)]() mutable {
+        Tracer::instance().setThreadName("layout");
+        runLayout(*layout, pin_output, options, cancel_, sink);
+        running_.store(false, std::memory_order_release);
+    });
+}
@@ -2,6 +2,8 @@
 
 #include "MainWindow.h"
 #include "CommandLineEdit.h"
+#include "SchematicExport.h"
+#include "util/Tracer.h"
 #include <QDebug>
 #include <QFileDialog>
 #include <QFile>
@@ -10,6 +12,9 @@
 #include <QListWidget>
 #include <QMenuBar>
 #include <QAction>
+#include <QActionGroup>
+#include <QSignalBlocker>
+#include <QInputDialog>
 #include <QDir>
 #include <QFileInfo>
 
@@ -38,6 +43,42 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
 
     setupMenu();
 
+    commands_.setOutput([this](const std::string& msg) {
+        outputConsole_->append(QString::fromStdString(msg));
+    });
+    commands_.setSceneMemory([this]() -> size_t {
+        return visualizerWindow_ ? visualizerWindow_->sceneMemoryBytes() : 0;
+    });
+    commands_.setPathView([this](const VerilogParser::Snapshot& design, const NetlistPath& path) {
+        if (visualizerWindow_ && visualizerWindow_->isVisible())
+            visualizerWindow_->highlightPath(*design, path);
+    });
+    commands_.setConeView([this](const VerilogParser::Snapshot& design, const NetlistCone& cone) {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        visualizerWindow_->showCone(design, cone);
+        visualizerWindow_->show();
+    });
+    commands_.setPlacementView(
+        [this](const VerilogParser::Snapshot& design, std::shared_ptr<const DefPlacement> placement) {
+            if (!visualizerWindow_)
+                visualizerWindow_ = new VisualizerWindow(this);
+            visualizerWindow_->showPlacement(design, std::move(placement));
+            visualizerWindow_->show();
+        });
+    commands_.setSchematicWriter([this](const VerilogParser::Snapshot& design,
+                                        const NetlistCommands::SchematicRequest& request, std::string& message) {
+        // What the visualizer shows, unless another layout was asked for.
+        const SchematicExport::Options options = SchematicExport::optionsOf(request);
+        if (request.layout.empty() && visualizerWindow_ &&
+            visualizerWindow_->writeSchematic(request.file, options, message))
+            return true;
+        if (!message.empty())
+            return false;
+        return SchematicExport::writeDesign(*design, commands_.pinDirections().resolve(*design),
+                                            SchematicExport::placementOf(request), request.file, options, message);
+    });
+
     interp_ = Tcl_CreateInterp();
     setupTcl();
 }
@@ -84,7 +125,7 @@ void MainWindow::setupMenu() {
     QAction* openVisAct = new QAction("Open Visualizer", this);
     connect(openVisAct, &QAction::triggered, this, [this]() {
         if (!visualizerWindow_)
-            visualizerWindow_ = new VisualizerWindow(&parser_, this);
+            visualizerWindow_ = new VisualizerWindow(this);
         visualizerWindow_->show();
     });
     toolsMenu->addAction(openVisAct);
@@ -93,15 +134,95 @@ void MainWindow::setupMenu() {
 QAction* showGraphAct = new QAction("Show Netlist Graph", this);
 connect(showGraphAct, &QAction::triggered, this, [this]() {
     if (!visualizerWindow_)
-        visualizerWindow_ = new VisualizerWindow(&parser_, this);
+        visualizerWindow_ = new VisualizerWindow(this);
 
-    QMap<QString, QStringList> pinsByCell = parser_.getPinsByCell();
-    QMap<QPair<QString, QString>, QString> netByPin = parser_.getNetByPin();
-
-    visualizerWindow_->loadGraph(pinsByCell, netByPin);
+    visualizerWindow_->loadDesign(commands_.parser().snapshot());
     visualizerWindow_->show();
 });
 toolsMenu->addAction(showGraphAct);
+
+    // Fly-line options apply from the next Show Netlist Graph on.
+    auto* flyLineMenu = toolsMenu->addMenu("Fly-lines");
+    auto* styleGroup = new QActionGroup(this);
+    QAction* starAct = flyLineMenu->addAction("Star");
+    QAction* treeAct = flyLineMenu->addAction("Spanning Tree");
+    for (QAction* act : {starAct, treeAct}) {
+        act->setCheckable(true);
+        styleGroup->addAction(act);
+    }
+    treeAct->setChecked(true);
+    connect(styleGroup, &QActionGroup::triggered, this, [this, starAct](QAction* act) {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        visualizerWindow_->setFlyLineStyle(act == starAct ? VisualizerWindow::FlyLineStyle::Star
+                                                          : VisualizerWindow::FlyLineStyle::SpanningTree);
+    });
+    flyLineMenu->addSeparator();
+    QAction* bundleAct = flyLineMenu->addAction("Bundle Threshold...");
+    connect(bundleAct, &QAction::triggered, this, [this]() {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        bool ok = false;
+        int pins = QInputDialog::getInt(this, "Fly-lines", "Draw nets with more pins than this as one bundle:",
+                                        visualizerWindow_->bundleThreshold(), 2, 1000000, 1, &ok);
+        if (ok)
+            visualizerWindow_->setBundleThreshold(pins);
+    });
+
+    // Placement runs in the background; switching redoes the shown design.
+    auto* layoutMenu = toolsMenu->addMenu("Layout");
+    auto* modeGroup = new QActionGroup(this);
+    QAction* layeredAct = layoutMenu->addAction("Layered");
+    QAction* forceAct = layoutMenu->addAction("Force-Directed");
+    for (QAction* act : {layeredAct, forceAct}) {
+        act->setCheckable(true);
+        modeGroup->addAction(act);
+    }
+    forceAct->setChecked(true);
+    connect(modeGroup, &QActionGroup::triggered, this, [this, layeredAct](QAction* act) {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        visualizerWindow_->setLayoutMode(act == layeredAct ? LayoutEngine::Mode::Layered
+                                                           : LayoutEngine::Mode::ForceDirected);
+    });
+    layoutMenu->addSeparator();
+    QAction* clusterAct = layoutMenu->addAction("Cluster by Hierarchy");
+    clusterAct->setCheckable(true);
+    connect(clusterAct, &QAction::toggled, this, [this](bool on) {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        visualizerWindow_->setClustered(on);
+    });
+    // Cells where read_def put them; needs a placement of the loaded design.
+    QAction* physicalAct = layoutMenu->addAction("Physical (DEF Placement)");
+    physicalAct->setCheckable(true);
+    connect(physicalAct, &QAction::toggled, this, [this, physicalAct, clusterAct](bool on) {
+        if (!visualizerWindow_)
+            visualizerWindow_ = new VisualizerWindow(this);
+        const VerilogParser::Snapshot design = commands_.parser().snapshot();
+        std::shared_ptr<const DefPlacement> placement = commands_.placement(design);
+        if (on && !placement) {
+            outputConsole_->append("No placement for the current design; use read_def");
+            const QSignalBlocker blocker(physicalAct);
+            physicalAct->setChecked(false);
+            return;
+        }
+        // The two views exclude each other; the visualizer drops the other.
+        const QSignalBlocker blocker(clusterAct);
+        if (on) {
+            clusterAct->setChecked(false);
+            visualizerWindow_->showPlacement(design, std::move(placement));
+            visualizerWindow_->show();
+        } else {
+            visualizerWindow_->setPhysical(false);
+        }
+    });
+    connect(clusterAct, &QAction::toggled, this, [physicalAct](bool on) {
+        if (on) {
+            const QSignalBlocker blocker(physicalAct);
+            physicalAct->setChecked(false);
+        }
+    });
 }
 
 
@@ -167,6 +288,8 @@ void MainWindow::onCommandEntered() {
         commandHistory_.push_back(pendingCommand_.trimmed());
         historyIndex_ = static_cast<int>(commandHistory_.size());
 
+        const std::string script = pendingCommand_.trimmed().toStdString();
+        TraceScope trace("tcl", "console command", script);
         if (Tcl_Eval(interp_, pendingCommand_.toStdString().c_str()) == TCL_OK) {
             outputConsole_->append(Tcl_GetStringResult(interp_));
         } else {
@@ -182,16 +305,9 @@ void MainWindow::showAutocomplete() {
     QString currentText = inputConsole_->text().trimmed();
     qDebug() << "Autocomplete triggered with:" << currentText;
 
-    static const QMap<QString, QString> commandMap = {
-        {"load_verilog", "<filename>"},
-        {"set_multi_cpu", "<int>"},
-        {"get_ports", ""},
-        {"get_cells", ""},
-        {"get_nets", ""},
-        {"get_pins", "<cell>"},
-        {"get_net_for_pin", "<cell> <pin>"},
-        {"print", "<message>"}
-    };
+    QMap<QString, QString> commandMap;
+    for (const auto& cmd : registry_.commands())
+        commandMap[QString::fromStdString(cmd.name)] = QString::fromStdString(cmd.args);
 
     QStringList matches;
     for (auto it = commandMap.begin(); it != commandMap.end(); ++it) {
@@ -260,133 +376,9 @@ void MainWindow::showAutocomplete() {
 }
 
 void MainWindow::setupTcl() {
-    Tcl_CreateCommand(interp_, "print", tcl_print, this, nullptr);
-    Tcl_CreateCommand(interp_, "get_ports", tcl_get_ports, this, nullptr);
-    Tcl_CreateCommand(interp_, "get_cells", tcl_get_cells, this, nullptr);
-    Tcl_CreateCommand(interp_, "get_nets", tcl_get_nets, this, nullptr);
-    Tcl_CreateCommand(interp_, "get_pins", tcl_get_pins, this, nullptr);
-    Tcl_CreateCommand(interp_, "get_net_for_pin", tcl_get_net_for_pin, this, nullptr);
-    Tcl_CreateCommand(interp_, "load_verilog", tcl_load_verilog, this, nullptr);
-    Tcl_CreateCommand(interp_, "set_multi_cpu", tcl_set_multi_cpu, this, nullptr);
-
-    Tcl_Eval(interp_, R"(
-        rename puts tcl_puts
-        proc puts {args} {
-            eval print $args
-        }
-
-        rename source tcl_source
-        proc source {args} {
-            set echo 0
-            set verbose 0
-            set filename ""
-            foreach arg $args {
-                if {$arg eq "-e"} {
-                    set echo 1
-                } elseif {$arg eq "-v"} {
-                    set verbose 1
-                } else {
-                    set filename $arg
-                }
-            }
-            set fp [open $filename r]
-            set lines [split [read $fp] "\n"]
-            close $fp
-            foreach line $lines {
-                if {$echo} { puts "> $line" }
-                if {[string trim $line] eq ""} { continue }
-                if {[catch {eval $line} result]} {
-                    puts "[TCL ERROR] $result"
-                } elseif {$verbose} {
-                    puts "$result"
-                }
-            }
-        }
-    )");
-}
-
-int MainWindow::tcl_print(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    QString msg;
-    for (int i = 1; i < argc; ++i) {
-        msg += argv[i];
-        if (i < argc - 1)
-            msg += " ";
-    }
-    self->outputConsole_->append(msg);
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(msg.toStdString().c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_get_ports(ClientData clientData, Tcl_Interp* interp, int, const char**) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    QString result;
-    for (const auto& p : self->parser_.get_ports()) result += QString::fromStdString(p) + "\n";
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.toStdString().c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_get_cells(ClientData clientData, Tcl_Interp* interp, int, const char**) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    QString result;
-    for (const auto& c : self->parser_.get_cells()) result += QString::fromStdString(c) + "\n";
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.toStdString().c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_get_nets(ClientData clientData, Tcl_Interp* interp, int, const char**) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    QString result;
-    for (const auto& n : self->parser_.get_nets()) result += QString::fromStdString(n) + "\n";
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.toStdString().c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_get_pins(ClientData clientData, Tcl_Interp* interp, int argc, const char** argv) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    if (argc < 2) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: get_pins <cell>", -1));
-        return TCL_ERROR;
-    }
-    QString result;
-    for (const auto& pin : self->parser_.get_pins(argv[1]))
-        result += QString::fromStdString(pin) + "\n";
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.toStdString().c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_get_net_for_pin(ClientData clientData, Tcl_Interp* interp, int argc, const char** argv) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    if (argc < 3) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: get_net_for_pin <cell> <pin>", -1));
-        return TCL_ERROR;
-    }
-    std::string result = self->parser_.get_net_for_pin(argv[1], argv[2]);
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.c_str(), -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_load_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    if (argc < 2) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: load_verilog -file <filename>", -1));
-        return TCL_ERROR;
-    }
-    bool ok = self->parser_.parseFileMultithreaded(argv[1], self->thread_count_);
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(ok ? "OK" : "FAILED", -1));
-    return TCL_OK;
-}
-
-int MainWindow::tcl_set_multi_cpu(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
-    auto* self = static_cast<MainWindow*>(clientData);
-    if (argc < 2) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: set_multi_cpu <int>", -1));
-        return TCL_ERROR;
-    }
-    self->thread_count_ = std::max(1, std::atoi(argv[1]));
-    QString msg = QString("Multi-core parsing set to ") + QString::number(self->thread_count_);
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(msg.toStdString().c_str(), -1));
-    return TCL_OK;
+    commands_.registerCommands(registry_);
+    registry_.install(interp_);
+    NetlistCommands::setupShell(interp_);
 }
 
 bool MainWindow::eventFilter(QObject* obj, QEvent* event) {
@@ -11,7 +11,8 @@
 #include <QMap>
 #include <QDir>
 #include "CommandLineEdit.h"
-#include "verilog_parser/VerilogParser.h"
+#include "tcl/CommandRegistry.h"
+#include "tcl/NetlistCommands.h"
 #include "VisualizerWindow.h"
 #include <tcl.h>
 
@@ -46,22 +47,11 @@ private:
     int historyIndex_ = 0;
     QString pendingCommand_;
     Tcl_Interp* interp_ = nullptr;
-    VerilogParser parser_;
-    int thread_count_ = 4;
+    NetlistCommands commands_;
+    CommandRegistry registry_;
    // VisualizerWindow* visualizer_ = nullptr;
     VisualizerWindow* visualizerWindow_ = nullptr;
 
-    // TCL command callbacks
-    static int tcl_print(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_get_ports(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_get_cells(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_get_nets(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_load_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_set_multi_cpu(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-
-    // New TCL commands
-    static int tcl_get_pins(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
-    static int tcl_get_net_for_pin(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
 };
 
 #endif  // MAINWINDOW_H
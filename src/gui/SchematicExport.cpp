@@ -0,0 +1,258 @@
+// File: src/gui/SchematicExport.cpp
+
+#include "SchematicExport.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+#ifdef VERILOG_WITH_SVG
+#include <QSvgGenerator>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Tile side when the picture is stitched into one file.
+constexpr int kRenderTile = 1024;
+// Largest stitched PNG; bigger pictures need tile files.
+constexpr qint64 kMaxPixels = qint64(1) << 28;
+// Heatmap bins are drawn at least this many pixels across.
+constexpr qreal kMinBinPixels = 4;
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+// Everything of `layout` that reaches into `area`, as one region item
+// or, zoomed far out, heatmap blocks from the density pyramid.
+void drawArea(QPainter& painter, const SchematicLayout& layout, const SchematicRegionItem::LabelSource& labels,
+              const QRectF& area, qreal lod) {
+    SchematicRegionItem item;
+    item.setLabelSource(labels);
+    if (SchematicRegionItem::detailFor(lod) == SchematicRegionItem::Detail::Heatmap) {
+        if (layout.density.empty())
+            return;
+        int k = std::max(0, qCeil(std::log2(kMinBinPixels / (SchematicLayout::kDensityBin * lod))));
+        k = std::clamp(k, layout.density_first, static_cast<int>(layout.density.size()) - 1);
+        const SchematicLayout::DensityLevel& density = layout.density[k];
+        const qreal bin = SchematicLayout::kDensityBin * std::exp2(k);
+        const qreal block = bin * SchematicRegionItem::kBins;
+        for (qreal by = std::floor(area.top() / block) * block; by < area.bottom(); by += block) {
+            for (qreal bx = std::floor(area.left() / block) * block; bx < area.right(); bx += block) {
+                const qint64 col0 = std::llround(bx / bin);
+                const qint64 row0 = std::llround(by / bin);
+                SchematicRegionItem::Bins bins;
+                for (int y = 0; y < SchematicRegionItem::kBins; ++y) {
+                    for (int x = 0; x < SchematicRegionItem::kBins; ++x)
+                        bins[y * SchematicRegionItem::kBins + x] = density.at(col0 + x, row0 + y);
+                }
+                item.begin(QRectF(bx, by, block, block), QString());
+                item.setHeatmap(bins, density.max);
+                item.finalize();
+                item.render(&painter, lod, area);
+            }
+        }
+        return;
+    }
+
+    // Tiles are clipped, so whatever straddles two is simply drawn twice.
+    // The margin takes in labels and pins that stick out of their cells.
+    const float margin = SchematicLayout::kLabelHeight;
+    const SchematicLayout::Box box{
+        static_cast<float>(area.left()) - margin, static_cast<float>(area.top()) - margin,
+        static_cast<float>(area.right()) + margin, static_cast<float>(area.bottom()) + margin};
+    item.begin(area, QString());
+    layout.cell_index.query(box, [&](uint32_t c) {
+        item.addCell(c, QRectF(layout.cell_x[c], layout.cell_y[c], layout.cell_w[c], layout.cell_h[c]));
+        for (uint32_t p = layout.pin_offset[c]; p < layout.pin_offset[c + 1]; ++p)
+            item.addPin(QRectF(layout.pin_x[p], layout.pin_y[p], SchematicLayout::kPinSize, SchematicLayout::kPinSize));
+    });
+    layout.wire_index.query(box, [&](uint32_t w) {
+        item.addWire(QLineF(layout.wire_x0[w], layout.wire_y0[w], layout.wire_x1[w], layout.wire_y1[w]),
+                     layout.wire_bundle[w] != 0, layout.netWeight(layout.wire_net[w]));
+    });
+    item.finalize();
+    item.render(&painter, lod, area);
+}
+
+}  // namespace
+
+namespace SchematicExport {
+
+Options optionsOf(const NetlistCommands::SchematicRequest& request) {
+    Options options;
+    options.format = request.format == "svg" ? Format::Svg : Format::Png;
+    options.size = request.size;
+    options.tile = request.tile;
+    return options;
+}
+
+Placement placementOf(const NetlistCommands::SchematicRequest& request) {
+    if (request.layout == "grid")
+        return Placement::Grid;
+    return request.layout == "force" ? Placement::ForceDirected : Placement::Layered;
+}
+
+void ensureApplication() {
+    if (QCoreApplication::instance())
+        return;
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    static int argc = 1;
+    static char name[] = "verilog";
+    static char* argv[] = {name, nullptr};
+    static QGuiApplication app(argc, argv);
+}
+
+bool write(const SchematicLayout& layout, const SchematicRegionItem::LabelSource& labels, const std::string& file,
+           const Options& options, std::string& message) {
+    TraceScope trace("gui", "write schematic", file);
+    if (layout.cellCount() == 0) {
+        message = "Nothing to draw";
+        return false;
+    }
+#ifndef VERILOG_WITH_SVG
+    if (options.format == Format::Svg) {
+        message = "SVG output needs a build with the Qt SVG module";
+        return false;
+    }
+#endif
+    const auto start = std::chrono::steady_clock::now();
+
+    const SchematicLayout::Box all = layout.bounds();
+    const QRectF scene = QRectF(all.x0, all.y0, all.x1 - all.x0, all.y1 - all.y0).adjusted(-50, -50, 50, 50);
+    const qreal scale = std::max(1, options.size) / std::max(scene.width(), scene.height());
+    const QSize picture(std::max(1, qCeil(scene.width() * scale)), std::max(1, qCeil(scene.height() * scale)));
+    const bool split = options.tile > 0;
+    const bool stitch = !split && options.format == Format::Png;
+    if (stitch && qint64(picture.width()) * picture.height() > kMaxPixels) {
+        message = "A " + std::to_string(picture.width()) + "x" + std::to_string(picture.height()) +
+                  " picture is too large for one file; use -tile";
+        return false;
+    }
+    const int side = split ? options.tile : kRenderTile;
+    const int cols = (picture.width() + side - 1) / side;
+    const int rows = (picture.height() + side - 1) / side;
+
+    const QFileInfo info(QString::fromStdString(file));
+    auto tileFile = [&](int row, int col) {
+        return info.path() + "/" + info.completeBaseName() + QString("_r%1_c%2.").arg(row).arg(col) + info.suffix();
+    };
+    // Paints the picture pixels in `pixels` onto a device that starts there.
+    auto paint = [&](QPainter& painter, const QRect& pixels) {
+        const QRectF area(scene.left() + pixels.left() / scale, scene.top() + pixels.top() / scale,
+                          pixels.width() / scale, pixels.height() / scale);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.scale(scale, scale);
+        painter.translate(-area.topLeft());
+        painter.setClipRect(area);
+        painter.fillRect(area, Qt::white);
+        drawArea(painter, layout, labels, area, scale);
+    };
+
+    std::atomic<int> failed{0};
+#ifdef VERILOG_WITH_SVG
+    auto writeSvg = [&](const QString& name, const QRect& pixels) {
+        QSvgGenerator svg;
+        svg.setFileName(name);
+        svg.setSize(pixels.size());
+        svg.setViewBox(QRect(QPoint(), pixels.size()));
+        QPainter painter;
+        if (!painter.begin(&svg)) {
+            ++failed;
+            return;
+        }
+        paint(painter, pixels);
+    };
+    // Vector output gains nothing from tiles when it is one file.
+    if (options.format == Format::Svg && !split)
+        writeSvg(info.filePath(), QRect(QPoint(), picture));
+#endif
+
+    QImage whole;
+    uchar* bits = nullptr;
+    int bytesPerLine = 0;
+    if (stitch) {
+        whole = QImage(picture, QImage::Format_ARGB32_Premultiplied);
+        // Detached once here; the workers only write disjoint pixels.
+        bits = whole.bits();
+        bytesPerLine = whole.bytesPerLine();
+    }
+    if (stitch || split) {
+        ThreadPool::instance().parallelFor(0, size_t(rows) * cols, 1, [&](size_t b, size_t e) {
+            for (size_t t = b; t < e; ++t) {
+                const int row = static_cast<int>(t / cols), col = static_cast<int>(t % cols);
+                const QRect pixels = QRect(col * side, row * side, side, side) & QRect(QPoint(), picture);
+#ifdef VERILOG_WITH_SVG
+                if (options.format == Format::Svg) {
+                    writeSvg(tileFile(row, col), pixels);
+                    continue;
+                }
+#endif
+                QImage image(pixels.size(), QImage::Format_ARGB32_Premultiplied);
+                {
+                    QPainter painter(&image);
+                    paint(painter, pixels);
+                }
+                if (split) {
+                    if (!image.save(tileFile(row, col), "PNG"))
+                        ++failed;
+                    continue;
+                }
+                for (int y = 0; y < pixels.height(); ++y) {
+                    uchar* line = bits + qint64(pixels.top() + y) * bytesPerLine + pixels.left() * 4;
+                    std::memcpy(line, image.constScanLine(y), pixels.width() * 4);
+                }
+            }
+        });
+    }
+    if (stitch && !whole.save(info.filePath(), "PNG"))
+        ++failed;
+    if (failed > 0) {
+        message = "Cannot write " + file;
+        return false;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "[INFO] Wrote %s: %dx%d pixels, %d tile%s, %zu instances in %.3f s",
+                  file.c_str(), picture.width(), picture.height(), rows * cols, rows * cols == 1 ? "" : "s",
+                  layout.cellCount(), seconds);
+    if (split)
+        std::snprintf(buf + std::strlen(buf), sizeof(buf) - std::strlen(buf), " (%s ...)",
+                      tileFile(0, 0).toStdString().c_str());
+    message = buf;
+    return true;
+}
+
+bool writeDesign(const NetlistDb& db, const PinDirections::Table& directions, Placement placement,
+                 const std::string& file, const Options& options, std::string& message) {
+    SchematicLayout layout = SchematicLayout::gridOf(db);
+    layout.joinNets(false, 64);
+    if (placement != Placement::Grid) {
+        LayoutEngine::Options engine;
+        engine.mode = placement == Placement::Layered ? LayoutEngine::Mode::Layered : LayoutEngine::Mode::ForceDirected;
+        std::vector<float> x, y;
+        LayoutEngine::run(layout, SchematicLayout::outputPins(db, directions), engine,
+                          [&](std::vector<float> nx, std::vector<float> ny, bool) {
+                              x = std::move(nx);
+                              y = std::move(ny);
+                          });
+        layout.place(x, y);
+        layout.joinNets(false, 64);  // fly-lines for where the pins ended up
+    }
+    layout.buildIndex();
+    return write(layout, [&db](quint32 cell) { return toQString(db.cellName(cell)); }, file, options, message);
+}
+
+}  // namespace SchematicExport
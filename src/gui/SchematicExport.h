@@ -0,0 +1,48 @@
+// File: src/gui/SchematicExport.h
+#pragma once
+
+#include "LayoutEngine.h"
+#include "SchematicLayout.h"
+#include "SchematicRegionItem.h"
+#include "tcl/NetlistCommands.h"
+#include "verilog_parser/NetlistDb.h"
+#include "verilog_parser/PinDirections.h"
+
+#include <string>
+
+// Draws a laid-out schematic into PNG or SVG files without a window, the
+// way the visualizer draws it at the same scale. The picture is cut into
+// square tiles painted in parallel on the shared thread pool, each with
+// its own painter and image. Without a tile size the tiles are stitched
+// into one file; with one, each tile goes to a file of its own named
+// <name>_r<row>_c<col>.<ext>.
+namespace SchematicExport {
+
+enum class Format { Png, Svg };
+enum class Placement { Grid, Layered, ForceDirected };
+
+struct Options {
+    Format format = Format::Png;
+    int size = 4096;  // pixels along the longer side of the whole picture
+    int tile = 0;     // pixels per side of each tile file; 0 writes one file
+};
+
+// What a write_schematic request asks for. Placement is layered unless
+// the request names grid or force.
+Options optionsOf(const NetlistCommands::SchematicRequest& request);
+Placement placementOf(const NetlistCommands::SchematicRequest& request);
+
+// Starts a QGuiApplication on the offscreen platform unless one is
+// running; fonts need one. Call on the main thread.
+void ensureApplication();
+
+// `labels` names the layout's cells and is called from worker threads.
+// Returns what was written, or why nothing was, in `message`.
+bool write(const SchematicLayout& layout, const SchematicRegionItem::LabelSource& labels, const std::string& file,
+           const Options& options, std::string& message);
+
+// Lays the whole of `db` out first, on the calling thread.
+bool writeDesign(const NetlistDb& db, const PinDirections::Table& directions, Placement placement,
+                 const std::string& file, const Options& options, std::string& message);
+
+}  // namespace SchematicExport
@@ -0,0 +1,372 @@
+// File: src/gui/SchematicLayout.cpp
+
+#include "SchematicLayout.h"
+#include "FlyLines.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace {
+
+// Largest base density grid, in bins.
+constexpr int64_t kMaxDensityBins = int64_t(1) << 22;
+
+int64_t binOf(float v, double size) {
+    return static_cast<int64_t>(std::floor(v / size));
+}
+
+// Scene units per placement row.
+constexpr float kPhysicalRow = 100;
+
+// The nets of `db` under its IDs, the unconnected-pin net without pins.
+void addNets(SchematicLayout& layout, const NetlistDb& db) {
+    for (NetlistDb::Id n = 0; n < db.netCount(); ++n) {
+        const auto pins = db.netPins(n);
+        if (db.netName(n).empty())
+            layout.addNet(nullptr, 0);
+        else
+            layout.addNet(pins.data(), pins.size());
+    }
+}
+
+}  // namespace
+
+void SchematicLayout::reserve(size_t cells, size_t pins) {
+    for (auto* v : {&cell_x, &cell_y, &cell_w, &cell_h}) v->reserve(cells);
+    pin_offset.reserve(cells + 1);
+    for (auto* v : {&pin_x, &pin_y, &pin_dx, &pin_dy}) v->reserve(pins);
+    pin_cell.reserve(pins);
+    pin_net.reserve(pins);
+}
+
+uint32_t SchematicLayout::addCell(float x, float y, float w, float h) {
+    cell_x.push_back(x);
+    cell_y.push_back(y);
+    cell_w.push_back(w);
+    cell_h.push_back(h);
+    pin_offset.push_back(pin_offset.back());
+    return static_cast<uint32_t>(cell_x.size() - 1);
+}
+
+uint32_t SchematicLayout::addPin(float x, float y) {
+    pin_x.push_back(x);
+    pin_y.push_back(y);
+    pin_dx.push_back(x - cell_x.back());
+    pin_dy.push_back(y - cell_y.back());
+    pin_cell.push_back(static_cast<uint32_t>(cell_x.size() - 1));
+    pin_net.push_back(kNoNet);
+    ++pin_offset.back();
+    return static_cast<uint32_t>(pin_x.size() - 1);
+}
+
+uint32_t SchematicLayout::addNet(const uint32_t* pins, size_t count) {
+    const uint32_t net = static_cast<uint32_t>(netCount());
+    for (size_t i = 0; i < count; ++i) pin_net[pins[i]] = net;
+    net_pins.insert(net_pins.end(), pins, pins + count);
+    net_offset.push_back(static_cast<uint32_t>(net_pins.size()));
+    return net;
+}
+
+SchematicLayout SchematicLayout::gridOf(const NetlistDb& db) {
+    const float cellSpacing = 150;
+    const float pinSpacing = 20;
+
+    NetlistDb::Id maxPins = 0;
+    for (NetlistDb::Id c = 0; c < db.cellCount(); ++c) maxPins = std::max(maxPins, db.pinEnd(c) - db.pinBegin(c));
+    const float rowPitch = 30 + pinSpacing * maxPins + 2 * kLabelHeight;
+    const size_t columns = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(double(db.cellCount())))));
+
+    SchematicLayout layout;
+    layout.reserve(db.cellCount(), db.pinCount());
+    for (NetlistDb::Id c = 0; c < db.cellCount(); ++c) {
+        const float x = 50 + (c % columns) * cellSpacing;
+        const float y = 50 + (c / columns) * rowPitch;
+        const NetlistDb::Id pins = db.pinEnd(c) - db.pinBegin(c);
+        layout.addCell(x, y, 100, 30 + pinSpacing * pins);
+        for (NetlistDb::Id i = 0; i < pins; ++i) layout.addPin(x + 10, y + 10 + pinSpacing * i);
+    }
+    addNets(layout, db);
+    return layout;
+}
+
+SchematicLayout SchematicLayout::physicalOf(const NetlistDb& db, const DefPlacement& placement) {
+    TraceScope trace("gui", "physical layout", std::to_string(placement.placedCount()) + " placed");
+    const DefPlacement::Rect& die = placement.dieArea();
+    double pitch = static_cast<double>(placement.rowPitch());
+    if (pitch <= 0 && placement.placedCount() > 0)
+        pitch = std::sqrt(double(die.x1 - die.x0) * double(die.y1 - die.y0) / placement.placedCount());
+    const double scale = kPhysicalRow / std::max(pitch, 1.0);
+
+    // Without cell sizes a cell reaches to its right-hand neighbour.
+    std::vector<float> width(db.cellCount(), kPhysicalRow);
+    {
+        struct Spot {
+            int32_t y, x;
+            NetlistDb::Id cell;
+            bool operator<(const Spot& o) const { return y != o.y ? y < o.y : x < o.x; }
+        };
+        std::vector<Spot> spots;
+        spots.reserve(placement.placedCount());
+        for (NetlistDb::Id c = 0; c < db.cellCount(); ++c) {
+            if (placement.placed(c)) spots.push_back({placement.y(c), placement.x(c), c});
+        }
+        std::sort(spots.begin(), spots.end());
+        for (size_t i = 0; i + 1 < spots.size(); ++i) {
+            if (spots[i + 1].y == spots[i].y && spots[i + 1].x > spots[i].x)
+                width[spots[i].cell] = std::min(float((spots[i + 1].x - spots[i].x) * scale), 4 * kPhysicalRow);
+        }
+    }
+
+    const float height = 0.8f * kPhysicalRow;
+    const float top = static_cast<float>((die.y1 - die.y0) * scale) + 2 * kPhysicalRow;
+    const size_t unplaced = db.cellCount() - placement.placedCount();
+    const size_t columns = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(double(unplaced)))));
+    size_t waiting = 0;
+
+    SchematicLayout layout;
+    layout.reserve(db.cellCount(), db.pinCount());
+    for (NetlistDb::Id c = 0; c < db.cellCount(); ++c) {
+        float x, y, w;
+        if (placement.placed(c)) {
+            x = static_cast<float>((placement.x(c) - die.x0) * scale);
+            y = static_cast<float>((die.y1 - placement.y(c)) * scale) - kPhysicalRow + 0.1f * kPhysicalRow;
+            w = std::max(0.9f * width[c], 2 * kPinSize);
+        } else {
+            x = (waiting % columns) * 1.5f * kPhysicalRow;
+            y = top + (waiting / columns) * 1.5f * kPhysicalRow;
+            w = kPhysicalRow;
+            ++waiting;
+        }
+        layout.addCell(x, y, w, height);
+        // The pins in a column down the left edge.
+        const NetlistDb::Id pins = db.pinEnd(c) - db.pinBegin(c);
+        const float step = pins > 1 ? (height - 4 - kPinSize) / (pins - 1) : 0;
+        for (NetlistDb::Id i = 0; i < pins; ++i)
+            layout.addPin(x + 2, pins > 1 ? y + 2 + step * i : y + (height - kPinSize) / 2);
+    }
+    addNets(layout, db);
+    return layout;
+}
+
+std::vector<uint8_t> SchematicLayout::outputPins(const NetlistDb& db, const PinDirections::Table& directions) {
+    std::vector<uint8_t> output(db.pinCount());
+    ThreadPool::instance().parallelFor(0, db.pinCount(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t p = b; p < e; ++p)
+            output[p] = directions.of(db, static_cast<NetlistDb::Id>(p)) == PortDirection::Output ? 1 : 0;
+    });
+    return output;
+}
+
+void SchematicLayout::joinNets(bool star, size_t bundle_threshold) {
+    TraceScope trace("gui", "join nets", std::to_string(netCount()) + " nets");
+    const size_t nets = netCount();
+    auto wiresOf = [&](size_t n) -> uint32_t {
+        const size_t pins = net_offset[n + 1] - net_offset[n];
+        if (pins < 2) return 0;
+        return pins > bundle_threshold ? 1 : static_cast<uint32_t>(pins - 1);
+    };
+    if (net_wire_offset.size() != nets + 1 || net_wire_offset.back() != wireCount()) {
+        net_wire_offset.assign(nets + 1, 0);
+        for (size_t n = 0; n < nets; ++n) net_wire_offset[n + 1] = net_wire_offset[n] + wiresOf(n);
+        const size_t wires = net_wire_offset[nets];
+        wire_pin0.assign(wires, 0);
+        wire_pin1.assign(wires, 0);
+        wire_net.resize(wires);
+        wire_bundle.assign(wires, 0);
+        wire_x0.resize(wires);
+        wire_y0.resize(wires);
+        wire_x1.resize(wires);
+        wire_y1.resize(wires);
+    }
+
+    // Nets are independent; each writes only its own wire slots.
+    ThreadPool::instance().parallelFor(0, nets, 1 << 12, [&](size_t b, size_t e) {
+        std::vector<FlyLines::Point> points;
+        for (size_t n = b; n < e; ++n) {
+            const uint32_t first = net_wire_offset[n];
+            const uint32_t count = net_wire_offset[n + 1] - first;
+            if (count == 0) continue;
+            const uint32_t* pins = net_pins.data() + net_offset[n];
+            const size_t pin_count = net_offset[n + 1] - net_offset[n];
+            for (uint32_t w = first; w < first + count; ++w) wire_net[w] = static_cast<uint32_t>(n);
+            if (pin_count > bundle_threshold) {
+                wire_bundle[first] = 1;
+                continue;
+            }
+            points.clear();
+            for (size_t i = 0; i < pin_count; ++i) {
+                points.push_back({static_cast<int>(std::lround(pinCenterX(pins[i]))),
+                                  static_cast<int>(std::lround(pinCenterY(pins[i])))});
+            }
+            const std::vector<FlyLines::Edge> edges = star ? FlyLines::star(points) : FlyLines::spanningTree(points);
+            for (size_t i = 0; i < edges.size() && i < count; ++i) {
+                wire_pin0[first + i] = pins[edges[i].first];
+                wire_pin1[first + i] = pins[edges[i].second];
+            }
+        }
+    });
+    updateWires();
+}
+
+void SchematicLayout::place(const std::vector<float>& x, const std::vector<float>& y) {
+    cell_x = x;
+    cell_y = y;
+    ThreadPool::instance().parallelFor(0, pinCount(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t p = b; p < e; ++p) {
+            pin_x[p] = cell_x[pin_cell[p]] + pin_dx[p];
+            pin_y[p] = cell_y[pin_cell[p]] + pin_dy[p];
+        }
+    });
+    updateWires();
+}
+
+void SchematicLayout::updateWires() {
+    ThreadPool::instance().parallelFor(0, wireCount(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t w = b; w < e; ++w) {
+            if (!wire_bundle[w]) {
+                wire_x0[w] = pinCenterX(wire_pin0[w]);
+                wire_y0[w] = pinCenterY(wire_pin0[w]);
+                wire_x1[w] = pinCenterX(wire_pin1[w]);
+                wire_y1[w] = pinCenterY(wire_pin1[w]);
+                continue;
+            }
+            // One trunk across the pins' span at their mean height.
+            const uint32_t net = wire_net[w];
+            float left = std::numeric_limits<float>::max(), right = std::numeric_limits<float>::lowest();
+            double sum_y = 0;
+            for (uint32_t i = net_offset[net]; i < net_offset[net + 1]; ++i) {
+                left = std::min(left, pinCenterX(net_pins[i]));
+                right = std::max(right, pinCenterX(net_pins[i]));
+                sum_y += pinCenterY(net_pins[i]);
+            }
+            const float y = static_cast<float>(sum_y / (net_offset[net + 1] - net_offset[net]));
+            wire_x0[w] = left;
+            wire_y0[w] = y;
+            wire_x1[w] = right;
+            wire_y1[w] = y;
+        }
+    });
+}
+
+SchematicLayout::Box SchematicLayout::cellBox(uint32_t cell) const {
+    return {cell_x[cell], cell_y[cell] - kLabelHeight, cell_x[cell] + cell_w[cell], cell_y[cell] + cell_h[cell]};
+}
+
+void SchematicLayout::buildIndex() {
+    TraceScope trace("gui", "layout index", std::to_string(cellCount()) + " cells");
+    ThreadPool& pool = ThreadPool::instance();
+
+    std::vector<Box> boxes(cellCount());
+    pool.parallelFor(0, boxes.size(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t c = b; c < e; ++c) boxes[c] = cellBox(static_cast<uint32_t>(c));
+    });
+    cell_index.build(boxes);
+
+    boxes.resize(wireCount());
+    pool.parallelFor(0, boxes.size(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t w = b; w < e; ++w) {
+            boxes[w] = {std::min(wire_x0[w], wire_x1[w]), std::min(wire_y0[w], wire_y1[w]),
+                        std::max(wire_x0[w], wire_x1[w]), std::max(wire_y0[w], wire_y1[w])};
+        }
+    });
+    wire_index.build(boxes);
+
+    density.clear();
+    density_first = 0;
+    if (cellCount() == 0) return;
+
+    // The finest level whose grid fits, then halve until one bin is left.
+    const Box all = bounds();
+    auto levelFor = [&](int k) {
+        const double size = double(kDensityBin) * double(int64_t(1) << k);
+        DensityLevel level;
+        level.col0 = binOf(all.x0, size);
+        level.row0 = binOf(all.y0, size);
+        level.cols = binOf(all.x1, size) - level.col0 + 1;
+        level.rows = binOf(all.y1, size) - level.row0 + 1;
+        return level;
+    };
+    while (true) {
+        const DensityLevel probe = levelFor(density_first);
+        if (probe.cols * probe.rows <= kMaxDensityBins) break;
+        ++density_first;
+    }
+    density.resize(density_first);
+
+    DensityLevel base = levelFor(density_first);
+    const double size = double(kDensityBin) * double(int64_t(1) << density_first);
+    std::unique_ptr<std::atomic<uint32_t>[]> counts(new std::atomic<uint32_t>[base.cols * base.rows]());
+    pool.parallelFor(0, pinCount(), 1 << 16, [&](size_t b, size_t e) {
+        for (size_t p = b; p < e; ++p) {
+            const int64_t col = binOf(pinCenterX(static_cast<uint32_t>(p)), size) - base.col0;
+            const int64_t row = binOf(pinCenterY(static_cast<uint32_t>(p)), size) - base.row0;
+            counts[row * base.cols + col].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    base.bins.resize(base.cols * base.rows);
+    for (size_t i = 0; i < base.bins.size(); ++i) {
+        base.bins[i] = counts[i].load(std::memory_order_relaxed);
+        base.max = std::max(base.max, base.bins[i]);
+    }
+    density.push_back(std::move(base));
+
+    // Bin indices are aligned to absolute multiples of the bin size, so a
+    // parent is the child index shifted right (rounding toward -inf). Bins
+    // -1 and 0 never share a parent, so a grid straddling the origin stops
+    // shrinking at two bins.
+    while (density.back().cols > 1 || density.back().rows > 1) {
+        const DensityLevel& child = density.back();
+        DensityLevel parent;
+        parent.col0 = child.col0 >> 1;
+        parent.row0 = child.row0 >> 1;
+        parent.cols = ((child.col0 + child.cols - 1) >> 1) - parent.col0 + 1;
+        parent.rows = ((child.row0 + child.rows - 1) >> 1) - parent.row0 + 1;
+        if (parent.cols == child.cols && parent.rows == child.rows) break;
+        parent.bins.assign(parent.cols * parent.rows, 0);
+        for (int64_t r = 0; r < child.rows; ++r) {
+            const int64_t pr = ((child.row0 + r) >> 1) - parent.row0;
+            for (int64_t c = 0; c < child.cols; ++c) {
+                const int64_t pc = ((child.col0 + c) >> 1) - parent.col0;
+                parent.bins[pr * parent.cols + pc] += child.bins[r * child.cols + c];
+            }
+        }
+        for (uint32_t v : parent.bins) parent.max = std::max(parent.max, v);
+        density.push_back(std::move(parent));
+    }
+}
+
+SchematicLayout::Box SchematicLayout::bounds() const {
+    Box all = cell_index.bounds();
+    if (!wire_index.empty()) {
+        const Box& wires = wire_index.bounds();
+        all.x0 = std::min(all.x0, wires.x0);
+        all.y0 = std::min(all.y0, wires.y0);
+        all.x1 = std::max(all.x1, wires.x1);
+        all.y1 = std::max(all.y1, wires.y1);
+    }
+    return all;
+}
+
+void SchematicLayout::clear() {
+    *this = SchematicLayout();
+}
+
+size_t SchematicLayout::memoryBytes() const {
+    size_t bytes = (cell_x.capacity() + cell_y.capacity() + cell_w.capacity() + cell_h.capacity()) * sizeof(float);
+    bytes += (pin_offset.capacity() + pin_cell.capacity()) * sizeof(uint32_t);
+    bytes += (pin_x.capacity() + pin_y.capacity() + pin_dx.capacity() + pin_dy.capacity()) * sizeof(float);
+    bytes += (net_offset.capacity() + net_pins.capacity() + net_wire_offset.capacity() + pin_net.capacity() +
+              net_weight.capacity()) *
+             sizeof(uint32_t);
+    bytes += (wire_pin0.capacity() + wire_pin1.capacity() + wire_net.capacity()) * sizeof(uint32_t);
+    bytes += (wire_x0.capacity() + wire_y0.capacity() + wire_x1.capacity() + wire_y1.capacity()) * sizeof(float);
+    bytes += wire_bundle.capacity();
+    bytes += cell_index.memoryBytes() + wire_index.memoryBytes();
+    for (const DensityLevel& level : density) bytes += level.bins.capacity() * sizeof(uint32_t);
+    return bytes;
+}
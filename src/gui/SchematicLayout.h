@@ -0,0 +1,121 @@
+// File: src/gui/SchematicLayout.h
+#pragma once
+
+#include "util/RTree.h"
+#include "verilog_parser/DefPlacement.h"
+#include "verilog_parser/NetlistDb.h"
+#include "verilog_parser/PinDirections.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Geometry of a whole schematic as flat coordinate arrays, independent of
+// Qt. The visualizer creates scene items only for the part on screen and
+// finds it through the R-trees; zoomed far out it draws from the pin
+// density pyramid instead of the geometry.
+struct SchematicLayout {
+    using Box = RTree::Box;
+
+    static constexpr float kPinSize = 10;
+    static constexpr float kLabelHeight = 20;
+    // Base density bin side; the visualizer's region side is 8 of these.
+    static constexpr float kDensityBin = 256;
+    static constexpr uint32_t kNoNet = ~0u;
+
+    // Cell c is the box (cell_x, cell_y, cell_w, cell_h) with pins
+    // [pin_offset[c], pin_offset[c + 1]); a pin is a kPinSize square at
+    // (pin_x, pin_y), which is (pin_dx, pin_dy) into its cell.
+    std::vector<float> cell_x, cell_y, cell_w, cell_h;
+    std::vector<uint32_t> pin_offset{0};
+    std::vector<float> pin_x, pin_y;
+    std::vector<float> pin_dx, pin_dy;
+    std::vector<uint32_t> pin_cell;
+
+    // Net n joins pins [net_offset[n], net_offset[n + 1]) of net_pins and
+    // is drawn by wires [net_wire_offset[n], net_wire_offset[n + 1]).
+    // pin_net maps back, kNoNet for unconnected pins. net_weight is how
+    // many nets a net stands for in an abstract view; empty means one each.
+    std::vector<uint32_t> net_offset{0};
+    std::vector<uint32_t> net_pins;
+    std::vector<uint32_t> net_wire_offset{0};
+    std::vector<uint32_t> pin_net;
+    std::vector<uint32_t> net_weight;
+
+    // Fly-line segments from wire_pin0 to wire_pin1. A bundle is one trunk
+    // standing in for every pin of a high-fanout net; it has no pins.
+    std::vector<uint32_t> wire_pin0, wire_pin1, wire_net;
+    std::vector<float> wire_x0, wire_y0, wire_x1, wire_y1;
+    std::vector<uint8_t> wire_bundle;
+
+    // Cell boxes including their label, and wire extents.
+    RTree cell_index;
+    RTree wire_index;
+
+    // Pin counts per bin; bins at level k are kDensityBin << k wide and
+    // aligned to multiples of that size. Levels below density_first are
+    // left empty when their grid would be too large.
+    struct DensityLevel {
+        int64_t col0 = 0, row0 = 0;
+        int64_t cols = 0, rows = 0;
+        std::vector<uint32_t> bins;
+        uint32_t max = 0;
+
+        uint32_t at(int64_t col, int64_t row) const {
+            col -= col0;
+            row -= row0;
+            return col < 0 || row < 0 || col >= cols || row >= rows ? 0 : bins[row * cols + col];
+        }
+    };
+    std::vector<DensityLevel> density;
+    int density_first = 0;
+
+    size_t cellCount() const { return cell_x.size(); }
+    size_t pinCount() const { return pin_x.size(); }
+    size_t netCount() const { return net_offset.size() - 1; }
+    size_t wireCount() const { return wire_x0.size(); }
+    uint32_t netWeight(uint32_t net) const { return net_weight.empty() ? 1 : net_weight[net]; }
+
+    void reserve(size_t cells, size_t pins);
+    // Appends a cell; its pins are added with addPin() right after.
+    uint32_t addCell(float x, float y, float w, float h);
+    uint32_t addPin(float x, float y);
+    uint32_t addNet(const uint32_t* pins, size_t count);
+
+    // Every cell of `db` on a square grid with its pins and nets, under the
+    // database's IDs; the placement the layout engine starts from. The
+    // unconnected-pin net is added without pins.
+    static SchematicLayout gridOf(const NetlistDb& db);
+    // The same, with each cell where `placement` puts it: y up, one row
+    // pitch to 100 units, as wide as the gap to the next cell in its row.
+    // Unplaced cells wait on a grid below the die.
+    static SchematicLayout physicalOf(const NetlistDb& db, const DefPlacement& placement);
+    // 1 for each output pin of `db`, which drives its net in the layered
+    // mode.
+    static std::vector<uint8_t> outputPins(const NetlistDb& db, const PinDirections::Table& directions);
+
+    // (Re)computes the fly-lines of every net for the current placement:
+    // a star or a rectilinear spanning tree, or a bundle trunk for nets
+    // with more than `bundle_threshold` pins. A net keeps its number of
+    // wires, so wire IDs stay valid across calls with the same settings.
+    void joinNets(bool star, size_t bundle_threshold);
+    // Moves every cell to the given top-left corners; pins and wires
+    // follow, with the wire topology unchanged.
+    void place(const std::vector<float>& x, const std::vector<float>& y);
+
+    Box cellBox(uint32_t cell) const;  // with label room
+    float pinCenterX(uint32_t pin) const { return pin_x[pin] + kPinSize / 2; }
+    float pinCenterY(uint32_t pin) const { return pin_y[pin] + kPinSize / 2; }
+
+    // Builds both R-trees and the density pyramid; call once all geometry
+    // is in.
+    void buildIndex();
+    // Union of everything; undefined when there are no cells.
+    Box bounds() const;
+
+    void clear();
+    size_t memoryBytes() const;
+
+private:
+    void updateWires();
+};
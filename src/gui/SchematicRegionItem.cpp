@@ -0,0 +1,261 @@
+// File: src/gui/SchematicRegionItem.cpp
+
+#include "SchematicRegionItem.h"
+
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Tiles larger than this on either side are painted directly instead.
+constexpr int kMaxTileSide = 2048;
+// Room above a cell box for its label.
+constexpr qreal kLabelHeight = 20;
+
+qreal heavyWidth(int weightClass) {
+    return 3 + 2 * weightClass;
+}
+
+}  // namespace
+
+SchematicRegionItem::SchematicRegionItem() {
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void SchematicRegionItem::reset() {
+    hide();
+    cells_.clear();
+    pins_.clear();
+    wires_.clear();
+    bundles_.clear();
+    for (QVector<QLineF>& lines : heavy_)
+        lines.clear();
+    for (QPainterPath& path : heavyPaths_)
+        path = QPainterPath();
+    highlightPins_.clear();
+    highlightWires_.clear();
+    cellPath_ = QPainterPath();
+    pinPath_ = QPainterPath();
+    wirePath_ = QPainterPath();
+    bundlePath_ = QPainterPath();
+    heatmap_ = false;
+}
+
+void SchematicRegionItem::begin(const QRectF& tile, const QString& cacheKey) {
+    reset();
+    tile_ = tile;
+    cacheKey_ = cacheKey;
+}
+
+void SchematicRegionItem::addCell(quint32 id, const QRectF& box) {
+    cells_.append({box, id, QString()});
+}
+
+void SchematicRegionItem::addPin(const QRectF& box) {
+    pins_.append(box);
+}
+
+void SchematicRegionItem::addWire(const QLineF& wire, bool bundle, uint32_t weight) {
+    if (bundle || weight < 2) {
+        (bundle ? bundles_ : wires_).append(wire);
+        return;
+    }
+    int weightClass = 0;
+    while (weightClass + 1 < kWeightClasses && weight >= (4u << weightClass))
+        ++weightClass;
+    heavy_[weightClass].append(wire);
+}
+
+void SchematicRegionItem::setHeatmap(const Bins& bins, uint32_t scale) {
+    density_ = bins;
+    heatmapScale_ = std::max<uint32_t>(1, scale);
+    heatmap_ = true;
+}
+
+void SchematicRegionItem::finalize() {
+    prepareGeometryChange();
+    if (heatmap_) {
+        bounds_ = tile_;
+        show();
+        return;
+    }
+
+    QRectF bounds;
+    for (const Cell& cell : cells_) {
+        cellPath_.addRect(cell.box);
+        bounds |= cell.box.adjusted(0, -kLabelHeight, 0, 0);
+    }
+    for (const QRectF& pin : pins_)
+        pinPath_.addRect(pin);
+    for (const QLineF& wire : wires_) {
+        wirePath_.moveTo(wire.p1());
+        wirePath_.lineTo(wire.p2());
+    }
+    for (const QLineF& bundle : bundles_) {
+        bundlePath_.moveTo(bundle.p1());
+        bundlePath_.lineTo(bundle.p2());
+    }
+    bounds |= wirePath_.boundingRect();
+    bounds |= bundlePath_.boundingRect();
+    qreal pen = 4;  // bundles
+    for (int k = 0; k < kWeightClasses; ++k) {
+        for (const QLineF& wire : heavy_[k]) {
+            heavyPaths_[k].moveTo(wire.p1());
+            heavyPaths_[k].lineTo(wire.p2());
+        }
+        if (!heavy_[k].isEmpty()) {
+            bounds |= heavyPaths_[k].boundingRect();
+            pen = std::max(pen, heavyWidth(k));
+        }
+    }
+    bounds_ = bounds.adjusted(-pen / 2, -pen / 2, pen / 2, pen / 2);  // widest pen
+    show();
+}
+
+void SchematicRegionItem::setDimmed(bool dimmed) {
+    if (dimmed_ == dimmed)
+        return;
+    dimmed_ = dimmed;
+    update();
+}
+
+void SchematicRegionItem::setHighlight(const QVector<QRectF>& pins, const QVector<QLineF>& wires) {
+    if (pins.isEmpty() && wires.isEmpty() && highlightPins_.isEmpty() && highlightWires_.isEmpty())
+        return;
+    highlightPins_ = pins;
+    highlightWires_ = wires;
+    update();
+}
+
+size_t SchematicRegionItem::memoryBytes() const {
+    auto pathBytes = [](const QPainterPath& path) { return path.elementCount() * sizeof(QPainterPath::Element); };
+    size_t bytes = sizeof(*this) + cacheKey_.size() * sizeof(QChar);
+    for (const Cell& cell : cells_)
+        bytes += sizeof(Cell) + cell.name.size() * sizeof(QChar);
+    bytes += (pins_.size() + highlightPins_.size()) * sizeof(QRectF);
+    bytes += (wires_.size() + bundles_.size() + highlightWires_.size()) * sizeof(QLineF);
+    bytes += pathBytes(cellPath_) + pathBytes(pinPath_) + pathBytes(wirePath_) + pathBytes(bundlePath_);
+    for (int k = 0; k < kWeightClasses; ++k)
+        bytes += heavy_[k].size() * sizeof(QLineF) + pathBytes(heavyPaths_[k]);
+    return bytes;
+}
+
+SchematicRegionItem::Detail SchematicRegionItem::detailFor(qreal lod) {
+    if (lod < kBoxesLod)
+        return Detail::Heatmap;
+    return lod < kPinsLod ? Detail::Boxes : Detail::Pins;
+}
+
+void SchematicRegionItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const Detail detail = heatmap_ ? Detail::Heatmap : std::max(Detail::Boxes, detailFor(lod));
+    if (detail == Detail::Pins)
+        paintLevel(painter, detail, option->exposedRect);
+    else
+        paintTile(painter, detail, lod);
+    paintHighlight(painter);
+}
+
+void SchematicRegionItem::render(QPainter* painter, qreal lod, const QRectF& exposed) const {
+    paintLevel(painter, heatmap_ ? Detail::Heatmap : std::max(Detail::Boxes, detailFor(lod)), exposed);
+    paintHighlight(painter);
+}
+
+void SchematicRegionItem::paintTile(QPainter* painter, Detail detail, qreal lod) {
+    // One tile per zoom octave, rendered at the octave's upper scale so it
+    // is only ever drawn shrunk.
+    const qreal scale = std::exp2(std::ceil(std::log2(lod)));
+    const QSize size(qCeil(bounds_.width() * scale), qCeil(bounds_.height() * scale));
+    if (size.isEmpty() || size.width() > kMaxTileSide || size.height() > kMaxTileSide) {
+        paintLevel(painter, detail, bounds_);
+        return;
+    }
+
+    const QString key = QStringLiteral("%1:%2:%3:%4")
+                            .arg(cacheKey_)
+                            .arg(static_cast<int>(detail))
+                            .arg(scale)
+                            .arg(dimmed_ ? 1 : 0);
+    QPixmap tile;
+    if (!QPixmapCache::find(key, &tile)) {
+        tile = QPixmap(size);
+        tile.fill(Qt::transparent);
+        QPainter tilePainter(&tile);
+        tilePainter.setRenderHint(QPainter::Antialiasing, painter->testRenderHint(QPainter::Antialiasing));
+        tilePainter.scale(scale, scale);
+        tilePainter.translate(-bounds_.topLeft());
+        paintLevel(&tilePainter, detail, bounds_);
+        tilePainter.end();
+        QPixmapCache::insert(key, tile);
+    }
+    painter->drawPixmap(bounds_, tile, QRectF(tile.rect()));
+}
+
+void SchematicRegionItem::paintLevel(QPainter* painter, Detail detail, const QRectF& exposed) const {
+    if (detail == Detail::Heatmap) {
+        const qreal w = tile_.width() / kBins;
+        const qreal h = tile_.height() / kBins;
+        painter->setPen(Qt::NoPen);
+        for (int by = 0; by < kBins; ++by) {
+            for (int bx = 0; bx < kBins; ++bx) {
+                const uint32_t pins = density_[by * kBins + bx];
+                if (!pins)
+                    continue;
+                // Blue for sparse through red for the densest bins.
+                const qreal t = std::min(1.0, static_cast<qreal>(pins) / heatmapScale_);
+                painter->setBrush(QColor::fromHsvF((1.0 - t) * 0.66, 1.0, 1.0, 0.35 + 0.65 * t));
+                painter->drawRect(QRectF(tile_.left() + bx * w, tile_.top() + by * h, w, h));
+            }
+        }
+        return;
+    }
+
+    painter->setPen(QPen(Qt::black));
+    painter->setBrush(QBrush(Qt::lightGray));
+    painter->drawPath(cellPath_);
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(dimmed_ ? QPen(Qt::gray, 1) : QPen(Qt::red, 2));
+    painter->drawPath(wirePath_);
+    painter->setPen(QPen(dimmed_ ? Qt::gray : Qt::darkRed, 4, Qt::DashLine));
+    painter->drawPath(bundlePath_);
+    for (int k = 0; k < kWeightClasses; ++k) {
+        if (heavy_[k].isEmpty())
+            continue;
+        painter->setPen(QPen(dimmed_ ? Qt::gray : Qt::red, dimmed_ ? heavyWidth(k) / 2 : heavyWidth(k)));
+        painter->drawPath(heavyPaths_[k]);
+    }
+    if (detail == Detail::Boxes)
+        return;
+
+    painter->setPen(QPen(Qt::blue));
+    painter->setBrush(QBrush(Qt::blue));
+    painter->drawPath(pinPath_);
+    // Text is the expensive part; only label what is exposed.
+    painter->setPen(QPen(Qt::black));
+    for (const Cell& cell : cells_) {
+        const QRectF label(cell.box.left(), cell.box.top() - kLabelHeight, cell.box.width(), kLabelHeight);
+        if (!label.intersects(exposed))
+            continue;
+        if (cell.name.isNull() && labels_)
+            cell.name = labels_(cell.id);
+        painter->drawText(label.adjusted(5, 0, 0, 0), Qt::AlignLeft | Qt::AlignVCenter, cell.name);
+    }
+}
+
+void SchematicRegionItem::paintHighlight(QPainter* painter) const {
+    if (!highlightWires_.isEmpty()) {
+        painter->setPen(QPen(Qt::green, 3));
+        painter->drawLines(highlightWires_);
+    }
+    if (!highlightPins_.isEmpty()) {
+        painter->setPen(QPen(Qt::green));
+        painter->setBrush(QBrush(Qt::green));
+        painter->drawRects(highlightPins_);
+    }
+}
@@ -0,0 +1,112 @@
+// File: src/gui/SchematicRegionItem.h
+#pragma once
+
+#include <QGraphicsItem>
+#include <QLineF>
+#include <QPainterPath>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+// One square tile of the schematic in a single scene item. Items are
+// pooled by the visualizer and refilled as tiles scroll into view. A tile
+// either holds the cells, pins and fly-lines whose anchor lies in it,
+// painted in batches from cached QPainterPaths, or, zoomed far out, a pin
+// density heatmap. Detail tiles pick what to paint by zoom:
+//
+//   middle    cell boxes and fly-lines
+//   close in  pins and cell labels
+//
+// Heatmaps and box views are rendered once per zoom octave into pixmap
+// tiles kept in QPixmapCache, so panning and zooming blit instead of
+// repaint.
+class SchematicRegionItem : public QGraphicsItem {
+public:
+    enum { Type = UserType + 1 };
+    enum class Detail { Heatmap, Boxes, Pins };
+    static constexpr int kBins = 8;
+    using Bins = std::array<uint32_t, kBins * kBins>;
+
+    // View scale (screen pixels per scene unit) where each level starts.
+    static constexpr qreal kBoxesLod = 0.08;
+    static constexpr qreal kPinsLod = 0.6;
+
+    // Names cells by ID. Labels are only made for cells actually drawn
+    // with their label, and kept until the item is refilled.
+    using LabelSource = std::function<QString(quint32 cell)>;
+
+    SchematicRegionItem();
+
+    void setLabelSource(LabelSource source) { labels_ = std::move(source); }
+
+    // Empties and hides the item so it can go back to the pool.
+    void reset();
+    // Starts filling the item for `tile`. Pixmap tiles are cached under
+    // `cacheKey`, which must name the tile's content.
+    void begin(const QRectF& tile, const QString& cacheKey);
+    void addCell(quint32 id, const QRectF& box);
+    void addPin(const QRectF& box);
+    // Wires standing for several nets (`weight` > 1) are drawn wider.
+    void addWire(const QLineF& wire, bool bundle, uint32_t weight = 1);
+    // Makes this a heatmap tile of row-major pin counts; `scale` is the
+    // count drawn fully saturated.
+    void setHeatmap(const Bins& bins, uint32_t scale);
+    // Builds the paths and bounds and shows the item.
+    void finalize();
+
+    // Highlighted pins and wires are drawn on top at every level; dimmed
+    // tiles draw their wires gray.
+    void setDimmed(bool dimmed);
+    void setHighlight(const QVector<QRectF>& pins, const QVector<QLineF>& wires);
+
+    int cellCount() const { return cells_.size(); }
+    size_t memoryBytes() const;
+
+    static Detail detailFor(qreal lod);
+    // Paints the item at the detail for `lod`, bypassing the pixmap cache,
+    // with labels only where they meet `exposed`. Safe from any thread for
+    // an item in no scene, one thread per item.
+    void render(QPainter* painter, qreal lod, const QRectF& exposed) const;
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override { return bounds_; }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+    struct Cell {
+        QRectF box;
+        quint32 id;
+        mutable QString name;  // made on first draw
+    };
+
+    void paintLevel(QPainter* painter, Detail detail, const QRectF& exposed) const;
+    void paintTile(QPainter* painter, Detail detail, qreal lod);
+    void paintHighlight(QPainter* painter) const;
+
+    LabelSource labels_;
+    QRectF tile_;
+    QString cacheKey_;
+    QVector<Cell> cells_;
+    QVector<QRectF> pins_;
+    QVector<QLineF> wires_;
+    QVector<QLineF> bundles_;
+    // Weighted wires by width class: weights 2-3, 4-7, ..., 64 and up.
+    static constexpr int kWeightClasses = 6;
+    std::array<QVector<QLineF>, kWeightClasses> heavy_;
+    std::array<QPainterPath, kWeightClasses> heavyPaths_;
+    QVector<QRectF> highlightPins_;
+    QVector<QLineF> highlightWires_;
+    QPainterPath cellPath_;
+    QPainterPath pinPath_;
+    QPainterPath wirePath_;
+    QPainterPath bundlePath_;
+    Bins density_{};
+    uint32_t heatmapScale_ = 1;
+    bool heatmap_ = false;
+    bool dimmed_ = false;
+    QRectF bounds_;
+};
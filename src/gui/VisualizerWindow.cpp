@@ -1,108 +1,1162 @@
 #include "VisualizerWindow.h"
-#include "verilog_parser/VerilogParser.h"
+#include "HierarchyClusters.h"
+#include "SchematicRegionItem.h"
+#include "verilog_parser/DefPlacement.h"
+#include "verilog_parser/NetlistCone.h"
+#include "verilog_parser/NetlistDb.h"
+#include "verilog_parser/NetlistPath.h"
+#include "verilog_parser/PinDirections.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
 
 #include <QVBoxLayout>
+#include <QApplication>
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QMouseEvent>
 #include <QGraphicsSceneMouseEvent>
+#include <QHelpEvent>
+#include <QMetaObject>
+#include <QPixmapCache>
+#include <QScrollBar>
+#include <QSet>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
+#include <QtMath>
+#include <QToolTip>
 #include <QWheelEvent>
 #include <QDebug>
 
-VisualizerWindow::VisualizerWindow(VerilogParser* parser, QWidget* parent)
-    : QWidget(parent), parser_(parser) {
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+VisualizerWindow::VisualizerWindow(QWidget* parent)
+    : QWidget(parent) {
     view_ = new QGraphicsView(this);
     scene_ = new QGraphicsScene(this);
+    // Only the tiles around the viewport are in the scene; a spatial
+    // index over a few dozen items costs more than it saves.
+    scene_->setItemIndexMethod(QGraphicsScene::NoIndex);
     view_->setScene(scene_);
     view_->setRenderHint(QPainter::Antialiasing);
     view_->setDragMode(QGraphicsView::ScrollHandDrag);
+    // Room for the region tiles of a few screens at every zoom octave.
+    QPixmapCache::setCacheLimit(std::max(QPixmapCache::cacheLimit(), 256 * 1024));
+    view_->viewport()->installEventFilter(this);
+    connect(view_->horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]() { scheduleRefresh(); });
+    connect(view_->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { scheduleRefresh(); });
 
     auto* layout = new QVBoxLayout(this);
     layout->addWidget(view_);
     setLayout(layout);
     setWindowTitle("Netlist Visualizer");
     resize(800, 600);
+    layout_ = std::make_shared<SchematicLayout>();
+}
+
+VisualizerWindow::~VisualizerWindow() {
+    // The worker's sink posts back to this window; stop it first.
+    engine_.cancel();
+}
+
+namespace {
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
 }
 
-void VisualizerWindow::loadGraph(const QMap<QString, QStringList>& pinsByCell,
-                                 const QMap<QPair<QString, QString>, QString>& netByPin) {
+// Tile keys pack the level (0 for detail tiles, k + 1 for heatmap level k)
+// above a biased row and column.
+constexpr int kLevelShift = 56;
+constexpr qint64 kTileBias = qint64(1) << 27;
+constexpr quint64 kTileMask = (quint64(1) << 28) - 1;
+constexpr quint32 kNoItem = ~0u;
+// Depth of the cones offered by the context menu.
+constexpr int kConeLevels = 8;
+// Largest cluster expansion laid out while the user waits.
+constexpr size_t kLocalLayoutNodes = 2000;
+// Space kept around an expanded cluster's children.
+constexpr qreal kClusterGap = 150;
+// Cone columns are this far apart; cells in a column this far apart
+// beyond their label.
+constexpr qreal kConeColumnPitch = 300;
+constexpr qreal kConeRowGap = 20;
+// Cones opened from the context menu.
+constexpr int kConeViewLevels = 2;
+constexpr size_t kConeViewCells = 10000;
+
+qreal tileSize(int level, qreal regionSize) {
+    return level == 0 ? regionSize : regionSize * static_cast<qreal>(qint64(1) << (level - 1));
+}
+
+}  // namespace
+
+void VisualizerWindow::loadDesign(std::shared_ptr<const NetlistDb> design) {
+    TraceScope trace("gui", "loadDesign", std::to_string(design->cellCount()) + " cells");
+    if (design != design_)
+        placement_.reset();
+    design_ = std::move(design);
+    clusterTree_.reset();
+    cone_.reset();
+    rebuild();
+}
+
+void VisualizerWindow::rebuild() {
+    engine_.cancel();
+    ++loadId_;
     scene_->clear();
-    pinItems_.clear();
-    netLines_.clear();
+    tiles_.clear();
+    pool_.clear();
+    pinOutput_.clear();
+    resetHighlight();
+    fitLayout_ = true;
+    ++generation_;
+    viewNodes_.clear();
+    edgeNets_.clear();
+    clusterView_.reset();
+    coneNets_.clear();
+    if (!design_)
+        return;
+
+    std::shared_ptr<SchematicLayout> layout;
+    if (cone_) {
+        layout = coneLayout(nullptr);
+    } else if (physicalShown()) {
+        layout = std::make_shared<SchematicLayout>(SchematicLayout::physicalOf(*design_, *placement_));
+        pinOutput_ = SchematicLayout::outputPins(*design_, PinDirections().resolve(*design_));
+    } else if (clustered_) {
+        if (!clusterTree_) {
+            auto tree = std::make_shared<HierarchyClusters>();
+            tree->build(*design_);
+            clusterTree_ = std::move(tree);
+        }
+        clusterView_ = std::make_unique<ClusterView>(clusterTree_, design_, static_cast<size_t>(bundleThreshold_));
+        viewNodes_ = clusterView_->nodes();
+        layout = clusterLayout(viewNodes_, {}, pinOutput_, edgeNets_);
+    } else {
+        layout = flatLayout();
+    }
+    layout->joinNets(flyLineStyle_ == FlyLineStyle::Star, bundleThreshold_);
+    layout->buildIndex();
+    base_ = layout;
+    applyLayout(layout);
+    // A cone is placed by level as it is built, a placement as read.
+    if (cone_)
+        selectSeed();
+    else if (!physicalShown())
+        startLayout();
+}
+
+void VisualizerWindow::resetHighlight() {
+    selected_.clear();
+    highlightPins_.clear();
+    highlightWires_.clear();
+    dimmed_ = false;
+}
+
+std::shared_ptr<SchematicLayout> VisualizerWindow::flatLayout() {
+    // A square grid to show until the engine's first placement arrives.
+    // The layered mode ranks cells along the nets' output pins.
+    auto layout = std::make_shared<SchematicLayout>(SchematicLayout::gridOf(*design_));
+    pinOutput_ = SchematicLayout::outputPins(*design_, PinDirections().resolve(*design_));
+    return layout;
+}
+
+void VisualizerWindow::setClustered(bool clustered) {
+    if (clustered == clustered_ && !cone_)
+        return;
+    clustered_ = clustered;
+    if (clustered)
+        physical_ = false;
+    cone_.reset();
+    rebuild();
+}
+
+void VisualizerWindow::showPlacement(std::shared_ptr<const NetlistDb> design,
+                                     std::shared_ptr<const DefPlacement> placement) {
+    TraceScope trace("gui", "showPlacement", std::to_string(placement->placedCount()) + " placed");
+    if (design != design_)
+        clusterTree_.reset();
+    design_ = std::move(design);
+    placement_ = std::move(placement);
+    physical_ = true;
+    clustered_ = false;
+    cone_.reset();
+    rebuild();
+}
 
-    int x = 50, y = 50;
-    int cellSpacing = 150;
-    int pinSpacing = 20;
+void VisualizerWindow::setPhysical(bool physical) {
+    if (physical == physical_ && !cone_)
+        return;
+    physical_ = physical;
+    if (physical)
+        clustered_ = false;
+    cone_.reset();
+    rebuild();
+}
 
-    for (auto it = pinsByCell.begin(); it != pinsByCell.end(); ++it) {
-        QString cellName = it.key();
-        const QStringList& pins = it.value();
+std::shared_ptr<SchematicLayout> VisualizerWindow::clusterLayout(const std::vector<uint32_t>& nodes,
+                                                                 const QHash<quint32, QPointF>& centers,
+                                                                 std::vector<uint8_t>& pinOutput,
+                                                                 QHash<quint64, quint32>& edgeNets) const {
+    const HierarchyClusters& tree = clusterView_->tree();
+    QHash<quint32, quint32> index;
+    index.reserve(static_cast<int>(nodes.size()));
+    for (size_t c = 0; c < nodes.size(); ++c)
+        index.insert(nodes[c], static_cast<quint32>(c));
 
-        auto* cellBox = scene_->addRect(x, y, 100, 30 + pinSpacing * pins.size(),
-                                        QPen(Qt::black), QBrush(Qt::lightGray));
-        scene_->addText(cellName)->setPos(x + 5, y - 20);
+    // Edges among `nodes`, in key order so net IDs do not depend on the
+    // hash map's.
+    std::vector<uint64_t> keys;
+    for (const auto& edge : clusterView_->edges()) {
+        if (index.contains(static_cast<quint32>(edge.first >> 32)) && index.contains(static_cast<quint32>(edge.first)))
+            keys.push_back(edge.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<std::vector<uint32_t>> incident(nodes.size());
+    for (uint32_t e = 0; e < keys.size(); ++e) {
+        incident[index.value(static_cast<quint32>(keys[e] >> 32))].push_back(e);
+        incident[index.value(static_cast<quint32>(keys[e]))].push_back(e);
+    }
 
-        int pinY = y + 10;
-        for (const QString& pin : pins) {
-            auto* pinRect = scene_->addRect(x + 10, pinY, 10, 10, QPen(Qt::blue), QBrush(Qt::blue));
-            pinItems_[cellName + "/" + pin] = pinRect;
-            connectItem(pinRect);
-            pinY += pinSpacing;
+    // Cells keep their 100x50 box; a cluster grows with the log of its size.
+    auto sizeOf = [&](uint32_t node) {
+        if (node & ClusterView::kCellFlag)
+            return QSizeF(100, 50);
+        const qreal width = 120 + 40 * std::log2(1.0 + tree.cellCount(node));
+        return QSizeF(width, width / 2);
+    };
+    const int columns = std::max(1, qCeil(std::sqrt(static_cast<qreal>(nodes.size()))));
+    const qreal pitch = 2 * sizeOf(HierarchyClusters::kRoot).width();
+
+    // Every pin of a node sits at its centre; the edges meet there.
+    auto layout = std::make_shared<SchematicLayout>();
+    std::vector<uint32_t> ends(2 * keys.size());
+    layout->reserve(nodes.size(), ends.size());
+    for (size_t c = 0; c < nodes.size(); ++c) {
+        const QSizeF size = sizeOf(nodes[c]);
+        const QPointF center = centers.value(nodes[c], QPointF((c % columns + 0.5) * pitch, (c / columns + 0.5) * pitch));
+        const float x = static_cast<float>(center.x() - size.width() / 2);
+        const float y = static_cast<float>(center.y() - size.height() / 2);
+        layout->addCell(x, y, static_cast<float>(size.width()), static_cast<float>(size.height()));
+        for (uint32_t e : incident[c]) {
+            const bool first = index.value(static_cast<quint32>(keys[e] >> 32)) == static_cast<quint32>(c);
+            ends[2 * e + (first ? 0 : 1)] = layout->addPin(static_cast<float>(center.x() - SchematicLayout::kPinSize / 2),
+                                                           static_cast<float>(center.y() - SchematicLayout::kPinSize / 2));
         }
+    }
+    // The lower node of an edge drives it, which is all the layered mode
+    // needs to rank the view.
+    pinOutput.assign(ends.size(), 0);
+    edgeNets.clear();
+    layout->net_weight.reserve(keys.size());
+    for (uint32_t e = 0; e < keys.size(); ++e) {
+        pinOutput[ends[2 * e]] = 1;
+        edgeNets.insert(keys[e], layout->addNet(&ends[2 * e], 2));
+        layout->net_weight.push_back(clusterView_->edges().at(keys[e]));
+    }
+    return layout;
+}
 
-        x += cellSpacing;
+QHash<quint32, QPointF> VisualizerWindow::nodeCenters() const {
+    QHash<quint32, QPointF> centers;
+    centers.reserve(static_cast<int>(viewNodes_.size()));
+    for (size_t c = 0; c < viewNodes_.size() && c < layout_->cellCount(); ++c) {
+        centers.insert(viewNodes_[c], QPointF(layout_->cell_x[c] + layout_->cell_w[c] / 2,
+                                              layout_->cell_y[c] + layout_->cell_h[c] / 2));
     }
+    return centers;
+}
 
-    // Draw fly-lines for nets
-    for (auto it = netByPin.begin(); it != netByPin.end(); ++it) {
-        QString fromPinKey = it.key().first + "/" + it.key().second;
-        QString netName = it.value();
+void VisualizerWindow::showClusters(const QHash<quint32, QPointF>& centers) {
+    // Placements still streaming in are for the old view.
+    engine_.cancel();
+    ++loadId_;
+    std::vector<uint32_t> nodes = clusterView_->nodes();
+    auto layout = clusterLayout(nodes, centers, pinOutput_, edgeNets_);
+    viewNodes_ = std::move(nodes);
+    layout->joinNets(flyLineStyle_ == FlyLineStyle::Star, bundleThreshold_);
+    layout->buildIndex();
+    resetHighlight();
+    base_ = layout;
+    applyLayout(layout);
+}
 
-        QGraphicsRectItem* fromItem = pinItems_.value(fromPinKey, nullptr);
-        if (!fromItem)
-            continue;
+void VisualizerWindow::expandCluster(quint32 cluster) {
+    if (!clusterView_)
+        return;
+    QHash<quint32, QPointF> centers = nodeCenters();
+    if (!centers.contains(cluster) || !clusterView_->expand(cluster))
+        return;
+    TraceScope trace("gui", "expandCluster", clusterView_->tree().name(cluster));
+    const QPointF at = centers.take(cluster);
+    const size_t was = std::find(viewNodes_.begin(), viewNodes_.end(), cluster) - viewNodes_.begin();
+    const qreal width = layout_->cell_w[was], height = layout_->cell_h[was];
+
+    // The children are laid out on their own and put where the cluster was.
+    std::vector<uint32_t> added;
+    for (uint32_t node : clusterView_->nodes()) {
+        if (!centers.contains(node))
+            added.push_back(node);
+    }
+    std::vector<uint8_t> outputs;
+    QHash<quint64, quint32> nets;
+    const auto block = clusterLayout(added, {}, outputs, nets);
+    std::vector<float> x = block->cell_x, y = block->cell_y;
+    const bool local = added.size() <= kLocalLayoutNodes;
+    if (local) {
+        LayoutEngine::Options options;
+        options.mode = layoutMode_;
+        options.max_fanout = static_cast<size_t>(bundleThreshold_);
+        LayoutEngine::run(*block, outputs, options, [&](std::vector<float> nx, std::vector<float> ny, bool) {
+            x = std::move(nx);
+            y = std::move(ny);
+        });
+    }
+    float x0 = std::numeric_limits<float>::max(), y0 = x0;
+    float x1 = std::numeric_limits<float>::lowest(), y1 = x1;
+    for (size_t c = 0; c < added.size(); ++c) {
+        x0 = std::min(x0, x[c]);
+        y0 = std::min(y0, y[c]);
+        x1 = std::max(x1, x[c] + block->cell_w[c]);
+        y1 = std::max(y1, y[c] + block->cell_h[c]);
+    }
 
-        for (auto jt = netByPin.begin(); jt != netByPin.end(); ++jt) {
-            if (jt == it || jt.value() != netName)
+    // Everything else moves away from the block by as much as it outgrew
+    // the cluster, so nothing ends up on top of it.
+    const qreal dx = std::max<qreal>(0, (x1 - x0 - width) / 2 + kClusterGap);
+    const qreal dy = std::max<qreal>(0, (y1 - y0 - height) / 2 + kClusterGap);
+    for (auto it = centers.begin(); it != centers.end(); ++it) {
+        QPointF& p = it.value();
+        p.rx() += p.x() > at.x() ? dx : p.x() < at.x() ? -dx : 0;
+        p.ry() += p.y() > at.y() ? dy : p.y() < at.y() ? -dy : 0;
+    }
+    const QPointF shift = at - QPointF((x0 + x1) / 2, (y0 + y1) / 2);
+    for (size_t c = 0; c < added.size(); ++c)
+        centers.insert(added[c], QPointF(x[c] + block->cell_w[c] / 2, y[c] + block->cell_h[c] / 2) + shift);
+    showClusters(centers);
+    // A block too big to wait for keeps its grid and the whole view is
+    // laid out again in the background.
+    if (!local)
+        startLayout();
+}
+
+void VisualizerWindow::collapseCluster(quint32 cluster) {
+    if (!clusterView_ || cluster >= clusterView_->tree().clusterCount() || !clusterView_->isOpen(cluster))
+        return;
+    const HierarchyClusters& tree = clusterView_->tree();
+    // The cluster goes where the middle of what it swallows was.
+    QHash<quint32, QPointF> centers = nodeCenters();
+    QPointF sum;
+    int count = 0;
+    for (auto it = centers.begin(); it != centers.end();) {
+        const uint32_t node = it.key();
+        const uint32_t in = node & ClusterView::kCellFlag ? tree.clusterOf(node & ~ClusterView::kCellFlag) : node;
+        if (in >= cluster && in < tree.subtreeEnd(cluster)) {
+            sum += it.value();
+            ++count;
+            it = centers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!clusterView_->collapse(cluster))
+        return;
+    if (count > 0)
+        centers.insert(cluster, sum / count);
+    showClusters(centers);
+}
+
+void VisualizerWindow::showCone(std::shared_ptr<const NetlistDb> design, const NetlistCone& cone) {
+    TraceScope trace("gui", "showCone", std::to_string(cone.cells().size()) + " cells");
+    const NetlistPath::Endpoint& seed = cone.seed();
+    const bool grows = cone_ && design == design_ && cone_->seed().kind == seed.kind && cone_->seed().id == seed.id &&
+                       cone_->seed().pin == seed.pin;
+    if (design != design_)
+        clusterTree_.reset();
+    design_ = std::move(design);
+    std::unique_ptr<NetlistCone> previous = std::move(cone_);
+    cone_ = std::make_unique<NetlistCone>(cone);
+    if (!grows) {
+        rebuild();
+        return;
+    }
+    // Only the new levels are placed; the swap is the same as for a
+    // streamed placement.
+    engine_.cancel();
+    ++loadId_;
+    auto layout = coneLayout(previous.get());
+    layout->joinNets(flyLineStyle_ == FlyLineStyle::Star, bundleThreshold_);
+    layout->buildIndex();
+    resetHighlight();
+    base_ = layout;
+    applyLayout(layout);
+    selectSeed();
+}
+
+void VisualizerWindow::showConeAt(quint32 cell, quint32 pin) {
+    NetlistPath::Endpoint seed;
+    seed.id = cell;
+    seed.pin = pin == kNoItem ? NetlistDb::kNone : pin;
+    NetlistCone::Options options;
+    options.max_fanout = static_cast<size_t>(bundleThreshold_);
+    options.max_cells = kConeViewCells;
+    NetlistCone cone(*design_, seed, PinDirections().resolve(*design_), options);
+    cone.grow(*design_, kConeViewLevels, kConeViewLevels);
+    showCone(design_, cone);
+}
+
+void VisualizerWindow::growCone() {
+    if (!cone_)
+        return;
+    NetlistCone next = *cone_;
+    next.grow(*design_, next.faninLevels() + 1, next.fanoutLevels() + 1);
+    showCone(design_, next);
+}
+
+void VisualizerWindow::showDesign() {
+    if (!cone_)
+        return;
+    cone_.reset();
+    rebuild();
+}
+
+std::shared_ptr<SchematicLayout> VisualizerWindow::coneLayout(const NetlistCone* previous) {
+    const NetlistDb& db = *design_;
+    const NetlistCone& cone = *cone_;
+    const std::vector<NetlistDb::Id>& cells = cone.cells();
+    const int pinSpacing = 20;
+    const qreal width = 100;
+    auto heightOf = [&](NetlistDb::Id cell) { return 30.0 + pinSpacing * (db.pinEnd(cell) - db.pinBegin(cell)); };
+
+    // Cells already on screen keep their corner. The rest go below them
+    // in their level's column, or centred on the seed's row in a new
+    // column, in the order reached, which follows the level before.
+    std::vector<QPointF> at(cells.size());
+    std::vector<uint8_t> placed(cells.size(), 0);
+    QHash<int, qreal> bottom, fresh;
+    if (previous) {
+        for (size_t c = 0; c < cells.size(); ++c) {
+            const NetlistDb::Id was = previous->indexOf(cells[c]);
+            if (was == NetlistDb::kNone || was >= layout_->cellCount())
                 continue;
+            at[c] = QPointF(layout_->cell_x[was], layout_->cell_y[was]);
+            placed[c] = 1;
+            const qreal below = at[c].y() + layout_->cell_h[was] + SchematicLayout::kLabelHeight + kConeRowGap;
+            bottom[cone.level(c)] = std::max(bottom.value(cone.level(c), below), below);
+        }
+    }
+    for (size_t c = 0; c < cells.size(); ++c) {
+        if (!placed[c])
+            fresh[cone.level(c)] += heightOf(cells[c]) + SchematicLayout::kLabelHeight + kConeRowGap;
+    }
+    for (size_t c = 0; c < cells.size(); ++c) {
+        if (placed[c])
+            continue;
+        const int level = cone.level(c);
+        if (!bottom.contains(level))
+            bottom.insert(level, -fresh.value(level) / 2 + SchematicLayout::kLabelHeight);
+        qreal& y = bottom[level];
+        at[c] = QPointF(level * kConeColumnPitch, y);
+        y += heightOf(cells[c]) + SchematicLayout::kLabelHeight + kConeRowGap;
+    }
 
-            QString toPinKey = jt.key().first + "/" + jt.key().second;
-            QGraphicsRectItem* toItem = pinItems_.value(toPinKey, nullptr);
-            if (!toItem)
+    // Every pin of a cone cell is drawn, inputs on the left and outputs on
+    // the right; nets keep the pins in the cone.
+    size_t pinCount = 0;
+    for (NetlistDb::Id cell : cells)
+        pinCount += db.pinEnd(cell) - db.pinBegin(cell);
+    auto layout = std::make_shared<SchematicLayout>();
+    layout->reserve(cells.size(), pinCount);
+    pinOutput_.clear();
+    pinOutput_.reserve(pinCount);
+    coneNets_.clear();
+    std::unordered_map<NetlistDb::Id, uint32_t> netIndex;
+    std::vector<std::vector<uint32_t>> netPins;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        const float x = static_cast<float>(at[c].x()), y = static_cast<float>(at[c].y());
+        const NetlistDb::Id cell = cells[c];
+        layout->addCell(x, y, static_cast<float>(width), static_cast<float>(heightOf(cell)));
+        for (NetlistDb::Id p = db.pinBegin(cell); p < db.pinEnd(cell); ++p) {
+            const bool output = cone.directions().of(db, p) == PortDirection::Output;
+            const float px = output ? x + static_cast<float>(width) - 10 - SchematicLayout::kPinSize : x + 10;
+            const uint32_t pin = layout->addPin(px, y + 10 + pinSpacing * (p - db.pinBegin(cell)));
+            pinOutput_.push_back(output ? 1 : 0);
+            const NetlistDb::Id net = db.pinNet(p);
+            if (db.netName(net).empty())
                 continue;
+            const auto slot = netIndex.emplace(net, static_cast<uint32_t>(coneNets_.size()));
+            if (slot.second) {
+                coneNets_.push_back(net);
+                netPins.emplace_back();
+            }
+            netPins[slot.first->second].push_back(pin);
+        }
+    }
+    for (const std::vector<uint32_t>& pins : netPins)
+        layout->addNet(pins.data(), pins.size());
+    return layout;
+}
+
+void VisualizerWindow::selectSeed() {
+    const NetlistPath::Endpoint& seed = cone_->seed();
+    QVector<quint32> pins;
+    if (seed.kind == NetlistPath::Kind::Net) {
+        const auto net = std::find(coneNets_.begin(), coneNets_.end(), seed.id);
+        if (net != coneNets_.end()) {
+            const uint32_t n = static_cast<uint32_t>(net - coneNets_.begin());
+            for (uint32_t i = layout_->net_offset[n]; i < layout_->net_offset[n + 1]; ++i)
+                pins.append(layout_->net_pins[i]);
+        }
+    } else if (seed.pin != NetlistDb::kNone) {
+        // The seed cell is cell 0.
+        pins.append(layout_->pin_offset[0] + (seed.pin - design_->pinBegin(seed.id)));
+    } else {
+        for (uint32_t p = layout_->pin_offset[0]; p < layout_->pin_offset[1]; ++p)
+            pins.append(p);
+    }
+    selectPins(pins, false);
+}
+
+bool VisualizerWindow::endpointAt(const QPoint& pos, quint32& cell, quint32& pin) const {
+    quint32 viewPin, viewCell;
+    if (!design_ || !hitTest(view_->mapToScene(pos), viewPin, viewCell))
+        return false;
+    if (cone_) {
+        cell = cone_->cells()[viewCell];
+        pin = viewPin == kNoItem ? kNoItem : design_->pinBegin(cell) + (viewPin - layout_->pin_offset[viewCell]);
+        return true;
+    }
+    if (clusterView_) {
+        // Cluster pins stand for edges; only cells are design objects.
+        if (viewCell >= viewNodes_.size() || !(viewNodes_[viewCell] & ClusterView::kCellFlag))
+            return false;
+        cell = viewNodes_[viewCell] & ~ClusterView::kCellFlag;
+        pin = kNoItem;
+        return true;
+    }
+    cell = viewCell;
+    pin = viewPin;
+    return true;
+}
+
+QString VisualizerWindow::cellLabel(quint32 cell) const {
+    if (cone_ && cell < cone_->cells().size())
+        return toQString(design_->cellName(cone_->cells()[cell]));
+    if (!clusterView_ || cell >= viewNodes_.size())
+        return toQString(design_->cellName(cell));
+    const uint32_t node = viewNodes_[cell];
+    if (node & ClusterView::kCellFlag)
+        return toQString(design_->cellName(node & ~ClusterView::kCellFlag));
+    const HierarchyClusters& tree = clusterView_->tree();
+    return QString("%1 (%2 cells)").arg(QString::fromStdString(tree.label(node))).arg(tree.cellCount(node));
+}
+
+void VisualizerWindow::setLayoutMode(LayoutEngine::Mode mode) {
+    if (mode == layoutMode_)
+        return;
+    layoutMode_ = mode;
+    if (base_ && base_->cellCount() > 0 && !physicalShown()) {
+        ++loadId_;
+        fitLayout_ = true;
+        startLayout();
+    }
+}
+
+void VisualizerWindow::startLayout() {
+    LayoutEngine::Options options;
+    options.mode = layoutMode_;
+    options.max_fanout = static_cast<size_t>(bundleThreshold_);
+
+    const std::shared_ptr<const SchematicLayout> base = base_;
+    const bool star = flyLineStyle_ == FlyLineStyle::Star;
+    const size_t threshold = static_cast<size_t>(bundleThreshold_);
+    const quint64 id = loadId_;
+    engine_.start(base, pinOutput_, options, [this, base, star, threshold, id](std::vector<float> x, std::vector<float> y,
+                                                                             bool final) {
+        // Runs on the layout worker: everything but the swap happens here.
+        auto next = std::make_shared<SchematicLayout>(*base);
+        next->place(x, y);
+        if (final)
+            next->joinNets(star, threshold);  // fly-lines for where the pins ended up
+        next->buildIndex();
+        QMetaObject::invokeMethod(
+            this,
+            [this, next, id]() {
+                if (id == loadId_)
+                    applyLayout(next);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void VisualizerWindow::applyLayout(std::shared_ptr<const SchematicLayout> layout) {
+    TraceScope trace("gui", "applyLayout", std::to_string(layout->cellCount()) + " cells");
+    layout_ = std::move(layout);
+    // Every tile is stale; new cache keys keep old pixmaps from showing.
+    ++generation_;
+    for (auto it = tiles_.begin(); it != tiles_.end(); ++it) {
+        it.value()->reset();
+        pool_.append(it.value());
+    }
+    tiles_.clear();
+    if (layout_->cellCount() == 0)
+        return;
+
+    const SchematicLayout::Box all = layout_->bounds();
+    const QRectF rect = QRectF(all.x0, all.y0, all.x1 - all.x0, all.y1 - all.y0).adjusted(-50, -50, 50, 50);
+    scene_->setSceneRect(rect);
+    if (fitLayout_)
+        view_->fitInView(rect, Qt::KeepAspectRatio);
+    refreshTiles();
+}
+
+quint64 VisualizerWindow::tileKey(int level, qreal x, qreal y) const {
+    const qreal size = tileSize(level, kRegionSize);
+    const qint64 col = static_cast<qint64>(std::floor(x / size)) + kTileBias;
+    const qint64 row = static_cast<qint64>(std::floor(y / size)) + kTileBias;
+    return quint64(level) << kLevelShift | (quint64(row) & kTileMask) << 28 | (quint64(col) & kTileMask);
+}
 
-            QPointF p1 = fromItem->sceneBoundingRect().center();
-            QPointF p2 = toItem->sceneBoundingRect().center();
+QRectF VisualizerWindow::tileRect(quint64 key) const {
+    const qreal size = tileSize(static_cast<int>(key >> kLevelShift), kRegionSize);
+    const qint64 col = static_cast<qint64>(key & kTileMask) - kTileBias;
+    const qint64 row = static_cast<qint64>((key >> 28) & kTileMask) - kTileBias;
+    return QRectF(col * size, row * size, size, size);
+}
+
+void VisualizerWindow::scheduleRefresh() {
+    if (refreshPending_)
+        return;
+    refreshPending_ = true;
+    QTimer::singleShot(0, this, [this]() {
+        refreshPending_ = false;
+        refreshTiles();
+    });
+}
 
-            auto* line = scene_->addLine(QLineF(p1, p2), QPen(Qt::red, 2));
-            netLines_[netName].append(line);
+void VisualizerWindow::refreshTiles() {
+    if (layout_->cellCount() == 0)
+        return;
+    // Half a screen of margin on every side keeps short pans off the
+    // fill path.
+    const QRectF visible = view_->mapToScene(view_->viewport()->rect()).boundingRect();
+    const QRectF area = visible.adjusted(-visible.width() / 2, -visible.height() / 2,
+                                         visible.width() / 2, visible.height() / 2);
+    const SchematicLayout::Box box{static_cast<float>(area.left()), static_cast<float>(area.top()),
+                                   static_cast<float>(area.right()), static_cast<float>(area.bottom())};
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(view_->transform());
+
+    QSet<quint64> wanted;
+    if (SchematicRegionItem::detailFor(lod) == SchematicRegionItem::Detail::Heatmap) {
+        // The finest level whose tiles are at least 256 pixels across.
+        int k = std::max(0, qCeil(std::log2(256.0 / (kRegionSize * lod))));
+        k = std::clamp(k, layout_->density_first, static_cast<int>(layout_->density.size()) - 1);
+        const SchematicLayout::Box all = layout_->bounds();
+        const QRectF clipped = area & QRectF(all.x0, all.y0, all.x1 - all.x0, all.y1 - all.y0);
+        const qreal size = tileSize(k + 1, kRegionSize);
+        for (qreal ty = std::floor(clipped.top() / size) * size; ty <= clipped.bottom(); ty += size) {
+            for (qreal tx = std::floor(clipped.left() / size) * size; tx <= clipped.right(); tx += size)
+                wanted.insert(tileKey(k + 1, tx + size / 2, ty + size / 2));
+        }
+    } else {
+        // Whatever reaches into the area, keyed by the tile that owns it.
+        layout_->cell_index.query(box, [&](uint32_t c) {
+            wanted.insert(tileKey(0, layout_->cell_x[c], layout_->cell_y[c]));
+        });
+        layout_->wire_index.query(box, [&](uint32_t w) {
+            wanted.insert(tileKey(0, layout_->wire_x0[w], layout_->wire_y0[w]));
+        });
+    }
+
+    for (auto it = tiles_.begin(); it != tiles_.end();) {
+        if (wanted.contains(it.key())) {
+            ++it;
+            continue;
         }
+        it.value()->reset();
+        pool_.append(it.value());
+        it = tiles_.erase(it);
+    }
+    for (quint64 key : wanted) {
+        if (tiles_.contains(key))
+            continue;
+        SchematicRegionItem* item;
+        if (pool_.isEmpty()) {
+            item = new SchematicRegionItem();
+            item->setLabelSource([this](quint32 cell) { return cellLabel(cell); });
+            scene_->addItem(item);
+        } else {
+            item = pool_.takeLast();
+        }
+        fillTile(item, key);
+        tiles_.insert(key, item);
+    }
+}
+
+void VisualizerWindow::fillTile(SchematicRegionItem* item, quint64 key) {
+    const QRectF rect = tileRect(key);
+    const int level = static_cast<int>(key >> kLevelShift);
+    item->begin(rect, QStringLiteral("schematic:%1:%2").arg(generation_).arg(key));
+
+    if (level > 0) {
+        const SchematicLayout::DensityLevel& density = layout_->density[level - 1];
+        const qint64 col0 = static_cast<qint64>(std::floor(rect.left() / (rect.width() / SchematicRegionItem::kBins)));
+        const qint64 row0 = static_cast<qint64>(std::floor(rect.top() / (rect.height() / SchematicRegionItem::kBins)));
+        SchematicRegionItem::Bins bins;
+        for (int by = 0; by < SchematicRegionItem::kBins; ++by) {
+            for (int bx = 0; bx < SchematicRegionItem::kBins; ++bx)
+                bins[by * SchematicRegionItem::kBins + bx] = density.at(col0 + bx, row0 + by);
+        }
+        item->setHeatmap(bins, density.max);
+    } else {
+        const SchematicLayout::Box box{static_cast<float>(rect.left()), static_cast<float>(rect.top()),
+                                       static_cast<float>(rect.right()), static_cast<float>(rect.bottom())};
+        layout_->cell_index.query(box, [&](uint32_t c) {
+            if (tileKey(0, layout_->cell_x[c], layout_->cell_y[c]) != key)
+                return;
+            item->addCell(c, QRectF(layout_->cell_x[c], layout_->cell_y[c], layout_->cell_w[c], layout_->cell_h[c]));
+            for (uint32_t p = layout_->pin_offset[c]; p < layout_->pin_offset[c + 1]; ++p)
+                item->addPin(QRectF(layout_->pin_x[p], layout_->pin_y[p], SchematicLayout::kPinSize, SchematicLayout::kPinSize));
+        });
+        layout_->wire_index.query(box, [&](uint32_t w) {
+            if (tileKey(0, layout_->wire_x0[w], layout_->wire_y0[w]) != key)
+                return;
+            item->addWire(QLineF(layout_->wire_x0[w], layout_->wire_y0[w], layout_->wire_x1[w], layout_->wire_y1[w]),
+                          layout_->wire_bundle[w] != 0, layout_->netWeight(layout_->wire_net[w]));
+        });
+    }
+    applyHighlight(item, key);
+    item->setDimmed(dimmed_);
+    item->finalize();
+}
+
+void VisualizerWindow::applyHighlight(SchematicRegionItem* item, quint64 key) const {
+    // Highlighted pins belong to the tile of their cell, wires to the tile
+    // of their first end, as for the geometry itself.
+    const int level = static_cast<int>(key >> kLevelShift);
+    QVector<QRectF> pins;
+    for (quint32 p : highlightPins_) {
+        const uint32_t c = layout_->pin_cell[p];
+        if (tileKey(level, layout_->cell_x[c], layout_->cell_y[c]) == key)
+            pins.append(QRectF(layout_->pin_x[p], layout_->pin_y[p], SchematicLayout::kPinSize, SchematicLayout::kPinSize));
+    }
+    QVector<QLineF> wires;
+    for (quint32 w : highlightWires_) {
+        if (tileKey(level, layout_->wire_x0[w], layout_->wire_y0[w]) == key)
+            wires.append(QLineF(layout_->wire_x0[w], layout_->wire_y0[w], layout_->wire_x1[w], layout_->wire_y1[w]));
     }
+    item->setHighlight(pins, wires);
 }
 
-void VisualizerWindow::connectItem(QGraphicsItem* item) {
-    item->setFlag(QGraphicsItem::ItemIsSelectable);
+void VisualizerWindow::setHighlight(const QVector<quint32>& pins, const QVector<quint32>& wires, bool dimmed) {
+    const bool allTiles = dimmed != dimmed_;
+    QSet<quint64> touched;
+    if (!allTiles) {
+        QSet<int> levels;
+        for (auto it = tiles_.begin(); it != tiles_.end(); ++it)
+            levels.insert(static_cast<int>(it.key() >> kLevelShift));
+        auto mark = [&](const QVector<quint32>& ps, const QVector<quint32>& ws) {
+            for (int level : levels) {
+                for (quint32 p : ps) {
+                    const uint32_t c = layout_->pin_cell[p];
+                    touched.insert(tileKey(level, layout_->cell_x[c], layout_->cell_y[c]));
+                }
+                for (quint32 w : ws)
+                    touched.insert(tileKey(level, layout_->wire_x0[w], layout_->wire_y0[w]));
+            }
+        };
+        mark(highlightPins_, highlightWires_);
+        mark(pins, wires);
+    }
+
+    highlightPins_ = pins;
+    highlightWires_ = wires;
+    dimmed_ = dimmed;
+    for (auto it = tiles_.begin(); it != tiles_.end(); ++it) {
+        if (!allTiles && !touched.contains(it.key()))
+            continue;
+        applyHighlight(it.value(), it.key());
+        it.value()->setDimmed(dimmed_);
+    }
+}
+
+void VisualizerWindow::addNet(quint32 net, QVector<quint32>& pins, QVector<quint32>& wires) const {
+    for (uint32_t i = layout_->net_offset[net]; i < layout_->net_offset[net + 1]; ++i)
+        pins.append(layout_->net_pins[i]);
+    for (uint32_t w = layout_->net_wire_offset[net]; w < layout_->net_wire_offset[net + 1]; ++w)
+        wires.append(w);
 }
 
-void VisualizerWindow::highlightNet(const QString& pinName) {
-    QString net;
-    for (auto it = netLines_.begin(); it != netLines_.end(); ++it) {
-        for (auto* line : it.value()) {
-            line->setPen(QPen(Qt::gray, 1));  // Reset
+void VisualizerWindow::selectPins(const QVector<quint32>& pins, bool add) {
+    if (!add)
+        selected_.clear();
+    for (quint32 pin : pins) {
+        if (pin >= layout_->pinCount())
+            continue;
+        const int at = selected_.indexOf(pin);
+        if (at >= 0 && add)
+            selected_.remove(at);
+        else if (at < 0)
+            selected_.append(pin);
+    }
+    showSelection();
+}
+
+void VisualizerWindow::clearSelection() {
+    selected_.clear();
+    showSelection();
+}
+
+void VisualizerWindow::showSelection() {
+    QVector<quint32> pins, wires;
+    QSet<quint32> nets;
+    for (quint32 pin : selected_) {
+        pins.append(pin);
+        const uint32_t net = layout_->pin_net[pin];
+        if (net != SchematicLayout::kNoNet && !nets.contains(net)) {
+            nets.insert(net);
+            addNet(net, pins, wires);
         }
     }
+    setHighlight(pins, wires, !selected_.isEmpty());
+}
 
-    for (auto it = netLines_.begin(); it != netLines_.end(); ++it) {
-        if (pinName.contains(it.key())) {
-            for (auto* line : it.value()) {
-                line->setPen(QPen(Qt::green, 3));
+void VisualizerWindow::highlightCone(bool fanout, int levels) {
+    if (selected_.isEmpty() || clusterView_)
+        return;
+    // Going forward a cell is entered through its inputs and left through
+    // its outputs; going back the other way round.
+    auto leaves = [&](quint32 pin) { return pin < pinOutput_.size() && (pinOutput_[pin] != 0) == fanout; };
+
+    QVector<quint32> pins, wires, frontier, next;
+    QSet<quint32> nets, cells;
+    auto follow = [&](quint32 pin) {
+        const uint32_t net = layout_->pin_net[pin];
+        if (net == SchematicLayout::kNoNet || nets.contains(net))
+            return;
+        nets.insert(net);
+        addNet(net, pins, wires);
+        for (uint32_t i = layout_->net_offset[net]; i < layout_->net_offset[net + 1]; ++i) {
+            const uint32_t other = layout_->net_pins[i];
+            const uint32_t cell = layout_->pin_cell[other];
+            if (!leaves(other) && !cells.contains(cell)) {
+                cells.insert(cell);
+                next.append(cell);
             }
         }
+    };
+    auto expand = [&](quint32 cell) {
+        for (uint32_t p = layout_->pin_offset[cell]; p < layout_->pin_offset[cell + 1]; ++p) {
+            if (leaves(p))
+                follow(p);
+        }
+    };
+
+    // Selected pins on the way out start on their net; others start at
+    // their cell.
+    for (quint32 pin : selected_) {
+        pins.append(pin);
+        if (leaves(pin)) {
+            follow(pin);
+            continue;
+        }
+        const uint32_t cell = layout_->pin_cell[pin];
+        if (!cells.contains(cell)) {
+            cells.insert(cell);
+            expand(cell);
+        }
+    }
+    for (int level = 1; level < levels && !next.isEmpty(); ++level) {
+        frontier.swap(next);
+        next.clear();
+        for (quint32 cell : frontier)
+            expand(cell);
+    }
+    setHighlight(pins, wires, true);
+}
+
+bool VisualizerWindow::hitTest(const QPointF& pos, quint32& pin, quint32& cell) const {
+    pin = cell = kNoItem;
+    const float slack = static_cast<float>(2.0 / QStyleOptionGraphicsItem::levelOfDetailFromTransform(view_->transform()));
+    const float x = static_cast<float>(pos.x()), y = static_cast<float>(pos.y());
+    layout_->cell_index.query({x - slack, y - slack, x + slack, y + slack}, [&](uint32_t c) {
+        if (pin != kNoItem)
+            return;
+        for (uint32_t p = layout_->pin_offset[c]; p < layout_->pin_offset[c + 1]; ++p) {
+            if (x >= layout_->pin_x[p] - slack && x <= layout_->pin_x[p] + SchematicLayout::kPinSize + slack &&
+                y >= layout_->pin_y[p] - slack && y <= layout_->pin_y[p] + SchematicLayout::kPinSize + slack) {
+                pin = p;
+                cell = c;
+                return;
+            }
+        }
+        if (x >= layout_->cell_x[c] && x <= layout_->cell_x[c] + layout_->cell_w[c] && y >= layout_->cell_y[c] &&
+            y <= layout_->cell_y[c] + layout_->cell_h[c])
+            cell = c;
+    });
+    return cell != kNoItem;
+}
+
+quint32 VisualizerWindow::nodeAt(const QPoint& pos) const {
+    quint32 pin, cell;
+    if (!clusterView_ || !hitTest(view_->mapToScene(pos), pin, cell) || cell >= viewNodes_.size())
+        return kNoItem;
+    return viewNodes_[cell];
+}
+
+void VisualizerWindow::handleClick(const QPoint& pos, Qt::KeyboardModifiers modifiers) {
+    const bool add = modifiers.testFlag(Qt::ControlModifier);
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(view_->transform());
+    quint32 pin, cell;
+    // Nothing is pickable on the heatmap.
+    if (SchematicRegionItem::detailFor(lod) == SchematicRegionItem::Detail::Heatmap ||
+        !hitTest(view_->mapToScene(pos), pin, cell)) {
+        if (!add)
+            clearSelection();
+        return;
     }
+    QVector<quint32> pins;
+    if (pin != kNoItem) {
+        pins.append(pin);
+    } else {
+        for (uint32_t p = layout_->pin_offset[cell]; p < layout_->pin_offset[cell + 1]; ++p)
+            pins.append(p);
+    }
+    selectPins(pins, add);
+}
+
+bool VisualizerWindow::writeSchematic(const std::string& file, const SchematicExport::Options& options,
+                                      std::string& message) const {
+    if (!design_ || !layout_ || layout_->cellCount() == 0)
+        return false;
+    // The workers only read; this thread waits for them, so nothing the
+    // labels look at changes underneath.
+    return SchematicExport::write(*layout_, [this](quint32 cell) { return cellLabel(cell); }, file, options,
+                                  message);
+}
+
+size_t VisualizerWindow::sceneMemoryBytes() const {
+    // Qt keeps most item state behind a private d-pointer; count a fixed
+    // overhead per item on top of the public object.
+    const size_t kItemPrivate = 256;
+    const size_t kMapNode = 64;
+
+    size_t bytes = layout_->memoryBytes();
+    for (QGraphicsItem* item : scene_->items()) {
+        if (item->type() == SchematicRegionItem::Type)
+            bytes += static_cast<SchematicRegionItem*>(item)->memoryBytes();
+        else
+            bytes += sizeof(QGraphicsItem);
+        bytes += kItemPrivate;
+    }
+    bytes += tiles_.size() * kMapNode + pool_.size() * sizeof(void*);
+    bytes += pinOutput_.capacity();
+    bytes += coneNets_.capacity() * sizeof(uint32_t);
+    if (clusterTree_)
+        bytes += clusterTree_->memoryBytes() + viewNodes_.capacity() * sizeof(uint32_t) + edgeNets_.size() * kMapNode;
+    if (base_ && base_ != layout_)
+        bytes += base_->memoryBytes();
+    return bytes;
+}
+
+void VisualizerWindow::highlightPath(const NetlistDb& db, const NetlistPath& path) {
+    if (!design_)
+        return;
+    // IDs carry over from the snapshot on display; anything else goes by name.
+    const bool same = &db == design_.get();
+    auto localPin = [&](NetlistDb::Id pin) {
+        if (same)
+            return pin;
+        const NetlistDb::Id cell = design_->findCell(db.cellName(db.pinCell(pin)));
+        return cell == NetlistDb::kNone ? NetlistDb::kNone : design_->findPin(cell, db.pinName(pin));
+    };
+    QVector<quint32> pins, wires;
+    if (clusterView_) {
+        // The path runs through the nodes holding its cells and along the
+        // edges between consecutive ones.
+        quint32 last = kNoItem;
+        for (const NetlistPath::Step& step : path.steps) {
+            const NetlistDb::Id pin = step.pin == NetlistDb::kNone ? NetlistDb::kNone : localPin(step.pin);
+            if (pin == NetlistDb::kNone)
+                continue;
+            const quint32 node = clusterView_->nodeOf(design_->pinCell(pin));
+            if (last != kNoItem && node != last) {
+                const auto net = edgeNets_.constFind(ClusterView::edgeKey(last, node));
+                if (net != edgeNets_.constEnd())
+                    addNet(net.value(), pins, wires);
+            }
+            last = node;
+        }
+        selected_.clear();
+        setHighlight(pins, wires, true);
+        if (!pins.isEmpty())
+            view_->centerOn(layout_->pinCenterX(pins.first()), layout_->pinCenterY(pins.first()));
+        return;
+    }
+    // A cone shows only part of the snapshot, under its own IDs.
+    QHash<quint32, quint32> coneNet;
+    for (uint32_t n = 0; n < coneNets_.size(); ++n)
+        coneNet.insert(coneNets_[n], n);
+    auto viewPin = [&](NetlistDb::Id pin) {
+        if (!cone_ || pin == NetlistDb::kNone)
+            return pin;
+        const NetlistDb::Id cell = design_->pinCell(pin);
+        const NetlistDb::Id c = cone_->indexOf(cell);
+        return c == NetlistDb::kNone ? NetlistDb::kNone : layout_->pin_offset[c] + (pin - design_->pinBegin(cell));
+    };
+    for (const NetlistPath::Step& step : path.steps) {
+        if (step.pin != NetlistDb::kNone) {
+            const NetlistDb::Id pin = viewPin(localPin(step.pin));
+            if (pin != NetlistDb::kNone)
+                pins.append(pin);
+        }
+        if (step.kind == NetlistPath::Kind::Net) {
+            NetlistDb::Id net = same ? step.id : design_->findNet(db.netName(step.id));
+            if (cone_ && net != NetlistDb::kNone)
+                net = coneNet.value(net, NetlistDb::kNone);
+            if (net == NetlistDb::kNone || net >= layout_->netCount())
+                continue;
+            for (uint32_t w = layout_->net_wire_offset[net]; w < layout_->net_wire_offset[net + 1]; ++w)
+                wires.append(w);
+        }
+    }
+    selected_.clear();
+    setHighlight(pins, wires, true);
+    if (!pins.isEmpty())
+        view_->centerOn(layout_->pinCenterX(pins.first()), layout_->pinCenterY(pins.first()));
+}
+
+bool VisualizerWindow::eventFilter(QObject* watched, QEvent* event) {
+    if (watched != view_->viewport())
+        return QWidget::eventFilter(watched, event);
+    switch (event->type()) {
+    case QEvent::MouseButtonPress: {
+        fitLayout_ = false;  // the user is panning or picking; stop refitting
+        auto* mouse = static_cast<QMouseEvent*>(event);
+        if (mouse->button() == Qt::LeftButton)
+            pressPos_ = mouse->pos();
+        return QWidget::eventFilter(watched, event);
+    }
+    case QEvent::MouseButtonRelease: {
+        // A release where the press was is a click; anything else was a
+        // drag of the view.
+        auto* mouse = static_cast<QMouseEvent*>(event);
+        if (mouse->button() == Qt::LeftButton &&
+            (mouse->pos() - pressPos_).manhattanLength() < QApplication::startDragDistance())
+            handleClick(mouse->pos(), mouse->modifiers());
+        return QWidget::eventFilter(watched, event);
+    }
+    case QEvent::MouseButtonDblClick: {
+        // Double-clicking a cluster opens it.
+        auto* mouse = static_cast<QMouseEvent*>(event);
+        const quint32 node = nodeAt(mouse->pos());
+        if (mouse->button() != Qt::LeftButton || node == kNoItem || (node & ClusterView::kCellFlag))
+            return QWidget::eventFilter(watched, event);
+        expandCluster(node);
+        return true;
+    }
+    case QEvent::ContextMenu: {
+        auto* context = static_cast<QContextMenuEvent*>(event);
+        const quint32 node = nodeAt(context->pos());
+        const quint32 parent = node == kNoItem ? kNoItem : clusterView_->parentOf(node);
+        QMenu menu;
+        QAction* expandAct = nullptr;
+        QAction* collapseAct = nullptr;
+        if (node != kNoItem) {
+            expandAct = menu.addAction("Expand");
+            expandAct->setEnabled(!(node & ClusterView::kCellFlag));
+            collapseAct = menu.addAction("Collapse Parent");
+            collapseAct->setEnabled(parent != HierarchyClusters::kNone);
+            menu.addSeparator();
+        }
+        QAction* fanoutAct = menu.addAction("Fanout Cone");
+        QAction* faninAct = menu.addAction("Fanin Cone");
+        menu.addSeparator();
+        // A cone view around what is under the cursor, and more of it.
+        quint32 seedCell = kNoItem, seedPin = kNoItem;
+        QAction* coneAct = menu.addAction("Show Cone");
+        coneAct->setEnabled(endpointAt(context->pos(), seedCell, seedPin));
+        QAction* growAct = menu.addAction("Grow Cone");
+        growAct->setEnabled(cone_ != nullptr);
+        QAction* designAct = menu.addAction("Show Whole Design");
+        designAct->setEnabled(cone_ != nullptr);
+        menu.addSeparator();
+        QAction* clearAct = menu.addAction("Clear Selection");
+        for (QAction* act : {fanoutAct, faninAct, clearAct})
+            act->setEnabled(!selected_.isEmpty());
+        // Edges between clusters have no direction to follow.
+        fanoutAct->setEnabled(fanoutAct->isEnabled() && !clusterView_);
+        faninAct->setEnabled(faninAct->isEnabled() && !clusterView_);
+        QAction* chosen = menu.exec(context->globalPos());
+        if (chosen == fanoutAct || chosen == faninAct)
+            highlightCone(chosen == fanoutAct, kConeLevels);
+        else if (chosen == clearAct)
+            clearSelection();
+        else if (chosen == coneAct)
+            showConeAt(seedCell, seedPin);
+        else if (chosen == growAct)
+            growCone();
+        else if (chosen == designAct)
+            showDesign();
+        else if (chosen && chosen == expandAct)
+            expandCluster(node);
+        else if (chosen && chosen == collapseAct)
+            collapseCluster(parent);
+        return true;
+    }
+    case QEvent::ToolTip:
+        break;
+    default:
+        return QWidget::eventFilter(watched, event);
+    }
+
+    // Bundle trunks and cluster edges are the only things with a tooltip.
+    auto* help = static_cast<QHelpEvent*>(event);
+    const QPointF pos = view_->mapToScene(help->pos());
+    const float slack = static_cast<float>(4.0 / QStyleOptionGraphicsItem::levelOfDetailFromTransform(view_->transform()));
+    const SchematicLayout::Box box{static_cast<float>(pos.x()) - slack, static_cast<float>(pos.y()) - slack,
+                                   static_cast<float>(pos.x()) + slack, static_cast<float>(pos.y()) + slack};
+    QString tip;
+    layout_->wire_index.query(box, [&](uint32_t w) {
+        if (!tip.isEmpty())
+            return;
+        if (clusterView_) {
+            // An edge between two nodes stands for the nets they share.
+            const uint32_t net = layout_->wire_net[w];
+            tip = QString("%1 - %2: %3 nets")
+                      .arg(cellLabel(layout_->pin_cell[layout_->wire_pin0[w]]))
+                      .arg(cellLabel(layout_->pin_cell[layout_->wire_pin1[w]]))
+                      .arg(layout_->netWeight(net));
+            return;
+        }
+        if (!layout_->wire_bundle[w])
+            return;
+        const uint32_t net = layout_->wire_net[w];
+        const uint32_t named = cone_ ? coneNets_[net] : net;
+        tip = QString("%1 (%2 pins)").arg(toQString(design_->netName(named))).arg(layout_->net_offset[net + 1] - layout_->net_offset[net]);
+    });
+    if (tip.isEmpty())
+        QToolTip::hideText();
+    else
+        QToolTip::showText(help->globalPos(), tip, view_->viewport());
+    return true;
+}
+
+void VisualizerWindow::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    scheduleRefresh();
 }
 
 void VisualizerWindow::wheelEvent(QWheelEvent* event) {
+    fitLayout_ = false;
     const double scaleFactor = 1.2;
     if (event->angleDelta().y() > 0)
         view_->scale(scaleFactor, scaleFactor);
     else
         view_->scale(1.0 / scaleFactor, 1.0 / scaleFactor);
+    scheduleRefresh();
 }
 
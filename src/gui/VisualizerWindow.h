@@ -3,33 +3,214 @@
 #include <QWidget>
 #include <QGraphicsView>
 #include <QGraphicsScene>
-#include <QGraphicsRectItem>
-#include <QGraphicsLineItem>
-#include <QMap>
-#include <QList>
+#include <QPointF>
 #include <QString>
-#include <QPair>
+#include <QHash>
+#include <QVector>
 
-class VerilogParser;
+#include <memory>
+#include <vector>
+
+#include "LayoutEngine.h"
+#include "SchematicExport.h"
+#include "SchematicLayout.h"
+
+class DefPlacement;
+class NetlistDb;
+struct NetlistPath;
+class SchematicRegionItem;
+class HierarchyClusters;
+class ClusterView;
+class NetlistCone;
 
 class VisualizerWindow : public QWidget {
     Q_OBJECT
 public:
-    explicit VisualizerWindow(VerilogParser* parser, QWidget* parent = nullptr);
-    void loadGraph(const QMap<QString, QStringList>& pinsByCell,
-                   const QMap<QPair<QString, QString>, QString>& netByPin);
+    explicit VisualizerWindow(QWidget* parent = nullptr);
+    ~VisualizerWindow() override;
+
+    // How the pins of one net are joined. Nets with more pins than the
+    // bundle threshold get a single trunk instead.
+    enum class FlyLineStyle { Star, SpanningTree };
+    void setFlyLineStyle(FlyLineStyle style) { flyLineStyle_ = style; }
+    FlyLineStyle flyLineStyle() const { return flyLineStyle_; }
+    void setBundleThreshold(int pins) { bundleThreshold_ = pins; }
+    int bundleThreshold() const { return bundleThreshold_; }
+
+    // How cells are placed. Changing it lays the loaded design out again.
+    void setLayoutMode(LayoutEngine::Mode mode);
+    LayoutEngine::Mode layoutMode() const { return layoutMode_; }
+
+    // Lays a design snapshot out into flat arrays and indexes them, reading
+    // the database by ID: in the flat view layout cell, pin and net IDs are
+    // the snapshot's. Scene items are only made for the tiles around the
+    // viewport, and names only for the labels drawn. Cells start on a grid; the real
+    // placement runs in the background and replaces it step by step as it
+    // improves. The snapshot is held until the next load.
+    void loadDesign(std::shared_ptr<const NetlistDb> design);
+
+    // Draws the design by its instance hierarchy: each closed cluster is
+    // one box, and the nets between two boxes are one edge, drawn wider the
+    // more nets it stands for. Starts with the top level open. Turning it
+    // off shows every cell again.
+    void setClustered(bool clustered);
+    bool clustered() const { return clustered_; }
+    // Opens a closed cluster where it stands; only its children are laid
+    // out and the rest moves aside to make room. Collapsing closes an open
+    // cluster back into one box.
+    void expandCluster(quint32 cluster);
+    void collapseCluster(quint32 cluster);
+
+    // Draws each cell where a DEF placement of `design` puts it, rows and
+    // all, instead of laying the design out; nothing is placed in the
+    // background. Turning physical off goes back to the schematic. The
+    // placement is dropped when another design is loaded.
+    void showPlacement(std::shared_ptr<const NetlistDb> design, std::shared_ptr<const DefPlacement> placement);
+    void setPhysical(bool physical);
+    bool physical() const { return physical_; }
+
+    // Shows only the cone around a seed, its cells in columns by level:
+    // fanin left of the seed, fanout right of it. The same seed grown
+    // further adds to what is on screen; cells already shown stay put and
+    // the new levels are placed beside them.
+    void showCone(std::shared_ptr<const NetlistDb> design, const NetlistCone& cone);
+    // One more level each way around the cone on screen.
+    void growCone();
+    // Leaves the cone for the whole design, flat or clustered.
+    void showDesign();
+    bool coneShown() const { return cone_ != nullptr; }
+
+    // Shows a get_path result: its pins and nets stand out, the rest is
+    // dimmed, and the view scrolls to where the path starts. A path from
+    // another snapshot is matched by name.
+    void highlightPath(const NetlistDb& db, const NetlistPath& path);
+
+    // Pins are selected by their ID. Each selected pin is drawn
+    // with its net's pins and wires, the rest dimmed. A click selects a
+    // pin, or every pin of a cell; Ctrl-click adds or removes; a click on
+    // empty space clears.
+    void selectPins(const QVector<quint32>& pins, bool add);
+    void clearSelection();
+    // Shows the fanout (or fanin) cone of the selection, up to `levels`
+    // cells deep. Walks the nets only, never the scene.
+    void highlightCone(bool fanout, int levels);
+
+    // Draws what is on screen, as far as it is laid out, into image files.
+    // False with an empty message when nothing is shown.
+    bool writeSchematic(const std::string& file, const SchematicExport::Options& options, std::string& message) const;
+
+    // Approximate bytes held by the scene items, layout and lookup maps.
+    size_t sceneMemoryBytes() const;
 
 protected:
     void wheelEvent(QWheelEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
-    void connectItem(QGraphicsItem* item);
-    void highlightNet(const QString& pinName);
+    // Side of the square detail tiles; heatmap tiles double per level.
+    static constexpr qreal kRegionSize = 8 * SchematicLayout::kDensityBin;
 
-    VerilogParser* parser_;
+    // (Re)starts the layout engine over base_. Each placement it streams
+    // back is turned into a complete layout on the worker and swapped in
+    // on the GUI thread by applyLayout().
+    void startLayout();
+    // Drops the scene and lays the snapshot out from scratch, flat,
+    // physical or clustered.
+    void rebuild();
+    std::shared_ptr<SchematicLayout> flatLayout();
+    // Whether the design is drawn as placed rather than laid out.
+    bool physicalShown() const { return physical_ && placement_ && !cone_; }
+    // One cell per view node (cell c is nodes[c]) centred at `centers`,
+    // or on a grid where missing, and one two-pin net per edge between
+    // them, weighted by the nets the edge stands for.
+    std::shared_ptr<SchematicLayout> clusterLayout(const std::vector<uint32_t>& nodes,
+                                                   const QHash<quint32, QPointF>& centers,
+                                                   std::vector<uint8_t>& pinOutput,
+                                                   QHash<quint64, quint32>& edgeNets) const;
+    // One cell per cone cell (cell c is cone_->cells()[c]) with all its
+    // pins, and the nets among them. Cells `previous` holds too keep their
+    // place on screen.
+    std::shared_ptr<SchematicLayout> coneLayout(const NetlistCone* previous);
+    void selectSeed();
+    // Opens a cone on a snapshot cell, or one of its pins.
+    void showConeAt(quint32 cell, quint32 pin);
+    // The snapshot cell, and pin if any, under a viewport position.
+    bool endpointAt(const QPoint& pos, quint32& cell, quint32& pin) const;
+    // Drops the selection and highlight before the layout changes IDs.
+    void resetHighlight();
+    // Centres of the view nodes on screen.
+    QHash<quint32, QPointF> nodeCenters() const;
+    // Swaps in the current cluster view with the nodes at `centers`.
+    void showClusters(const QHash<quint32, QPointF>& centers);
+    QString cellLabel(quint32 cell) const;
+    void applyLayout(std::shared_ptr<const SchematicLayout> layout);
+    void addNet(quint32 net, QVector<quint32>& pins, QVector<quint32>& wires) const;
+    void showSelection();
+    // Only tiles that hold part of the old or the new highlight change.
+    void setHighlight(const QVector<quint32>& pins, const QVector<quint32>& wires, bool dimmed);
+    // The pin under `pos`, else its cell; false over empty space.
+    bool hitTest(const QPointF& pos, quint32& pin, quint32& cell) const;
+    void handleClick(const QPoint& pos, Qt::KeyboardModifiers modifiers);
+    // The view node under a viewport position in clustered mode.
+    quint32 nodeAt(const QPoint& pos) const;
+
+    // Recycles tiles that left the viewport plus margin and fills the ones
+    // that entered it.
+    void scheduleRefresh();
+    void refreshTiles();
+    void fillTile(SchematicRegionItem* item, quint64 key);
+    void applyHighlight(SchematicRegionItem* item, quint64 key) const;
+    quint64 tileKey(int level, qreal x, qreal y) const;
+    QRectF tileRect(quint64 key) const;
+
+    std::shared_ptr<const NetlistDb> design_;
     QGraphicsView* view_;
     QGraphicsScene* scene_;
-    QMap<QString, QGraphicsRectItem*> pinItems_;
-    QMap<QString, QList<QGraphicsLineItem*>> netLines_;
-};
 
+    // The layout on screen, and the grid placement the engine starts from.
+    // Both are immutable once published; the engine's worker reads base_.
+    std::shared_ptr<const SchematicLayout> layout_;
+    std::shared_ptr<const SchematicLayout> base_;
+    std::vector<uint8_t> pinOutput_;
+
+    LayoutEngine engine_;
+    LayoutEngine::Mode layoutMode_ = LayoutEngine::Mode::ForceDirected;
+    // Placements from an earlier load are dropped on arrival.
+    quint64 loadId_ = 0;
+    // Keep the whole design in view until the user zooms.
+    bool fitLayout_ = true;
+
+    // Tiles on screen by key, and hidden items waiting for reuse.
+    QHash<quint64, SchematicRegionItem*> tiles_;
+    QVector<SchematicRegionItem*> pool_;
+    quint64 generation_ = 0;
+    bool refreshPending_ = false;
+
+    QVector<quint32> selected_;
+    QPoint pressPos_;
+    QVector<quint32> highlightPins_;
+    QVector<quint32> highlightWires_;
+    bool dimmed_ = false;
+
+    // Clustered mode: the tree is built once per snapshot, the view
+    // tracks what is open, and each layout cell is the view node in
+    // viewNodes_. edgeNets_ maps a view edge to the layout net drawing it.
+    bool clustered_ = false;
+    std::shared_ptr<const HierarchyClusters> clusterTree_;
+    std::unique_ptr<ClusterView> clusterView_;
+    std::vector<uint32_t> viewNodes_;
+    QHash<quint64, quint32> edgeNets_;
+
+    // Physical mode: the placement read for design_.
+    bool physical_ = false;
+    std::shared_ptr<const DefPlacement> placement_;
+
+    // Cone mode: the cone on screen, and the snapshot net of each layout
+    // net.
+    std::unique_ptr<NetlistCone> cone_;
+    std::vector<uint32_t> coneNets_;
+
+    FlyLineStyle flyLineStyle_ = FlyLineStyle::SpanningTree;
+    int bundleThreshold_ = 64;
+};
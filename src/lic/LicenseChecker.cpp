@@ -1,47 +1,79 @@
 // File: src/LicenseChecker.cpp
 #include "LicenseChecker.h"
-#include <QFile>
-#include <QTextStream>
-#include <QDateTime>
-#include <QDebug>
-
-bool LicenseChecker::isLicenseValid(const QString& licensePath) {
-    QFile file(licensePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "[LICENSE] Could not open license file.";
-        return false;
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::string trimmed(const std::string& s) {
+    const char* ws = " \t\r\n";
+    size_t b = s.find_first_not_of(ws);
+    if (b == std::string::npos) return "";
+    return s.substr(b, s.find_last_not_of(ws) - b + 1);
+}
+
+// Accepts the ISO 8601 forms written by x.sh: 2025-06-23T09:45:47Z or a bare date.
+bool parseIsoUtc(const std::string& text, std::time_t& out) {
+    std::tm tm{};
+    std::istringstream in(text);
+    in >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    if (in.fail()) {
+        tm = std::tm{};
+        std::istringstream date(text);
+        date >> std::get_time(&tm, "%Y-%m-%d");
+        if (date.fail()) return false;
     }
+    out = timegm(&tm);
+    return out != static_cast<std::time_t>(-1);
+}
 
-    QTextStream in(&file);
-    QString expires;
+std::string formatUtc(std::time_t t) {
+    std::ostringstream out;
+    out << std::put_time(std::gmtime(&t), "%a %b %d %H:%M:%S %Y UTC");
+    return out.str();
+}
+
+}  // namespace
+
+bool LicenseChecker::isLicenseValid(const std::string& licensePath) {
+    std::ifstream file(licensePath);
+    if (!file.is_open()) {
+        std::cerr << "[LICENSE] Could not open license file." << std::endl;
+        return false;
+    }
 
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.startsWith("LICENSE_EXPIRES=")) {
-            expires = line.section('=', 1, 1);
+    std::string line;
+    std::string expires;
+    while (std::getline(file, line)) {
+        line = trimmed(line);
+        if (line.rfind("LICENSE_EXPIRES=", 0) == 0) {
+            expires = line.substr(line.find('=') + 1);
             break;
         }
     }
 
     file.close();
 
-    if (expires.isEmpty()) {
-        qWarning() << "[LICENSE] Expiry not found.";
+    if (expires.empty()) {
+        std::cerr << "[LICENSE] Expiry not found." << std::endl;
         return false;
     }
 
-    QDateTime expiryTime = QDateTime::fromString(expires, Qt::ISODate);
-    if (!expiryTime.isValid()) {
-        qWarning() << "[LICENSE] Invalid date format.";
+    std::time_t expiryTime;
+    if (!parseIsoUtc(expires, expiryTime)) {
+        std::cerr << "[LICENSE] Invalid date format." << std::endl;
         return false;
     }
 
-    QDateTime now = QDateTime::currentDateTimeUtc();
+    std::time_t now = std::time(nullptr);
     if (now > expiryTime) {
-        qWarning() << "[LICENSE] License expired at:" << expiryTime.toString();
+        std::cerr << "[LICENSE] License expired at: " << formatUtc(expiryTime) << std::endl;
         return false;
     }
 
-    qDebug() << "[LICENSE] Valid until:" << expiryTime.toString();
+    std::cerr << "[LICENSE] Valid until: " << formatUtc(expiryTime) << std::endl;
     return true;
 }
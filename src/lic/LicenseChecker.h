@@ -1,8 +1,8 @@
 // File: src/LicenseChecker.h
 #pragma once
-#include <QString>
+#include <string>
 
 class LicenseChecker {
 public:
-    static bool isLicenseValid(const QString& licensePath);
+    static bool isLicenseValid(const std::string& licensePath);
 };
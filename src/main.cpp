@@ -1,17 +1,50 @@
 // File: src/main.cpp
 
-#include <QApplication>
 #include <cstring>
 #include <iostream>
+#include <string>
 
-#include "gui/MainWindow.h"
 #include "lic/LicenseChecker.h"
+#include "tcl/CommandRegistry.h"
+#include "tcl/NetlistCommands.h"
+#include "util/Tracer.h"
 #include <tcl.h>
+
+#ifdef VERILOG_WITH_GUI
+#include <QApplication>
 #include <QMessageBox>
+#include "gui/MainWindow.h"
+#include "gui/SchematicExport.h"
+#endif
 
-void runTerminal() {
+namespace {
+
+// Interpreter with the full netlist command set, for the Qt-free modes.
+Tcl_Interp* createShell(NetlistCommands& commands, CommandRegistry& registry) {
     Tcl_Interp* interp = Tcl_CreateInterp();
     Tcl_Init(interp);
+    commands.registerCommands(registry);
+    registry.install(interp);
+    NetlistCommands::setupShell(interp);
+#ifdef VERILOG_WITH_GUI
+    // Without a window write_schematic draws on the offscreen platform.
+    commands.setSchematicWriter([&commands](const VerilogParser::Snapshot& design,
+                                            const NetlistCommands::SchematicRequest& request, std::string& message) {
+        SchematicExport::ensureApplication();
+        return SchematicExport::writeDesign(*design, commands.pinDirections().resolve(*design),
+                                            SchematicExport::placementOf(request), request.file,
+                                            SchematicExport::optionsOf(request), message);
+    });
+#endif
+    return interp;
+}
+
+}  // namespace
+
+void runTerminal() {
+    NetlistCommands commands;
+    CommandRegistry registry;
+    Tcl_Interp* interp = createShell(commands, registry);
 
     std::cout << "AVINNOVUS Tcl Terminal Mode\n";
     std::string line;
@@ -31,6 +64,27 @@ void runTerminal() {
     Tcl_DeleteInterp(interp);
 }
 
+// Runs a script without Qt or a display; the exit code reports script errors.
+int runBatch(const char* script) {
+    NetlistCommands commands;
+    CommandRegistry registry;
+    Tcl_Interp* interp = createShell(commands, registry);
+
+    ScriptRunner::Options options;
+    options.stop_on_error = true;
+
+    int status = 0;
+    if (commands.scripts().runFile(interp, script, options) != TCL_OK) {
+        const char* info = Tcl_GetVar(interp, "errorInfo", TCL_GLOBAL_ONLY);
+        std::cerr << "Error: " << (info ? info : Tcl_GetStringResult(interp)) << "\n";
+        status = 1;
+    }
+
+    Tcl_DeleteInterp(interp);
+    return status;
+}
+
+#ifdef VERILOG_WITH_GUI
 void runGUI(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
@@ -43,28 +97,46 @@ void runGUI(int argc, char *argv[]) {
     w.show();
     app.exec();
 }
+#endif
 
 int main(int argc, char *argv[]) {
+    Tracer::instance().setThreadName("main");
+
     if (!LicenseChecker::isLicenseValid("license.txt")) {
         std::cerr << "[LICENSE] Invalid or expired. Exiting.\n";
         return 1;
     }
 
     if (argc > 1) {
-        if (std::strcmp(argv[1], "-gui") == 0) {
-            runGUI(argc, argv);
-            return 0;
+        if (std::strcmp(argv[1], "-batch") == 0) {
+            if (argc < 3) {
+                std::cerr << "Usage: ./verilog -batch <script.tcl>\n";
+                return 1;
+            }
+            return runBatch(argv[2]);
         } else if (std::strcmp(argv[1], "-terminal") == 0) {
             runTerminal();
             return 0;
+#ifdef VERILOG_WITH_GUI
+        } else if (std::strcmp(argv[1], "-gui") == 0) {
+            runGUI(argc, argv);
+            return 0;
+#endif
         } else {
             std::cerr << "Unknown mode: " << argv[1] << "\n";
-            std::cerr << "Usage: ./verilog -gui | -terminal\n";
+#ifdef VERILOG_WITH_GUI
+            std::cerr << "Usage: ./verilog -gui | -terminal | -batch <script.tcl>\n";
+#else
+            std::cerr << "Usage: ./verilog -terminal | -batch <script.tcl>\n";
+#endif
             return 1;
         }
     }
 
+#ifdef VERILOG_WITH_GUI
     runGUI(argc, argv);
+#else
+    runTerminal();
+#endif
     return 0;
 }
-
@@ -0,0 +1,19 @@
+// File: src/tcl/CommandRegistry.cpp
+
+#include "CommandRegistry.h"
+
+void CommandRegistry::add(const std::string& name, const std::string& args,
+                          Tcl_CmdProc* proc, ClientData data) {
+    for (auto& cmd : commands_) {
+        if (cmd.name == name) {
+            cmd = {name, args, proc, data};
+            return;
+        }
+    }
+    commands_.push_back({name, args, proc, data});
+}
+
+void CommandRegistry::install(Tcl_Interp* interp) const {
+    for (const auto& cmd : commands_)
+        Tcl_CreateCommand(interp, cmd.name.c_str(), cmd.proc, cmd.data, nullptr);
+}
@@ -0,0 +1,27 @@
+// File: src/tcl/CommandRegistry.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <tcl.h>
+
+// The set of Tcl commands a shell exposes. The GUI console, the terminal and
+// batch mode all install from a registry, so they see the same commands, and
+// the GUI uses the argument hints for autocomplete.
+class CommandRegistry {
+public:
+    struct Command {
+        std::string name;
+        std::string args;  // e.g. "<cell> <pin>", shown by autocomplete
+        Tcl_CmdProc* proc;
+        ClientData data;
+    };
+
+    void add(const std::string& name, const std::string& args, Tcl_CmdProc* proc, ClientData data);
+    void install(Tcl_Interp* interp) const;
+
+    const std::vector<Command>& commands() const { return commands_; }
+
+private:
+    std::vector<Command> commands_;
+};
@@ -0,0 +1,712 @@
+// File: src/tcl/NetlistCommands.cpp
+
+#include "NetlistCommands.h"
+#include "util/ThreadPool.h"
+#include "verilog_parser/NetlistCheck.h"
+#include "verilog_parser/NetlistComponents.h"
+#include "verilog_parser/NetlistDiff.h"
+#include "verilog_parser/NetlistPartitioner.h"
+#include "verilog_parser/NetlistWriter.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+void setResult(Tcl_Interp* interp, const std::string& text) {
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(text.c_str(), static_cast<int>(text.size())));
+}
+
+// Builds the result straight from the database views, one line per name.
+void setResultLines(Tcl_Interp* interp, const NameRange& names) {
+    Tcl_Obj* result = Tcl_NewObj();
+    for (std::string_view n : names) {
+        Tcl_AppendToObj(result, n.data(), static_cast<int>(n.size()));
+        Tcl_AppendToObj(result, "\n", 1);
+    }
+    Tcl_SetObjResult(interp, result);
+}
+
+}  // namespace
+
+NetlistCommands::NetlistCommands()
+    : scripts_([this](const std::string& msg) { print(msg); }) {
+    output_ = [](const std::string& msg) { std::cout << msg << std::endl; };
+    ThreadPool::instance().resize(thread_count_);
+}
+
+void NetlistCommands::print(const std::string& msg) const {
+    if (output_) output_(msg);
+}
+
+void NetlistCommands::registerCommands(CommandRegistry& registry) {
+    registry.add("print", "<message>", tcl_print, this);
+    registry.add("get_ports", "", tcl_get_ports, this);
+    registry.add("get_cells", "[-within {x1 y1 x2 y2}]", tcl_get_cells, this);
+    registry.add("get_nets", "", tcl_get_nets, this);
+    registry.add("get_pins", "<cell>", tcl_get_pins, this);
+    registry.add("get_net_for_pin", "<cell> <pin>", tcl_get_net_for_pin, this);
+    registry.add("get_path", "-from <pin|cell|net> -to <pin|cell|net> [-directed] [-max_fanout <n>]", tcl_get_path,
+                 this);
+    registry.add("show_cone",
+                 "-from <pin|cell|net> [-levels <n>] [-fanin <n>] [-fanout <n>] [-max_fanout <n>] [-max_cells <n>]",
+                 tcl_show_cone, this);
+    registry.add("load_verilog", "[-background] <filename>", tcl_load_verilog, this);
+    registry.add("wait_for_load", "", tcl_wait_for_load, this);
+    registry.add("read_def", "<filename>", tcl_read_def, this);
+    registry.add("write_verilog", "<filename>", tcl_write_verilog, this);
+    registry.add("write_schematic",
+                 "-format <png|svg> [-tile <n>] [-size <pixels>] [-layout <grid|layered|force>] <file>",
+                 tcl_write_schematic, this);
+    registry.add("compare_netlists", "[-max <n>] <fileA> <fileB>", tcl_compare_netlists, this);
+    registry.add("check_netlist", "[-max <n>]", tcl_check_netlist, this);
+    registry.add("report_connectivity_components", "[-max <n>] [-max_fanout <n>]",
+                 tcl_report_connectivity_components, this);
+    registry.add("partition_netlist", "-parts <n> [-imbalance <fraction>] [-max_fanout <n>] [-file <path>]",
+                 tcl_partition_netlist, this);
+    registry.add("set_pin_direction", "<master> <pin> <input|output|inout>", tcl_set_pin_direction, this);
+    registry.add("set_multi_cpu", "<int>", tcl_set_multi_cpu, this);
+    registry.add("report_parse_stats", "[-json] [-file <path>]", tcl_report_parse_stats, this);
+    registry.add("set_parse_stats", "<on|off>", tcl_set_parse_stats, this);
+    registry.add("report_memory", "", tcl_report_memory, this);
+    registry.add("write_trace", "[-clear] <file.json>", tcl_write_trace, this);
+    registry.add("set_trace", "<on|off>", tcl_set_trace, this);
+    scripts_.registerCommands(registry);
+}
+
+void NetlistCommands::setupShell(Tcl_Interp* interp) {
+    Tcl_Eval(interp, R"(
+        rename puts tcl_puts
+        proc puts {args} {
+            eval print $args
+        }
+    )");
+}
+
+int NetlistCommands::tcl_print(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    std::string msg;
+    for (int i = 1; i < argc; ++i) {
+        msg += argv[i];
+        if (i < argc - 1)
+            msg += " ";
+    }
+    self->print(msg);
+    setResult(interp, msg);
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_ports(ClientData clientData, Tcl_Interp* interp, int, const char**) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    setResultLines(interp, self->parser_.snapshot()->portNames());
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_cells(ClientData clientData, Tcl_Interp* interp, int argc, const char** argv) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    VerilogParser::Snapshot design = self->parser_.snapshot();
+    if (argc == 1) {
+        setResultLines(interp, design->cellNames());
+        return TCL_OK;
+    }
+
+    // -within {x1 y1 x2 y2}: placed cells in a region, in microns.
+    int count = 0;
+    const char** corners = nullptr;
+    double v[4];
+    bool ok = argc == 3 && std::strcmp(argv[1], "-within") == 0 &&
+              Tcl_SplitList(interp, argv[2], &count, &corners) == TCL_OK;
+    ok = ok && count == 4;
+    for (int i = 0; ok && i < 4; ++i) ok = Tcl_GetDouble(interp, corners[i], &v[i]) == TCL_OK;
+    if (corners) Tcl_Free(reinterpret_cast<char*>(corners));
+    if (!ok) {
+        setResult(interp, "Usage: get_cells [-within {x1 y1 x2 y2}]");
+        return TCL_ERROR;
+    }
+    std::shared_ptr<const DefPlacement> placement = self->placement(design);
+    if (!placement) {
+        setResult(interp, "No placement for the current design; use read_def");
+        return TCL_ERROR;
+    }
+    const double dbu = placement->dbuPerMicron();
+    DefPlacement::Rect area{std::llround(std::min(v[0], v[2]) * dbu), std::llround(std::min(v[1], v[3]) * dbu),
+                            std::llround(std::max(v[0], v[2]) * dbu), std::llround(std::max(v[1], v[3]) * dbu)};
+    std::vector<NetlistDb::Id> cells;
+    placement->within(area, [&](NetlistDb::Id cell) { cells.push_back(cell); });
+    std::sort(cells.begin(), cells.end());
+
+    Tcl_Obj* result = Tcl_NewObj();
+    for (NetlistDb::Id cell : cells) {
+        std::string_view n = design->cellName(cell);
+        Tcl_AppendToObj(result, n.data(), static_cast<int>(n.size()));
+        Tcl_AppendToObj(result, "\n", 1);
+    }
+    Tcl_SetObjResult(interp, result);
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_nets(ClientData clientData, Tcl_Interp* interp, int, const char**) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    setResultLines(interp, self->parser_.snapshot()->wireNames());
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_pins(ClientData clientData, Tcl_Interp* interp, int argc, const char** argv) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    if (argc < 2) {
+        setResult(interp, "Usage: get_pins <cell>");
+        return TCL_ERROR;
+    }
+    setResultLines(interp, self->parser_.snapshot()->pinNamesOf(argv[1]));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_net_for_pin(ClientData clientData, Tcl_Interp* interp, int argc, const char** argv) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    if (argc < 3) {
+        setResult(interp, "Usage: get_net_for_pin <cell> <pin>");
+        return TCL_ERROR;
+    }
+    VerilogParser::Snapshot design = self->parser_.snapshot();
+    std::string_view net = design->netOfPin(argv[1], argv[2]);
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(net.data(), static_cast<int>(net.size())));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_get_path(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    const char* from = nullptr;
+    const char* to = nullptr;
+    bool directed = false;
+    NetlistPath::Options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i) {
+        if (std::strcmp(argv[i], "-from") == 0 && i + 1 < argc)
+            from = argv[++i];
+        else if (std::strcmp(argv[i], "-to") == 0 && i + 1 < argc)
+            to = argv[++i];
+        else if (std::strcmp(argv[i], "-directed") == 0)
+            directed = true;
+        else if (std::strcmp(argv[i], "-max_fanout") == 0 && i + 1 < argc)
+            options.max_fanout = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else
+            usage = true;
+    }
+    if (usage || !from || !to) {
+        setResult(interp, "Usage: get_path -from <pin|cell|net> -to <pin|cell|net> [-directed] [-max_fanout <n>]");
+        return TCL_ERROR;
+    }
+
+    VerilogParser::Snapshot db = self->parser_.snapshot();
+    NetlistPath::Endpoint a, b;
+    for (auto [name, endpoint] : {std::make_pair(from, &a), std::make_pair(to, &b)}) {
+        if (!NetlistPath::resolve(*db, name, *endpoint)) {
+            setResult(interp, std::string("No cell, pin or net named ") + name);
+            return TCL_ERROR;
+        }
+    }
+    PinDirections::Table directions;
+    if (directed) {
+        directions = self->pin_directions_.resolve(*db);
+        options.directions = &directions;
+    }
+
+    NetlistPath path = NetlistPath::find(*db, a, b, options);
+    std::string report = path.toText(*db);
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+    if (path.found() && self->path_view_) self->path_view_(db, path);
+
+    // The path as a list of cell and net names, in order.
+    Tcl_Obj* result = Tcl_NewListObj(0, nullptr);
+    for (const NetlistPath::Step& step : path.steps) {
+        std::string_view name = step.kind == NetlistPath::Kind::Cell ? db->cellName(step.id) : db->netName(step.id);
+        Tcl_ListObjAppendElement(interp, result, Tcl_NewStringObj(name.data(), static_cast<int>(name.size())));
+    }
+    Tcl_SetObjResult(interp, result);
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_show_cone(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    const char* from = nullptr;
+    int fanin = 2;
+    int fanout = 2;
+    NetlistCone::Options options;
+    options.max_cells = 10000;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i) {
+        if (std::strcmp(argv[i], "-from") == 0 && i + 1 < argc)
+            from = argv[++i];
+        else if (std::strcmp(argv[i], "-levels") == 0 && i + 1 < argc)
+            fanin = fanout = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-fanin") == 0 && i + 1 < argc)
+            fanin = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-fanout") == 0 && i + 1 < argc)
+            fanout = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-max_fanout") == 0 && i + 1 < argc)
+            options.max_fanout = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "-max_cells") == 0 && i + 1 < argc)
+            options.max_cells = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else
+            usage = true;
+    }
+    if (usage || !from) {
+        setResult(interp, "Usage: show_cone -from <pin|cell|net> [-levels <n>] [-fanin <n>] [-fanout <n>] "
+                          "[-max_fanout <n>] [-max_cells <n>]");
+        return TCL_ERROR;
+    }
+
+    VerilogParser::Snapshot db = self->parser_.snapshot();
+    NetlistPath::Endpoint seed;
+    if (!NetlistPath::resolve(*db, from, seed)) {
+        setResult(interp, std::string("No cell, pin or net named ") + from);
+        return TCL_ERROR;
+    }
+    NetlistCone cone(*db, seed, self->pin_directions_.resolve(*db), options);
+    cone.grow(*db, fanin, fanout);
+    std::string report = cone.toText(*db);
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+    if (self->cone_view_) self->cone_view_(db, cone);
+
+    // The cone's instances in the order reached.
+    Tcl_Obj* result = Tcl_NewListObj(0, nullptr);
+    for (NetlistDb::Id cell : cone.cells()) {
+        std::string_view name = db->cellName(cell);
+        Tcl_ListObjAppendElement(interp, result, Tcl_NewStringObj(name.data(), static_cast<int>(name.size())));
+    }
+    Tcl_SetObjResult(interp, result);
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_load_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    bool background = argc == 3 && std::strcmp(argv[1], "-background") == 0;
+    if (argc != 2 && !background) {
+        setResult(interp, "Usage: load_verilog [-background] <filename>");
+        return TCL_ERROR;
+    }
+    // Queries keep answering from the current design until the new one is
+    // published.
+    if (background) {
+        self->parser_.parseFileAsync(argv[2], self->thread_count_);
+        setResult(interp, "STARTED");
+        return TCL_OK;
+    }
+    self->parser_.waitForLoad();
+    bool ok = self->parser_.parseFileMultithreaded(argv[1], self->thread_count_);
+    setResult(interp, ok ? "OK" : "FAILED");
+    return TCL_OK;
+}
+
+std::shared_ptr<const DefPlacement> NetlistCommands::placement(const VerilogParser::Snapshot& design) const {
+    return placement_ && placement_design_.lock() == design ? placement_ : nullptr;
+}
+
+int NetlistCommands::tcl_read_def(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    if (argc != 2) {
+        setResult(interp, "Usage: read_def <filename>");
+        return TCL_ERROR;
+    }
+    // Components are matched against the newest design.
+    self->parser_.waitForLoad();
+    VerilogParser::Snapshot design = self->parser_.snapshot();
+    if (design->cellCount() == 0) {
+        setResult(interp, "No design loaded; load the netlist before its placement");
+        return TCL_ERROR;
+    }
+    auto placement = std::make_shared<DefPlacement>();
+    std::string error;
+    if (!placement->read(argv[1], *design, error)) {
+        setResult(interp, error);
+        return TCL_ERROR;
+    }
+    self->placement_ = placement;
+    self->placement_design_ = design;
+
+    const DefPlacement::Stats& stats = placement->stats();
+    const DefPlacement::Rect& die = placement->dieArea();
+    const double dbu = placement->dbuPerMicron();
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "[INFO] Read %s: %zu components, %zu of %zu cells placed, %zu pins, die %.3f x %.3f um in %.3f s",
+                  argv[1], stats.components, placement->placedCount(), design->cellCount(), placement->pins().size(),
+                  (die.x1 - die.x0) / dbu, (die.y1 - die.y0) / dbu, stats.seconds);
+    std::string report = buf;
+    if (stats.unmatched > 0) {
+        report += "\n[INFO] " + std::to_string(stats.unmatched) + " components name no netlist cell:";
+        for (const std::string& name : stats.unmatched_names) report += " " + name;
+        if (stats.unmatched > stats.unmatched_names.size()) report += " ...";
+    }
+    self->print(report);
+    if (self->placement_view_) self->placement_view_(design, placement);
+    setResult(interp, "OK");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_write_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    if (argc != 2) {
+        setResult(interp, "Usage: write_verilog <filename>");
+        return TCL_ERROR;
+    }
+    VerilogParser::Snapshot design = self->parser_.snapshot();
+    NetlistWriter writer(*design, self->thread_count_);
+    auto start = std::chrono::steady_clock::now();
+    if (!writer.write(argv[1])) {
+        setResult(interp, std::string("Cannot write ") + argv[1]);
+        return TCL_ERROR;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mb = writer.bytesWritten() / 1048576.0;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "[INFO] Wrote %s: %zu instances, %.1f MB in %.3f s (%.1f MB/s)", argv[1],
+                  design->cellCount(), mb, seconds, seconds > 0 ? mb / seconds : 0.0);
+    self->print(buf);
+    setResult(interp, "OK");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_write_schematic(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    SchematicRequest request;
+    request.format = "png";
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i) {
+        if (std::strcmp(argv[i], "-format") == 0 && i + 1 < argc)
+            request.format = argv[++i];
+        else if (std::strcmp(argv[i], "-tile") == 0 && i + 1 < argc)
+            request.tile = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+            request.size = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-layout") == 0 && i + 1 < argc)
+            request.layout = argv[++i];
+        else if (argv[i][0] != '-' && request.file.empty())
+            request.file = argv[i];
+        else
+            usage = true;
+    }
+    if (request.format != "png" && request.format != "svg") usage = true;
+    if (!request.layout.empty() && request.layout != "grid" && request.layout != "layered" &&
+        request.layout != "force")
+        usage = true;
+    if (usage || request.file.empty()) {
+        setResult(interp, "Usage: write_schematic -format <png|svg> [-tile <n>] [-size <pixels>] "
+                          "[-layout <grid|layered|force>] <file>");
+        return TCL_ERROR;
+    }
+    if (!self->schematic_writer_) {
+        setResult(interp, "write_schematic needs a build with Qt");
+        return TCL_ERROR;
+    }
+
+    VerilogParser::Snapshot design = self->parser_.snapshot();
+    if (design->cellCount() == 0) {
+        setResult(interp, "No design loaded");
+        return TCL_ERROR;
+    }
+    std::string message;
+    if (!self->schematic_writer_(design, request, message)) {
+        setResult(interp, message);
+        return TCL_ERROR;
+    }
+    self->print(message);
+    setResult(interp, "OK");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_compare_netlists(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    int max_items = 20;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-max") == 0 && i + 1 < argc)
+            max_items = std::max(0, std::atoi(argv[++i]));
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.size() != 2) {
+        setResult(interp, "Usage: compare_netlists [-max <n>] <fileA> <fileB>");
+        return TCL_ERROR;
+    }
+
+    // Both designs load side by side and never touch the current one.
+    VerilogParser a, b;
+    a.set_stats_enabled(false);
+    b.set_stats_enabled(false);
+    a.parseFileAsync(files[0], self->thread_count_);
+    bool ok_b = b.parseFileMultithreaded(files[1], self->thread_count_);
+    bool ok_a = a.waitForLoad();
+    if (!ok_a || !ok_b) {
+        setResult(interp, std::string("Cannot load ") + (ok_a ? files[1] : files[0]));
+        return TCL_ERROR;
+    }
+
+    VerilogParser::Snapshot da = a.snapshot(), db = b.snapshot();
+    NetlistDiff diff = NetlistDiff::compare(*da, *db, self->thread_count_);
+    std::string report = diff.toText(*da, *db, static_cast<size_t>(max_items));
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+
+    setResult(interp, "added_instances " + std::to_string(diff.added_cells.size()) +
+                      " removed_instances " + std::to_string(diff.removed_cells.size()) +
+                      " rewired_instances " + std::to_string(diff.rewired_cells.size()) +
+                      " added_nets " + std::to_string(diff.added_nets.size()) +
+                      " removed_nets " + std::to_string(diff.removed_nets.size()) +
+                      " rewired_nets " + std::to_string(diff.rewired_nets.size()));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_check_netlist(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    int max_items = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-max") == 0 && i + 1 < argc) {
+            max_items = std::max(0, std::atoi(argv[++i]));
+        } else {
+            setResult(interp, "Usage: check_netlist [-max <n>]");
+            return TCL_ERROR;
+        }
+    }
+
+    VerilogParser::Snapshot db = self->parser_.snapshot();
+    NetlistCheck check = NetlistCheck::run(*db, self->pin_directions_);
+    std::string report = check.toText(*db, static_cast<size_t>(max_items));
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+
+    setResult(interp, "undriven " + std::to_string(check.undriven_nets.size()) +
+                      " multidriven " + std::to_string(check.multidriven_nets.size()) +
+                      " unloaded " + std::to_string(check.unloaded_nets.size()) +
+                      " unused_wires " + std::to_string(check.unused_wires.size()) +
+                      " unconnected_pins " + std::to_string(check.unconnected_pins.size()));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_report_connectivity_components(ClientData clientData, Tcl_Interp* interp, int argc,
+                                                        const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    int max_items = 10;
+    int max_fanout = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-max") == 0 && i + 1 < argc) {
+            max_items = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "-max_fanout") == 0 && i + 1 < argc) {
+            max_fanout = std::max(0, std::atoi(argv[++i]));
+        } else {
+            setResult(interp, "Usage: report_connectivity_components [-max <n>] [-max_fanout <n>]");
+            return TCL_ERROR;
+        }
+    }
+
+    VerilogParser::Snapshot db = self->parser_.snapshot();
+    NetlistComponents components = NetlistComponents::compute(*db, static_cast<size_t>(max_fanout));
+    std::string report = components.toText(*db, static_cast<size_t>(max_items));
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+    setResult(interp, std::to_string(components.count()));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_partition_netlist(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    int parts = 0;
+    int max_fanout = 1000;
+    double imbalance = 0.03;
+    const char* file = nullptr;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; ++i) {
+        if (std::strcmp(argv[i], "-parts") == 0 && i + 1 < argc)
+            parts = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-imbalance") == 0 && i + 1 < argc)
+            imbalance = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "-max_fanout") == 0 && i + 1 < argc)
+            max_fanout = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-file") == 0 && i + 1 < argc)
+            file = argv[++i];
+        else
+            usage = true;
+    }
+    if (usage || parts < 1 || imbalance < 0) {
+        setResult(interp, "Usage: partition_netlist -parts <n> [-imbalance <fraction>] [-max_fanout <n>] [-file <path>]");
+        return TCL_ERROR;
+    }
+
+    VerilogParser::Snapshot db = self->parser_.snapshot();
+    if (static_cast<size_t>(parts) > db->cellCount()) {
+        setResult(interp, "Cannot split " + std::to_string(db->cellCount()) + " instances into " +
+                          std::to_string(parts) + " parts");
+        return TCL_ERROR;
+    }
+    NetlistPartition partition = NetlistPartition::compute(*db, parts, imbalance, static_cast<size_t>(max_fanout));
+    std::string report = partition.toText();
+    if (!report.empty() && report.back() == '\n') report.pop_back();
+    self->print(report);
+    if (file) {
+        if (!partition.write(*db, file)) {
+            setResult(interp, std::string("Cannot write ") + file);
+            return TCL_ERROR;
+        }
+        self->print(std::string("[INFO] Wrote instance partition to ") + file);
+    }
+
+    setResult(interp, "cut_nets " + std::to_string(partition.cut_nets) +
+                      " connectivity " + std::to_string(partition.connectivity));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_set_pin_direction(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    PortDirection direction = PortDirection::Unknown;
+    if (argc == 4) {
+        if (std::strcmp(argv[3], "input") == 0) direction = PortDirection::Input;
+        else if (std::strcmp(argv[3], "output") == 0) direction = PortDirection::Output;
+        else if (std::strcmp(argv[3], "inout") == 0) direction = PortDirection::Inout;
+    }
+    if (direction == PortDirection::Unknown) {
+        setResult(interp, "Usage: set_pin_direction <master> <pin> <input|output|inout>");
+        return TCL_ERROR;
+    }
+    self->pin_directions_.set(argv[1], argv[2], direction);
+    setResult(interp, "OK");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_wait_for_load(ClientData clientData, Tcl_Interp* interp, int, const char**) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    setResult(interp, self->parser_.waitForLoad() ? "OK" : "FAILED");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_set_multi_cpu(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    if (argc < 2) {
+        setResult(interp, "Usage: set_multi_cpu <int>");
+        return TCL_ERROR;
+    }
+    self->thread_count_ = std::max(1, std::atoi(argv[1]));
+    self->parser_.waitForLoad();  // don't restart the pool under a running load
+    ThreadPool::instance().resize(self->thread_count_);
+    setResult(interp, "Multi-core parsing set to " + std::to_string(self->thread_count_));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_report_parse_stats(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    bool json = false;
+    const char* file = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "-file") == 0 && i + 1 < argc) {
+            file = argv[++i];
+        } else {
+            setResult(interp, "Usage: report_parse_stats [-json] [-file <path>]");
+            return TCL_ERROR;
+        }
+    }
+
+    const ParseStats stats = self->parser_.get_parse_stats();
+    std::string report = json ? stats.toJson() + "\n" : stats.toText();
+    if (file) {
+        std::ofstream out(file, std::ios::binary);
+        if (!out) {
+            setResult(interp, std::string("Cannot write ") + file);
+            return TCL_ERROR;
+        }
+        out << report;
+    } else {
+        if (!report.empty() && report.back() == '\n') report.pop_back();
+        self->print(report);
+    }
+    setResult(interp, json ? stats.toJson() : "");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_set_parse_stats(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    int enabled = 0;
+    if (argc < 2 || Tcl_GetBoolean(interp, argv[1], &enabled) != TCL_OK) {
+        setResult(interp, "Usage: set_parse_stats <on|off>");
+        return TCL_ERROR;
+    }
+    self->parser_.set_stats_enabled(enabled != 0);
+    setResult(interp, std::string("Parse statistics ") + (enabled ? "on" : "off"));
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_report_memory(ClientData clientData, Tcl_Interp* interp, int, const char**) {
+    auto* self = static_cast<NetlistCommands*>(clientData);
+    const MemoryUsage db = self->parser_.get_memory_usage();
+    const size_t scene = self->scene_memory_ ? self->scene_memory_() : 0;
+    const size_t placement = self->placement_ ? self->placement_->memoryBytes() : 0;
+
+    const std::pair<const char*, size_t> rows[] = {
+        {"names", db.names},
+        {"connectivity", db.connectivity},
+        {"indexes", db.indexes},
+        {"placement", placement},
+        {"GUI scene", scene},
+        {"total", db.names + db.connectivity + db.indexes + placement + scene},
+    };
+    std::string report = "Memory usage\n";
+    char buf[128];
+    for (const auto& row : rows) {
+        std::snprintf(buf, sizeof(buf), "  %-14s %12.2f MB\n", row.first, row.second / 1048576.0);
+        report += buf;
+    }
+    std::snprintf(buf, sizeof(buf), "  %-14s %12.2f MB (peak %.2f MB)", "process RSS", currentRssKb() / 1024.0,
+                  peakRssKb() / 1024.0);
+    report += buf;
+    self->print(report);
+    setResult(interp, "");
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_write_trace(ClientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    bool clear = false;
+    const char* file = nullptr;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-clear") == 0) {
+            clear = true;
+        } else {
+            file = argv[i];
+            ++positional;
+        }
+    }
+    if (positional != 1) {
+        setResult(interp, "Usage: write_trace [-clear] <file.json>");
+        return TCL_ERROR;
+    }
+
+    Tracer& tracer = Tracer::instance();
+    const size_t events = tracer.eventCount();
+    if (!tracer.writeChromeTrace(file)) {
+        setResult(interp, std::string("Cannot write ") + file);
+        return TCL_ERROR;
+    }
+    if (clear) tracer.clear();
+    setResult(interp, "Wrote " + std::to_string(events) + " trace events to " + file);
+    return TCL_OK;
+}
+
+int NetlistCommands::tcl_set_trace(ClientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    int enabled = 0;
+    if (argc < 2 || Tcl_GetBoolean(interp, argv[1], &enabled) != TCL_OK) {
+        setResult(interp, "Usage: set_trace <on|off>");
+        return TCL_ERROR;
+    }
+    Tracer::instance().setEnabled(enabled != 0);
+    setResult(interp, std::string("Tracing ") + (enabled ? "on" : "off"));
+    return TCL_OK;
+}
@@ -0,0 +1,110 @@
+// File: src/tcl/NetlistCommands.h
+#pragma once
+
+#include "CommandRegistry.h"
+#include "ScriptRunner.h"
+#include "verilog_parser/DefPlacement.h"
+#include "verilog_parser/NetlistCone.h"
+#include "verilog_parser/NetlistPath.h"
+#include "verilog_parser/PinDirections.h"
+#include "verilog_parser/VerilogParser.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <tcl.h>
+
+// Netlist commands shared by every shell: the GUI console, the terminal and
+// batch mode. Owns the loaded design; where `print`/`puts` output goes is
+// up to the front end.
+class NetlistCommands {
+public:
+    using OutputFn = std::function<void(const std::string&)>;
+    using MemoryFn = std::function<size_t()>;
+    using PathFn = std::function<void(const VerilogParser::Snapshot&, const NetlistPath&)>;
+    using ConeFn = std::function<void(const VerilogParser::Snapshot&, const NetlistCone&)>;
+    using PlacementFn = std::function<void(const VerilogParser::Snapshot&, std::shared_ptr<const DefPlacement>)>;
+
+    // What write_schematic asked for. An empty layout draws what the
+    // front end shows, or the design laid out layered when it shows none.
+    struct SchematicRequest {
+        std::string file;
+        std::string format;  // png or svg
+        std::string layout;  // grid, layered, force or empty
+        int tile = 0;        // pixels per tile file; 0 writes one file
+        int size = 4096;     // pixels along the longer side
+    };
+    using SchematicFn =
+        std::function<bool(const VerilogParser::Snapshot&, const SchematicRequest&, std::string& message)>;
+
+    NetlistCommands();
+
+    void registerCommands(CommandRegistry& registry);
+
+    // Routes puts through print.
+    static void setupShell(Tcl_Interp* interp);
+
+    void setOutput(OutputFn output) { output_ = std::move(output); }
+    void print(const std::string& msg) const;
+
+    // Front ends with a schematic view report its footprint here so that
+    // report_memory can show it next to the database.
+    void setSceneMemory(MemoryFn scene_memory) { scene_memory_ = std::move(scene_memory); }
+    // ... and can highlight the paths get_path finds.
+    void setPathView(PathFn path_view) { path_view_ = std::move(path_view); }
+    // ... and draw the cones show_cone extracts.
+    void setConeView(ConeFn cone_view) { cone_view_ = std::move(cone_view); }
+    // ... and show the placement read_def reads.
+    void setPlacementView(PlacementFn placement_view) { placement_view_ = std::move(placement_view); }
+    // Front ends linked with Qt draw the schematic for write_schematic.
+    void setSchematicWriter(SchematicFn schematic_writer) { schematic_writer_ = std::move(schematic_writer); }
+
+    VerilogParser& parser() { return parser_; }
+    const VerilogParser& parser() const { return parser_; }
+    int threadCount() const { return thread_count_; }
+    const PinDirections& pinDirections() const { return pin_directions_; }
+    ScriptRunner& scripts() { return scripts_; }
+    // The placement read_def read against `design`; null when there is
+    // none or it belongs to a design loaded before.
+    std::shared_ptr<const DefPlacement> placement(const VerilogParser::Snapshot& design) const;
+
+private:
+    static int tcl_print(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_ports(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_cells(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_nets(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_pins(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_net_for_pin(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_get_path(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_show_cone(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_load_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_read_def(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_write_verilog(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_write_schematic(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_compare_netlists(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_check_netlist(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_report_connectivity_components(ClientData clientData, Tcl_Interp* interp, int argc,
+                                                  const char* argv[]);
+    static int tcl_partition_netlist(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_set_pin_direction(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_wait_for_load(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_set_multi_cpu(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_report_parse_stats(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_set_parse_stats(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_report_memory(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_write_trace(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_set_trace(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+
+    VerilogParser parser_;
+    PinDirections pin_directions_;
+    int thread_count_ = 4;
+    OutputFn output_;
+    MemoryFn scene_memory_;
+    PathFn path_view_;
+    ConeFn cone_view_;
+    SchematicFn schematic_writer_;
+    PlacementFn placement_view_;
+    std::shared_ptr<const DefPlacement> placement_;
+    std::weak_ptr<const NetlistDb> placement_design_;
+    ScriptRunner scripts_;
+};
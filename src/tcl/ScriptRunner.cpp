@@ -0,0 +1,256 @@
+// File: src/tcl/ScriptRunner.cpp
+
+#include "ScriptRunner.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace {
+
+bool isBlank(const std::string& s) {
+    return s.find_first_not_of(" \t\r\n") == std::string::npos;
+}
+
+// First line of a command, trimmed to a readable length for reports.
+std::string summarize(const std::string& command) {
+    size_t b = command.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = command.find('\n', b);
+    std::string s = command.substr(b, e == std::string::npos ? std::string::npos : e - b);
+    if (e != std::string::npos && e + 1 < command.size() && !isBlank(command.substr(e))) s += " ...";
+    if (s.size() > 80) s = s.substr(0, 77) + "...";
+    return s;
+}
+
+std::string commandName(const std::string& summary) {
+    size_t e = summary.find_first_of(" \t");
+    return summary.substr(0, e);
+}
+
+// Sets [info script] for the duration of a file and restores it afterwards.
+class InfoScriptScope {
+public:
+    InfoScriptScope(Tcl_Interp* interp, const std::string& path) : interp_(interp) {
+        Tcl_Obj* get[] = {Tcl_NewStringObj("info", -1), Tcl_NewStringObj("script", -1)};
+        for (auto* o : get) Tcl_IncrRefCount(o);
+        if (Tcl_EvalObjv(interp_, 2, get, 0) == TCL_OK)
+            previous_ = Tcl_GetStringResult(interp_);
+        for (auto* o : get) Tcl_DecrRefCount(o);
+        set(path);
+        Tcl_ResetResult(interp_);
+    }
+    ~InfoScriptScope() {
+        Tcl_Obj* result = Tcl_GetObjResult(interp_);
+        Tcl_IncrRefCount(result);
+        set(previous_);
+        Tcl_SetObjResult(interp_, result);
+        Tcl_DecrRefCount(result);
+    }
+
+private:
+    void set(const std::string& path) {
+        Tcl_Obj* cmd[] = {Tcl_NewStringObj("info", -1), Tcl_NewStringObj("script", -1),
+                          Tcl_NewStringObj(path.c_str(), static_cast<int>(path.size()))};
+        for (auto* o : cmd) Tcl_IncrRefCount(o);
+        Tcl_EvalObjv(interp_, 3, cmd, 0);
+        for (auto* o : cmd) Tcl_DecrRefCount(o);
+    }
+
+    Tcl_Interp* interp_;
+    std::string previous_;
+};
+
+}  // namespace
+
+ScriptRunner::ScriptRunner(OutputFn output) : output_(std::move(output)) {}
+
+void ScriptRunner::registerCommands(CommandRegistry& registry) {
+    registry.add("source", "[-e] [-v] <filename>", tcl_source, this);
+    registry.add("report_source_profile", "[-top <n>] [-reset]", tcl_report_source_profile, this);
+}
+
+int ScriptRunner::runFile(Tcl_Interp* interp, const std::string& path, const Options& options) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::string msg = "couldn't read file \"" + path + "\": no such file or directory";
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(msg.c_str(), -1));
+        return TCL_ERROR;
+    }
+    const std::string script((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    InfoScriptScope scope(interp, path);
+    ++depth_;
+
+    int status = TCL_OK;
+    std::string command;
+    int command_line = 0;
+    int line_no = 0;
+    size_t pos = 0;
+    while (pos <= script.size()) {
+        size_t nl = script.find('\n', pos);
+        if (nl == std::string::npos) nl = script.size();
+        const std::string line = script.substr(pos, nl - pos);
+        pos = nl + 1;
+        ++line_no;
+
+        if (options.echo) output_("> " + line);
+        if (command.empty()) {
+            if (isBlank(line)) continue;
+            command_line = line_no;
+        }
+        command += line;
+        command += '\n';
+        if (!Tcl_CommandComplete(command.c_str())) continue;
+
+        if (command[command.find_first_not_of(" \t")] == '#') {
+            command.clear();
+            continue;
+        }
+        status = runCommand(interp, command, path, command_line, options);
+        command.clear();
+        if (status == TCL_RETURN) {
+            status = TCL_OK;
+            break;
+        }
+        if (status != TCL_OK) {
+            if (options.stop_on_error) break;
+            status = TCL_OK;
+        }
+    }
+
+    // An unterminated command at end of file: let Tcl report what is missing.
+    if (!command.empty() && status == TCL_OK) {
+        status = runCommand(interp, command, path, command_line, options);
+        if (status != TCL_OK && !options.stop_on_error) status = TCL_OK;
+    }
+
+    --depth_;
+    return status;
+}
+
+int ScriptRunner::runCommand(Tcl_Interp* interp, const std::string& command, const std::string& file,
+                             int line, const Options& options) {
+    Tcl_Obj* script = Tcl_NewStringObj(command.data(), static_cast<int>(command.size()));
+    Tcl_IncrRefCount(script);
+    const std::string summary = summarize(command);
+    TraceScope trace("tcl", "source command", summary);
+    auto start = std::chrono::steady_clock::now();
+    int rc = Tcl_EvalObjEx(interp, script, 0);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Tcl_DecrRefCount(script);
+
+    profile_.push_back({file, line, depth_, summary, seconds, rc == TCL_OK || rc == TCL_RETURN});
+
+    if (rc == TCL_ERROR) {
+        if (options.stop_on_error) {
+            std::string where = "\n    (file \"" + file + "\" line " + std::to_string(line) + ")";
+            Tcl_AddErrorInfo(interp, where.c_str());
+        } else {
+            output_(std::string("[TCL ERROR] ") + Tcl_GetStringResult(interp));
+            Tcl_ResetResult(interp);
+        }
+    } else if (rc == TCL_OK && options.verbose) {
+        output_(Tcl_GetStringResult(interp));
+    }
+    return rc;
+}
+
+std::string ScriptRunner::formatProfile(size_t top) const {
+    double total = 0.0;
+    for (const auto& e : profile_)
+        if (e.depth == 1) total += e.seconds;
+
+    char buf[512];
+    std::string out;
+    std::snprintf(buf, sizeof(buf), "Source profile: %zu commands, %.3f s\n", profile_.size(), total);
+    out += buf;
+    if (profile_.empty()) return out;
+
+    std::vector<const ProfileEntry*> slowest;
+    for (const auto& e : profile_) slowest.push_back(&e);
+    top = std::min(top, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + top, slowest.end(),
+                      [](const ProfileEntry* a, const ProfileEntry* b) { return a->seconds > b->seconds; });
+
+    out += "Slowest commands:\n";
+    for (size_t i = 0; i < top; ++i) {
+        const auto* e = slowest[i];
+        std::snprintf(buf, sizeof(buf), "  %10.6f s  %s:%d%s  %s\n", e->seconds, e->file.c_str(), e->line,
+                      e->ok ? "" : " [ERROR]", e->command.c_str());
+        out += buf;
+    }
+
+    struct Totals {
+        size_t calls = 0;
+        double total = 0.0;
+        double max = 0.0;
+    };
+    std::map<std::string, Totals> by_name;
+    for (const auto& e : profile_) {
+        auto& t = by_name[commandName(e.command)];
+        ++t.calls;
+        t.total += e.seconds;
+        t.max = std::max(t.max, e.seconds);
+    }
+    std::vector<std::pair<std::string, Totals>> rows(by_name.begin(), by_name.end());
+    std::sort(rows.begin(), rows.end(),
+              [](const auto& a, const auto& b) { return a.second.total > b.second.total; });
+
+    std::snprintf(buf, sizeof(buf), "By command:\n  %-32s %8s %12s %12s\n", "command", "calls", "total (s)", "max (s)");
+    out += buf;
+    for (const auto& [name, t] : rows) {
+        std::snprintf(buf, sizeof(buf), "  %-32s %8zu %12.6f %12.6f\n", name.c_str(), t.calls, t.total, t.max);
+        out += buf;
+    }
+    return out;
+}
+
+int ScriptRunner::tcl_source(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<ScriptRunner*>(clientData);
+    Options options;
+    std::string filename;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-e") == 0) {
+            options.echo = true;
+        } else if (std::strcmp(argv[i], "-v") == 0) {
+            options.verbose = true;
+        } else {
+            filename = argv[i];
+        }
+    }
+    if (filename.empty()) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: source [-e] [-v] <filename>", -1));
+        return TCL_ERROR;
+    }
+
+    int rc = self->runFile(interp, filename, options);
+    if (rc == TCL_OK) Tcl_ResetResult(interp);
+    return rc;
+}
+
+int ScriptRunner::tcl_report_source_profile(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]) {
+    auto* self = static_cast<ScriptRunner*>(clientData);
+    size_t top = 10;
+    bool reset = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-top") == 0 && i + 1 < argc) {
+            top = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "-reset") == 0) {
+            reset = true;
+        } else {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("Usage: report_source_profile [-top <n>] [-reset]", -1));
+            return TCL_ERROR;
+        }
+    }
+    std::string report = self->formatProfile(top);
+    if (reset) self->clearProfile();
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(report.c_str(), static_cast<int>(report.size())));
+    return TCL_OK;
+}
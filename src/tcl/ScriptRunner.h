@@ -0,0 +1,54 @@
+// File: src/tcl/ScriptRunner.h
+#pragma once
+
+#include "CommandRegistry.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <tcl.h>
+
+// Native replacement for Tcl's `source`. Splits a script into complete
+// commands with Tcl_CommandComplete and evaluates each one as a compiled
+// object, so multi-line commands work and loop bodies get bytecode-compiled.
+// Every top-level command is timed into a profile for report_source_profile.
+class ScriptRunner {
+public:
+    using OutputFn = std::function<void(const std::string&)>;
+
+    struct Options {
+        bool echo = false;           // -e: print each line before running it
+        bool verbose = false;        // -v: print each command's result
+        bool stop_on_error = false;  // abort instead of reporting and going on
+    };
+
+    struct ProfileEntry {
+        std::string file;
+        int line;
+        int depth;  // nesting level of source calls
+        std::string command;
+        double seconds;
+        bool ok;
+    };
+
+    explicit ScriptRunner(OutputFn output);
+
+    void registerCommands(CommandRegistry& registry);
+
+    int runFile(Tcl_Interp* interp, const std::string& path, const Options& options);
+
+    const std::vector<ProfileEntry>& profile() const { return profile_; }
+    std::string formatProfile(size_t top) const;
+    void clearProfile() { profile_.clear(); }
+
+private:
+    static int tcl_source(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+    static int tcl_report_source_profile(ClientData clientData, Tcl_Interp* interp, int argc, const char* argv[]);
+
+    int runCommand(Tcl_Interp* interp, const std::string& command, const std::string& file,
+                   int line, const Options& options);
+
+    OutputFn output_;
+    std::vector<ProfileEntry> profile_;
+    int depth_ = 0;
+};
@@ -0,0 +1,50 @@
+// File: src/util/Arena.cpp
+
+#include "Arena.h"
+
+#include <cstring>
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {}
+
+void* Arena::allocate(size_t bytes, size_t align) {
+    if (bytes == 0) bytes = 1;
+    size_t pad = (align - reinterpret_cast<uintptr_t>(cursor_) % align) % align;
+    if (pad + bytes > remaining_) {
+        // Big requests get a block of their own so the current one is not
+        // abandoned half-used.
+        if (bytes > block_size_ / 4) {
+            blocks_.emplace_back(new char[bytes + align]);
+            reserved_ += bytes + align;
+            used_ += bytes;
+            char* base = blocks_.back().get();
+            base += (align - reinterpret_cast<uintptr_t>(base) % align) % align;
+            return base;
+        }
+        blocks_.emplace_back(new char[block_size_]);
+        reserved_ += block_size_;
+        cursor_ = blocks_.back().get();
+        remaining_ = block_size_;
+        pad = (align - reinterpret_cast<uintptr_t>(cursor_) % align) % align;
+    }
+    char* result = cursor_ + pad;
+    cursor_ += pad + bytes;
+    remaining_ -= pad + bytes;
+    used_ += bytes;
+    return result;
+}
+
+std::string_view Arena::copy(std::string_view text) {
+    if (text.empty()) return {};
+    char* data = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(data, text.data(), text.size());
+    return std::string_view(data, text.size());
+}
+
+void Arena::reset() {
+    blocks_.clear();
+    blocks_.shrink_to_fit();
+    cursor_ = nullptr;
+    remaining_ = 0;
+    reserved_ = 0;
+    used_ = 0;
+}
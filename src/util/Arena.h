@@ -0,0 +1,67 @@
+// File: src/util/Arena.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Contiguous read-only view of `size` elements, typically arena-owned.
+template <class T>
+class ArenaSpan {
+public:
+    ArenaSpan() = default;
+    ArenaSpan(T* data, size_t size) : data_(data), size_(size) {}
+
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T* data() const { return data_; }
+    T& operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Monotonic bump allocator. Memory is handed out from large blocks and only
+// given back all at once by reset() or destruction; nothing is freed
+// individually and no destructors run, so only trivially destructible data
+// belongs here.
+class Arena {
+public:
+    explicit Arena(size_t block_size = 1 << 20);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    template <class T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Copies `text` into the arena; the view stays valid until reset().
+    std::string_view copy(std::string_view text);
+
+    // Frees every block.
+    void reset();
+
+    size_t bytesReserved() const { return reserved_; }
+    size_t bytesUsed() const { return used_; }
+
+private:
+    size_t block_size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_ = nullptr;
+    size_t remaining_ = 0;
+    size_t reserved_ = 0;
+    size_t used_ = 0;
+};
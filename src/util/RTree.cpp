@@ -0,0 +1,111 @@
+// File: src/util/RTree.cpp
+
+#include "RTree.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Position of (x, y) along a Hilbert curve over a 2^16 x 2^16 grid.
+uint32_t hilbert(uint32_t x, uint32_t y) {
+    constexpr uint32_t n = 1u << 16;
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        d += uint64_t(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return static_cast<uint32_t>(d);
+}
+
+// LSD radix sort of (key, value) pairs by key, one byte per pass.
+void radixSort(std::vector<std::pair<uint32_t, uint32_t>>& items) {
+    std::vector<std::pair<uint32_t, uint32_t>> scratch(items.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t counts[257] = {};
+        for (const auto& item : items) ++counts[((item.first >> shift) & 0xff) + 1];
+        for (int b = 0; b < 256; ++b) counts[b + 1] += counts[b];
+        for (const auto& item : items) scratch[counts[(item.first >> shift) & 0xff]++] = item;
+        items.swap(scratch);
+    }
+}
+
+}  // namespace
+
+void RTree::build(const std::vector<Box>& boxes) {
+    clear();
+    count_ = static_cast<uint32_t>(boxes.size());
+    if (count_ == 0) return;
+
+    Box all = boxes[0];
+    for (const Box& b : boxes) {
+        all.x0 = std::min(all.x0, b.x0);
+        all.y0 = std::min(all.y0, b.y0);
+        all.x1 = std::max(all.x1, b.x1);
+        all.y1 = std::max(all.y1, b.y1);
+    }
+    const float sx = all.x1 > all.x0 ? 65535.0f / (all.x1 - all.x0) : 0.0f;
+    const float sy = all.y1 > all.y0 ? 65535.0f / (all.y1 - all.y0) : 0.0f;
+
+    std::vector<std::pair<uint32_t, uint32_t>> order(count_);
+    ThreadPool::instance().parallelFor(0, count_, 1 << 16, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            const Box& box = boxes[i];
+            const float cx = ((box.x0 + box.x1) * 0.5f - all.x0) * sx;
+            const float cy = ((box.y0 + box.y1) * 0.5f - all.y0) * sy;
+            order[i] = {hilbert(static_cast<uint32_t>(cx), static_cast<uint32_t>(cy)), static_cast<uint32_t>(i)};
+        }
+    });
+    radixSort(order);
+
+    // A packed tree has about count / (fanout - 1) nodes.
+    const size_t nodes_estimate = count_ / (kFanout - 1) + 2 * 8;
+    boxes_.reserve(count_ + nodes_estimate);
+    first_.reserve(count_ + nodes_estimate);
+    last_.reserve(nodes_estimate);
+    for (const auto& entry : order) {
+        boxes_.push_back(boxes[entry.second]);
+        first_.push_back(entry.second);
+    }
+
+    // Pack each level into parents until one root is left. A single entry
+    // still gets a root so the root is always a node.
+    uint32_t begin = 0, end = count_;
+    do {
+        for (uint32_t child = begin; child < end; child += kFanout) {
+            const uint32_t stop = std::min(end, child + kFanout);
+            Box box = boxes_[child];
+            for (uint32_t c = child + 1; c < stop; ++c) {
+                box.x0 = std::min(box.x0, boxes_[c].x0);
+                box.y0 = std::min(box.y0, boxes_[c].y0);
+                box.x1 = std::max(box.x1, boxes_[c].x1);
+                box.y1 = std::max(box.y1, boxes_[c].y1);
+            }
+            boxes_.push_back(box);
+            first_.push_back(child);
+            last_.push_back(stop);
+        }
+        begin = end;
+        end = static_cast<uint32_t>(boxes_.size());
+    } while (end - begin > 1);
+}
+
+void RTree::clear() {
+    boxes_.clear();
+    first_.clear();
+    last_.clear();
+    count_ = 0;
+}
+
+size_t RTree::memoryBytes() const {
+    return boxes_.capacity() * sizeof(Box) + (first_.capacity() + last_.capacity()) * sizeof(uint32_t);
+}
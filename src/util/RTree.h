@@ -0,0 +1,63 @@
+// File: src/util/RTree.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Static, packed R-tree over axis-aligned boxes. Entries are sorted along a
+// Hilbert curve through their centres and packed bottom-up into nodes of
+// kFanout children, so the whole tree is two flat arrays and building it is
+// one sort. Entry IDs are the indices of the boxes passed to build().
+class RTree {
+public:
+    struct Box {
+        float x0, y0, x1, y1;
+
+        bool intersects(const Box& o) const { return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1; }
+    };
+
+    static constexpr uint32_t kFanout = 16;
+
+    // Replaces the contents with `boxes`; key computation runs on the
+    // shared thread pool.
+    void build(const std::vector<Box>& boxes);
+    void clear();
+
+    // Calls fn(id) for every entry whose box intersects `area`, in no
+    // particular order.
+    template <class F>
+    void query(const Box& area, F&& fn) const;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    // Union of all entries; undefined when empty.
+    const Box& bounds() const { return boxes_.back(); }
+    size_t memoryBytes() const;
+
+private:
+    // boxes_ holds the sorted entries, then each level of nodes up to the
+    // root. For an entry first_[i] is its ID; for a node it is the index
+    // of its first child, with children running to last_[i - count_].
+    std::vector<Box> boxes_;
+    std::vector<uint32_t> first_;
+    std::vector<uint32_t> last_;
+    uint32_t count_ = 0;
+};
+
+template <class F>
+void RTree::query(const Box& area, F&& fn) const {
+    if (count_ == 0) return;
+    std::vector<uint32_t> stack;
+    stack.push_back(static_cast<uint32_t>(boxes_.size() - 1));
+    while (!stack.empty()) {
+        const uint32_t node = stack.back();
+        stack.pop_back();
+        if (!boxes_[node].intersects(area)) continue;
+        if (node < count_) {
+            fn(first_[node]);
+            continue;
+        }
+        for (uint32_t child = first_[node]; child < last_[node - count_]; ++child) stack.push_back(child);
+    }
+}
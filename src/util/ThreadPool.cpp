@@ -0,0 +1,182 @@
+// File: src/util/ThreadPool.cpp
+
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <algorithm>
+
+namespace {
+// Pool and queue index of the current thread when it is a pool worker.
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local int tls_worker = -1;
+}  // namespace
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    return pool;
+}
+
+ThreadPool::ThreadPool(int num_threads) {
+    num_threads = std::max(1, num_threads);
+    for (int i = 0; i < num_threads; ++i) queues_.push_back(std::make_unique<WorkQueue>());
+    start(num_threads);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+int ThreadPool::size() const {
+    std::shared_lock<std::shared_mutex> lock(queues_mutex_);
+    return static_cast<int>(queues_.size());
+}
+
+void ThreadPool::resize(int num_threads) {
+    num_threads = std::max(1, num_threads);
+    std::lock_guard<std::mutex> guard(resize_mutex_);
+    if (num_threads == size()) return;
+
+    stop();
+
+    // Carry queued work over to the new set of queues and swap them in under
+    // one exclusive lock, so post() never sees an empty queue list. Tasks
+    // posted while the workers were stopping are in the old queues too.
+    {
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        for (int i = 0; i < num_threads; ++i) queues.push_back(std::make_unique<WorkQueue>());
+        std::unique_lock<std::shared_mutex> lock(queues_mutex_);
+        size_t i = 0;
+        for (auto& q : queues_) {
+            for (auto& t : q->tasks) queues[i++ % queues.size()]->tasks.push_back(std::move(t));
+        }
+        queues_.swap(queues);
+    }
+
+    // The new workers look for queued work before they first sleep.
+    start(num_threads);
+}
+
+void ThreadPool::start(int num_threads) {
+    {
+        std::lock_guard<std::mutex> wake(wake_mutex_);
+        stopping_ = false;
+    }
+    for (int i = 0; i < num_threads; ++i) workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> wake(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) w.join();
+    workers_.clear();
+}
+
+void ThreadPool::post(Task task) {
+    {
+        std::shared_lock<std::shared_mutex> lock(queues_mutex_);
+        // Workers keep their own spawned work local; outside threads spread
+        // submissions round-robin.
+        size_t index = (tls_pool == this && tls_worker >= 0)
+                           ? static_cast<size_t>(tls_worker)
+                           : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        auto& q = *queues_[index];
+        auto qlock = lockQueue(q);
+        q.tasks.push_back(std::move(task));
+        pending_.fetch_add(1, std::memory_order_release);
+    }
+    std::lock_guard<std::mutex> wake(wake_mutex_);
+    wake_.notify_one();
+}
+
+bool ThreadPool::popTask(int index, Task& task) {
+    std::shared_lock<std::shared_mutex> lock(queues_mutex_);
+    const size_t n = queues_.size();
+    if (n == 0 || pending_.load(std::memory_order_acquire) == 0) return false;
+
+    // Own queue first (LIFO, cache-warm), then steal FIFO from the others.
+    if (index >= 0 && static_cast<size_t>(index) < n) {
+        auto& q = *queues_[index];
+        auto qlock = lockQueue(q);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    const size_t first = index >= 0 ? static_cast<size_t>(index) + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        auto& q = *queues_[(first + k) % n];
+        auto qlock = lockQueue(q);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_lock<std::mutex> ThreadPool::lockQueue(WorkQueue& queue) {
+    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        lock_waits_.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    return lock;
+}
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    const int index = tls_pool == this ? tls_worker : -1;
+    if (!popTask(index, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::waitFor(const std::atomic<size_t>& remaining) {
+    TraceScope trace("pool", "wait");
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (runPendingTask()) continue;
+        // Nothing left to steal: sleep until the last chunk finishes or more
+        // work is posted that this thread can help with.
+        std::unique_lock<std::mutex> wake(wake_mutex_);
+        wake_.wait(wake, [&]() {
+            return remaining.load(std::memory_order_acquire) == 0 || pending_.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void ThreadPool::notifyWaiters() {
+    // Taking the mutex orders this after a waiter's check of its counter.
+    std::lock_guard<std::mutex> wake(wake_mutex_);
+    wake_.notify_all();
+}
+
+void ThreadPool::workerLoop(int index) {
+    tls_pool = this;
+    tls_worker = index;
+    Tracer::instance().setThreadName("pool worker " + std::to_string(index));
+    Task task;
+    while (true) {
+        if (popTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> wake(wake_mutex_);
+        {
+            TraceScope trace("pool", "idle");
+            wake_.wait(wake, [this]() {
+                return stopping_ || pending_.load(std::memory_order_acquire) > 0;
+            });
+        }
+        if (stopping_) break;
+    }
+    tls_pool = nullptr;
+    tls_worker = -1;
+}
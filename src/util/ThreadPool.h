@@ -0,0 +1,109 @@
+// File: src/util/ThreadPool.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Process-wide work-stealing task scheduler. Each worker owns a deque: it
+// pushes and pops its own work at the back and steals from the front of the
+// others when it runs dry. Threads that wait on work (for example
+// parallelFor) run queued tasks before they block, and wake again when more
+// is posted, so nested parallel sections cannot deadlock.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Shared pool used by parsing, index building and query commands.
+    static ThreadPool& instance();
+
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Restarts the pool with `num_threads` workers. Queued tasks are kept;
+    // tasks already running finish first. Must not be called from a worker.
+    void resize(int num_threads);
+    int size() const;
+
+    void post(Task task);
+
+    template <class F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = job->get_future();
+        post([job]() { (*job)(); });
+        return result;
+    }
+
+    // Calls fn(chunk_begin, chunk_end) over [begin, end) in chunks of `grain`
+    // and returns once all chunks are done. The calling thread takes part.
+    template <class F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& fn) {
+        if (begin >= end) return;
+        if (grain == 0) grain = 1;
+        const size_t chunks = (end - begin + grain - 1) / grain;
+        if (chunks == 1) {
+            fn(begin, end);
+            return;
+        }
+        std::atomic<size_t> remaining{chunks - 1};
+        for (size_t c = 1; c < chunks; ++c) {
+            const size_t b = begin + c * grain;
+            const size_t e = std::min(end, b + grain);
+            post([this, &fn, &remaining, b, e]() {
+                fn(b, e);
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) notifyWaiters();
+            });
+        }
+        fn(begin, std::min(end, begin + grain));
+        waitFor(remaining);
+    }
+
+    // Runs one queued task on the calling thread; false if none was queued.
+    bool runPendingTask();
+
+    // Times a queue lock was found held by another thread, since start-up.
+    uint64_t lockWaits() const { return lock_waits_.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Spawns workers for the queues already in place.
+    void start(int num_threads);
+    void stop();
+    void workerLoop(int index);
+    bool popTask(int index, Task& task);
+    void waitFor(const std::atomic<size_t>& remaining);
+    void notifyWaiters();
+    std::unique_lock<std::mutex> lockQueue(WorkQueue& queue);
+
+    mutable std::shared_mutex queues_mutex_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex resize_mutex_;
+    // Guards stopping_; idle workers and waitFor() sleep on wake_.
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<uint64_t> lock_waits_{0};
+    bool stopping_ = false;
+};
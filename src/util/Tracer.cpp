@@ -0,0 +1,179 @@
+// File: src/util/Tracer.cpp
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+// Owns the calling thread's buffer registration and releases it on exit.
+struct TraceThreadSlot {
+    Tracer::ThreadBuffer* buffer = nullptr;
+    std::string name;  // applied when the buffer is created
+    ~TraceThreadSlot() {
+        if (buffer) buffer->live.store(false, std::memory_order_release);
+    }
+};
+
+namespace {
+
+thread_local TraceThreadSlot tls_slot;
+
+const std::chrono::steady_clock::time_point kEpoch = std::chrono::steady_clock::now();
+
+void appendEscaped(std::string& out, const char* s) {
+    for (; s && *s; ++s) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+}  // namespace
+
+Tracer& Tracer::instance() {
+    // Never destroyed: pool workers may still record while statics unwind.
+    static Tracer* tracer = new Tracer;
+    return *tracer;
+}
+
+int64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch)
+        .count();
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    if (tls_slot.buffer) return *tls_slot.buffer;
+
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    ThreadBuffer* buffer = nullptr;
+    if (buffers_.size() >= kMaxBuffers) {
+        for (auto& b : buffers_) {
+            if (!b->live.load(std::memory_order_acquire)) {
+                buffer = b.get();
+                buffer->head.store(0, std::memory_order_relaxed);
+                buffer->tail.store(0, std::memory_order_relaxed);
+                buffer->live.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    if (!buffer) {
+        buffers_.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers_.back().get();
+    }
+    buffer->tid = next_tid_++;
+    buffer->name = tls_slot.name.empty() ? "thread " + std::to_string(buffer->tid) : tls_slot.name;
+    tls_slot.buffer = buffer;
+    return *buffer;
+}
+
+void Tracer::record(const TraceEvent& event) {
+    ThreadBuffer& buffer = localBuffer();
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % kEventsPerThread] = event;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    tls_slot.name = name;
+    if (!tls_slot.buffer) return;
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    tls_slot.buffer->name = name;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (auto& b : buffers_) b->tail.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+size_t Tracer::eventCount() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    size_t count = 0;
+    for (auto& b : buffers_) {
+        const uint64_t head = b->head.load(std::memory_order_acquire);
+        const uint64_t first = std::max(b->tail.load(std::memory_order_relaxed),
+                                        head > kEventsPerThread ? head - kEventsPerThread : 0);
+        count += head - first;
+    }
+    return count;
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open trace file: " << path << std::endl;
+        return false;
+    }
+
+    const int pid = static_cast<int>(getpid());
+    std::string out = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first_event = true;
+    char buf[160];
+
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (auto& b : buffers_) {
+        const uint64_t head = b->head.load(std::memory_order_acquire);
+        const uint64_t first = std::max(b->tail.load(std::memory_order_relaxed),
+                                        head > kEventsPerThread ? head - kEventsPerThread : 0);
+        if (head == first) continue;
+
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": %d, \"tid\": %u, \"args\": {\"name\": \"",
+                      first_event ? "" : ",\n", pid, b->tid);
+        out += buf;
+        appendEscaped(out, b->name.c_str());
+        out += "\"}}";
+        first_event = false;
+
+        for (uint64_t i = first; i < head; ++i) {
+            const TraceEvent& e = b->events[i % kEventsPerThread];
+            out += ",\n{\"ph\": \"X\", \"cat\": \"";
+            appendEscaped(out, e.category);
+            out += "\", \"name\": \"";
+            appendEscaped(out, e.name);
+            std::snprintf(buf, sizeof(buf), "\", \"pid\": %d, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f", pid, b->tid,
+                          e.begin_ns / 1000.0, e.duration_ns / 1000.0);
+            out += buf;
+            if (e.detail[0]) {
+                out += ", \"args\": {\"detail\": \"";
+                appendEscaped(out, e.detail);
+                out += "\"}";
+            }
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+
+    file << out;
+    return static_cast<bool>(file);
+}
+
+TraceScope::TraceScope(const char* category, const char* name, std::string_view detail)
+    : active_(Tracer::instance().enabled()) {
+    if (!active_) return;
+    event_.category = category;
+    event_.name = name;
+    const size_t n = std::min(detail.size(), TraceEvent::kDetailSize - 1);
+    std::memcpy(event_.detail, detail.data(), n);
+    event_.detail[n] = '\0';
+    event_.begin_ns = Tracer::nowNs();
+}
+
+TraceScope::~TraceScope() {
+    if (!active_) return;
+    event_.duration_ns = Tracer::nowNs() - event_.begin_ns;
+    Tracer::instance().record(event_);
+}
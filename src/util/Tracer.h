@@ -0,0 +1,94 @@
+// File: src/util/Tracer.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One completed span. `name` and `category` must be string literals; the
+// optional detail (a Tcl command, a chunk number) is copied and truncated.
+struct TraceEvent {
+    static constexpr size_t kDetailSize = 48;
+
+    const char* category = nullptr;
+    const char* name = nullptr;
+    int64_t begin_ns = 0;
+    int64_t duration_ns = 0;
+    char detail[kDetailSize] = {};
+};
+
+// Process-wide timeline tracer. Every thread records into its own
+// fixed-size ring buffer, so recording takes no lock and never allocates
+// after the first event on a thread; the oldest events are overwritten once
+// a buffer is full. Export walks all buffers and writes the Chrome/Perfetto
+// trace-event JSON format (chrome://tracing, ui.perfetto.dev).
+class Tracer {
+public:
+    static constexpr size_t kEventsPerThread = 1 << 14;
+    // Buffers of exited threads are kept for export until this many exist,
+    // then recycled for new threads.
+    static constexpr size_t kMaxBuffers = 256;
+
+    static Tracer& instance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    void record(const TraceEvent& event);
+
+    // Label shown for the calling thread in the trace viewer. Cheap to call
+    // up front; no buffer is allocated until the thread records an event.
+    void setThreadName(const std::string& name);
+
+    // Drops everything recorded so far.
+    void clear();
+    size_t eventCount() const;
+
+    // Export is meant to run while the traced work is idle; events recorded
+    // concurrently may or may not be included.
+    bool writeChromeTrace(const std::string& path) const;
+
+    static int64_t nowNs();
+
+private:
+    struct ThreadBuffer {
+        std::unique_ptr<TraceEvent[]> events{new TraceEvent[kEventsPerThread]};
+        std::atomic<uint64_t> head{0};   // next write position, owner thread only
+        std::atomic<uint64_t> tail{0};   // first position still visible after clear()
+        std::atomic<bool> live{true};    // false once the owner thread exited
+        uint32_t tid = 0;
+        std::string name;
+    };
+    friend struct TraceThreadSlot;
+
+    Tracer() = default;
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> enabled_{true};
+    mutable std::mutex buffers_mutex_;  // guards registration and names only
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    uint32_t next_tid_ = 1;
+};
+
+// Records the lifetime of a scope as one span on the calling thread's
+// timeline. Costs a relaxed load when tracing is off.
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, std::string_view detail = {});
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceEvent event_;
+    bool active_;
+};
@@ -0,0 +1,388 @@
+// File: src/verilog_parser/DefPlacement.cpp
+
+#include "DefPlacement.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+using Id = NetlistDb::Id;
+constexpr Id kNone = NetlistDb::kNone;
+
+// COMPONENTS text per parse task.
+constexpr size_t kChunkBytes = 4 << 20;
+constexpr size_t kUnmatchedNames = 5;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Whitespace-separated DEF tokens; "quoted strings" are one token and #
+// comments run to the end of the line.
+class Lexer {
+public:
+    Lexer(const char* data, size_t begin, size_t end) : data_(data), pos_(begin), end_(end) {}
+
+    std::string_view next() {
+        while (pos_ < end_) {
+            if (isSpace(data_[pos_])) {
+                ++pos_;
+            } else if (data_[pos_] == '#') {
+                while (pos_ < end_ && data_[pos_] != '\n') ++pos_;
+            } else {
+                break;
+            }
+        }
+        const size_t begin = pos_;
+        if (pos_ < end_ && data_[pos_] == '"') {
+            ++pos_;
+            while (pos_ < end_ && data_[pos_] != '"') pos_ += data_[pos_] == '\\' ? 2 : 1;
+            pos_ = std::min(pos_ + 1, end_);
+        } else {
+            while (pos_ < end_ && !isSpace(data_[pos_])) ++pos_;
+        }
+        return std::string_view(data_ + begin, pos_ - begin);
+    }
+
+    // Skips past the next `;`.
+    void skipStatement() {
+        for (std::string_view t = next(); !t.empty() && t != ";"; t = next()) {}
+    }
+    // Skips a section to just past its `END <name>`, searching for the END
+    // instead of reading every token before it.
+    void skipSection(std::string_view name) {
+        const std::string_view text(data_, end_);
+        for (size_t at = text.find("END", pos_); at != std::string_view::npos; at = text.find("END", at + 3)) {
+            if ((at > 0 && !isSpace(data_[at - 1])) || (at + 3 < end_ && !isSpace(data_[at + 3]))) continue;
+            pos_ = at + 3;
+            if (next() == name) return;
+        }
+        pos_ = end_;
+    }
+
+    size_t pos() const { return pos_; }
+
+private:
+    const char* data_;
+    size_t pos_;
+    size_t end_;
+};
+
+// DEF numbers are integers in practice; reals are truncated.
+bool toInt(std::string_view text, int64_t& value) {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (ec != std::errc()) return false;
+    if (ptr != end) value = static_cast<int64_t>(std::strtod(std::string(text).c_str(), nullptr));
+    return true;
+}
+
+// "( x y )" after the opening parenthesis has been read.
+bool readPoint(Lexer& lexer, int64_t& x, int64_t& y) {
+    return toInt(lexer.next(), x) && toInt(lexer.next(), y) && lexer.next() == ")";
+}
+
+bool toOrient(std::string_view text, DefPlacement::Orient& orient) {
+    static constexpr std::string_view kNames[] = {"N", "W", "S", "E", "FN", "FW", "FS", "FE"};
+    for (size_t i = 0; i < std::size(kNames); ++i) {
+        if (text == kNames[i]) {
+            orient = static_cast<DefPlacement::Orient>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool toStatus(std::string_view text, DefPlacement::Status& status) {
+    if (text == "PLACED")
+        status = DefPlacement::Status::Placed;
+    else if (text == "FIXED")
+        status = DefPlacement::Status::Fixed;
+    else if (text == "COVER")
+        status = DefPlacement::Status::Cover;
+    else
+        return false;
+    return true;
+}
+
+// `+ PLACED ( x y ) N` once `+ PLACED` has been read.
+bool readLocation(Lexer& lexer, int64_t& x, int64_t& y, DefPlacement::Orient& orient) {
+    return lexer.next() == "(" && readPoint(lexer, x, y) && toOrient(lexer.next(), orient);
+}
+
+// DEF escapes special characters with a backslash, or leaves them be;
+// the netlist keeps an escaped identifier with its leading backslash.
+// "a\[0\]" and "a[0]" are both "\a[0]" when the netlist has no "a[0]".
+Id findCell(const NetlistDb& db, std::string_view name) {
+    const Id cell = db.findCell(name);
+    if (cell != kNone) return cell;
+    std::string escaped = "\\";
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] == '\\' && i + 1 < name.size()) ++i;
+        escaped += name[i];
+    }
+    const Id plain = escaped.size() == name.size() + 1 ? kNone : db.findCell(std::string_view(escaped).substr(1));
+    return plain != kNone ? plain : db.findCell(escaped);
+}
+
+enum class LineEnd { Blank, Semicolon, Other };
+
+// How the line [begin, end) ends by the lexer's rules: its last token
+// outside strings and # comments. A line that leaves a string open could
+// be the middle of a longer one, so it counts as Other.
+LineEnd lineEnd(const char* data, size_t begin, size_t end) {
+    char last = 0;
+    bool quoted = false;
+    for (size_t i = begin; i < end; ++i) {
+        const char c = data[i];
+        if (quoted) {
+            if (c == '\\') ++i;
+            else if (c == '"') quoted = false;
+        } else if (c == '"') {
+            quoted = true;
+            last = c;
+        } else if (c == '#') {
+            break;
+        } else if (!isSpace(c)) {
+            last = c;
+        }
+    }
+    if (quoted) return LineEnd::Other;
+    return last == 0 ? LineEnd::Blank : last == ';' ? LineEnd::Semicolon : LineEnd::Other;
+}
+
+// Start of the first line at or after `pos` that opens a component: it
+// begins with a "-" token, and the last line before it with a token on it
+// ends with ';'. A ';' or "-" inside a string or comment never qualifies,
+// so a parse task can start there. `end` when no line does.
+size_t nextComponent(const char* data, size_t pos, size_t end) {
+    size_t line = pos;
+    while (line > 0 && line < end && data[line - 1] != '\n') ++line;
+    for (; line < end; ++line) {
+        size_t i = line;
+        while (i < end && (data[i] == ' ' || data[i] == '\t')) ++i;
+        if (i + 1 < end && data[i] == '-' && isSpace(data[i + 1])) {
+            LineEnd before = LineEnd::Blank;
+            for (size_t prev_end = line; before == LineEnd::Blank && prev_end > 0;) {
+                size_t prev = prev_end - 1;
+                while (prev > 0 && data[prev - 1] != '\n') --prev;
+                before = lineEnd(data, prev, prev_end);
+                prev_end = prev;
+            }
+            if (before == LineEnd::Semicolon) return line;
+        }
+        while (line < end && data[line] != '\n') ++line;
+    }
+    return end;
+}
+
+}  // namespace
+
+bool DefPlacement::read(const std::string& file, const NetlistDb& db, std::string& error) {
+    TraceScope trace("def", "read", file);
+    const auto start = std::chrono::steady_clock::now();
+    *this = DefPlacement();
+
+    std::string buffer;
+    {
+        TraceScope trace("def", "load file");
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open()) {
+            error = "Cannot open " + file;
+            return false;
+        }
+        in.seekg(0, std::ios::end);
+        buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0, std::ios::beg);
+        in.read(&buffer[0], buffer.size());
+    }
+
+    x_.assign(db.cellCount(), 0);
+    y_.assign(db.cellCount(), 0);
+    orient_.assign(db.cellCount(), Orient::N);
+    status_.assign(db.cellCount(), Status::Unplaced);
+
+    // The header, DIEAREA, ROWs and PINS are read in order on this thread;
+    // COMPONENTS is located here and parsed in parallel.
+    Lexer lexer(buffer.data(), 0, buffer.size());
+    size_t components_begin = 0, components_end = 0;
+    std::vector<int64_t> row_y;
+    bool has_die = false, has_sections = false;
+    for (std::string_view t = lexer.next(); !t.empty(); t = lexer.next()) {
+        if (t == "UNITS") {
+            int64_t dbu = 0;
+            if (lexer.next() == "DISTANCE" && lexer.next() == "MICRONS" && toInt(lexer.next(), dbu) && dbu > 0)
+                dbu_per_micron_ = static_cast<int>(dbu);
+            lexer.skipStatement();
+        } else if (t == "DIEAREA") {
+            // A rectangle or a polygon; either way its bounding box.
+            bool first = true;
+            for (std::string_view p = lexer.next(); !p.empty() && p != ";"; p = lexer.next()) {
+                int64_t x = 0, y = 0;
+                if (p != "(" || !readPoint(lexer, x, y)) continue;
+                die_ = first ? Rect{x, y, x, y}
+                             : Rect{std::min(die_.x0, x), std::min(die_.y0, y), std::max(die_.x1, x),
+                                    std::max(die_.y1, y)};
+                first = false;
+            }
+            has_die = !first;
+        } else if (t == "ROW") {
+            // ROW name site x y orient [DO nx BY ny [STEP sx sy]] ;
+            int64_t y = 0, x = 0, nx = 1, ny = 1, sx = 0, sy = 0;
+            lexer.next();
+            lexer.next();
+            if (toInt(lexer.next(), x) && toInt(lexer.next(), y)) row_y.push_back(y);
+            for (std::string_view p = lexer.next(); !p.empty() && p != ";"; p = lexer.next()) {
+                if (p == "DO") {
+                    toInt(lexer.next(), nx);
+                    lexer.next();
+                    toInt(lexer.next(), ny);
+                } else if (p == "STEP") {
+                    toInt(lexer.next(), sx);
+                    toInt(lexer.next(), sy);
+                }
+            }
+            if (ny > 1 && sy > 0) row_y.push_back(y + sy);
+        } else if (t == "COMPONENTS") {
+            has_sections = true;
+            lexer.skipStatement();
+            components_begin = lexer.pos();
+            lexer.skipSection("COMPONENTS");
+            components_end = lexer.pos();
+        } else if (t == "PINS") {
+            has_sections = true;
+            lexer.skipStatement();
+            for (std::string_view p = lexer.next(); !p.empty() && p != "END"; p = lexer.next()) {
+                if (p != "-") continue;
+                // - name + NET net ... + PLACED ( x y ) N ;
+                Pin pin;
+                pin.name = std::string(lexer.next());
+                for (std::string_view q = lexer.next(); !q.empty() && q != ";"; q = lexer.next()) {
+                    if (q != "+") continue;
+                    const std::string_view key = lexer.next();
+                    Status status;
+                    int64_t x = 0, y = 0;
+                    Orient orient;
+                    if (key == "NET") {
+                        pin.net = std::string(lexer.next());
+                    } else if (toStatus(key, status) && readLocation(lexer, x, y, orient)) {
+                        pin.status = status;
+                        pin.x = static_cast<int32_t>(x);
+                        pin.y = static_cast<int32_t>(y);
+                    }
+                }
+                pins_.push_back(std::move(pin));
+            }
+            lexer.next();  // PINS
+        } else if (t == "END") {
+            if (lexer.next() == "DESIGN") break;
+        } else if (t == "NETS" || t == "SPECIALNETS" || t == "VIAS" || t == "NONDEFAULTRULES" || t == "REGIONS" ||
+                   t == "GROUPS" || t == "BLOCKAGES" || t == "FILLS" || t == "SLOTS" || t == "SCANCHAINS" ||
+                   t == "STYLES" || t == "PINPROPERTIES" || t == "PROPERTYDEFINITIONS") {
+            has_sections = true;
+            lexer.skipSection(t);
+        } else {
+            lexer.skipStatement();
+        }
+    }
+    if (!has_sections && !has_die) {
+        error = file + " has no DEF sections";
+        return false;
+    }
+
+    // Components: "- name master [+ PLACED|FIXED|COVER ( x y ) orient] ... ;".
+    // Each task starts on a line that opens a component, so none straddles
+    // two tasks.
+    std::vector<size_t> bounds{components_begin};
+    while (bounds.back() < components_end) {
+        const size_t nominal = std::min(bounds.back() + kChunkBytes, components_end);
+        bounds.push_back(nextComponent(buffer.data(), nominal, components_end));
+    }
+    std::vector<Stats> chunk_stats(bounds.size() - 1);
+    {
+        TraceScope trace("def", "components", std::to_string(bounds.size() - 1) + " chunks");
+        ThreadPool::instance().parallelFor(0, chunk_stats.size(), 1, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                Stats& stats = chunk_stats[i];
+                Lexer chunk(buffer.data(), bounds[i], bounds[i + 1]);
+                for (std::string_view t = chunk.next(); !t.empty(); t = chunk.next()) {
+                    if (t != "-") continue;
+                    const std::string_view name = chunk.next();
+                    chunk.next();  // master
+                    Status status = Status::Unplaced;
+                    int64_t x = 0, y = 0;
+                    Orient orient = Orient::N;
+                    for (std::string_view q = chunk.next(); !q.empty() && q != ";"; q = chunk.next()) {
+                        Status s;
+                        if (q == "+" || !toStatus(q, s)) continue;
+                        if (readLocation(chunk, x, y, orient)) status = s;
+                    }
+                    ++stats.components;
+                    const Id cell = findCell(db, name);
+                    if (cell == kNone) {
+                        if (stats.unmatched_names.size() < kUnmatchedNames)
+                            stats.unmatched_names.emplace_back(name);
+                        ++stats.unmatched;
+                        continue;
+                    }
+                    ++stats.matched;
+                    x_[cell] = static_cast<int32_t>(x);
+                    y_[cell] = static_cast<int32_t>(y);
+                    orient_[cell] = orient;
+                    status_[cell] = status;
+                }
+            }
+        });
+    }
+    for (const Stats& s : chunk_stats) {
+        stats_.components += s.components;
+        stats_.matched += s.matched;
+        stats_.unmatched += s.unmatched;
+        for (const std::string& name : s.unmatched_names) {
+            if (stats_.unmatched_names.size() < kUnmatchedNames) stats_.unmatched_names.push_back(name);
+        }
+    }
+
+    {
+        TraceScope trace("def", "index");
+        for (Id c = 0; c < status_.size(); ++c) {
+            if (status_[c] != Status::Unplaced) placed_.push_back(c);
+        }
+        std::vector<RTree::Box> boxes(placed_.size());
+        ThreadPool::instance().parallelFor(0, placed_.size(), 1 << 16, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const float x = static_cast<float>(x_[placed_[i]]), y = static_cast<float>(y_[placed_[i]]);
+                boxes[i] = {x, y, x, y};
+            }
+        });
+        index_.build(boxes);
+        if (!has_die && !index_.empty()) {
+            const RTree::Box& all = index_.bounds();
+            die_ = {static_cast<int64_t>(all.x0), static_cast<int64_t>(all.y0), static_cast<int64_t>(all.x1),
+                    static_cast<int64_t>(all.y1)};
+        }
+    }
+
+    std::sort(row_y.begin(), row_y.end());
+    for (size_t i = 1; i < row_y.size(); ++i) {
+        const int64_t gap = row_y[i] - row_y[i - 1];
+        if (gap > 0 && (row_pitch_ == 0 || gap < row_pitch_)) row_pitch_ = gap;
+    }
+
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+size_t DefPlacement::memoryBytes() const {
+    size_t bytes = x_.capacity() * sizeof(int32_t) + y_.capacity() * sizeof(int32_t) +
+                   orient_.capacity() * sizeof(Orient) + status_.capacity() * sizeof(Status) +
+                   placed_.capacity() * sizeof(Id) + index_.memoryBytes() + pins_.capacity() * sizeof(Pin);
+    for (const Pin& pin : pins_) bytes += pin.name.capacity() + pin.net.capacity();
+    return bytes;
+}
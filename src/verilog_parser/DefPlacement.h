@@ -0,0 +1,104 @@
+// File: src/verilog_parser/DefPlacement.h
+#pragma once
+
+#include "NetlistDb.h"
+#include "util/RTree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cell locations read from a placed DEF file: the die area, the rows'
+// pitch, each component's location and the I/O pins. Only DIEAREA, ROW,
+// COMPONENTS and PINS are read; every other section is skipped unparsed.
+//
+// Components are matched to the netlist's cells by name while the file is
+// read and their locations land in arrays indexed by cell ID, so a
+// placement belongs to the database it was read against. The COMPONENTS
+// section is cut at statement boundaries and parsed in parallel. Placed
+// cells are indexed in an R-tree for region queries.
+class DefPlacement {
+public:
+    using Id = NetlistDb::Id;
+
+    enum class Status : uint8_t { Unplaced, Placed, Fixed, Cover };
+    enum class Orient : uint8_t { N, W, S, E, FN, FW, FS, FE };
+
+    // In database units, y up as in the file.
+    struct Rect {
+        int64_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        bool empty() const { return x1 <= x0 || y1 <= y0; }
+        bool contains(int64_t x, int64_t y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+    };
+
+    struct Pin {
+        std::string name;
+        std::string net;
+        int32_t x = 0, y = 0;
+        Status status = Status::Unplaced;
+    };
+
+    struct Stats {
+        size_t components = 0;
+        size_t matched = 0;     // components naming a netlist cell
+        size_t unmatched = 0;
+        std::vector<std::string> unmatched_names;  // the first few
+        double seconds = 0;
+    };
+
+    // Reads `file` against `db`. False with `error` set when the file
+    // cannot be read or has no DEF sections at all; components the netlist
+    // lacks are only counted.
+    bool read(const std::string& file, const NetlistDb& db, std::string& error);
+
+    int dbuPerMicron() const { return dbu_per_micron_; }
+    // DIEAREA, or the placed cells' extent when the file has none.
+    const Rect& dieArea() const { return die_; }
+    // Distance between neighbouring rows; 0 when the file has no rows.
+    int64_t rowPitch() const { return row_pitch_; }
+    const Stats& stats() const { return stats_; }
+
+    size_t cellCount() const { return status_.size(); }
+    size_t placedCount() const { return placed_.size(); }
+    bool placed(Id cell) const { return status_[cell] != Status::Unplaced; }
+    Status status(Id cell) const { return status_[cell]; }
+    int32_t x(Id cell) const { return x_[cell]; }
+    int32_t y(Id cell) const { return y_[cell]; }
+    Orient orient(Id cell) const { return orient_[cell]; }
+    const std::vector<Pin>& pins() const { return pins_; }
+
+    // Calls fn(cell) for every placed cell whose location lies in `area`,
+    // in no particular order.
+    template <class F>
+    void within(const Rect& area, F&& fn) const;
+
+    size_t memoryBytes() const;
+
+private:
+    int dbu_per_micron_ = 1000;
+    Rect die_;
+    int64_t row_pitch_ = 0;
+    Stats stats_;
+
+    std::vector<int32_t> x_;
+    std::vector<int32_t> y_;
+    std::vector<Orient> orient_;
+    std::vector<Status> status_;
+    std::vector<Id> placed_;  // R-tree entry IDs to cells
+    RTree index_;
+    std::vector<Pin> pins_;
+};
+
+template <class F>
+void DefPlacement::within(const Rect& area, F&& fn) const {
+    // Rounding to float keeps order, so the tree misses nothing inside;
+    // the exact test on the integer location drops what is just outside.
+    const RTree::Box box{static_cast<float>(area.x0), static_cast<float>(area.y0), static_cast<float>(area.x1),
+                         static_cast<float>(area.y1)};
+    index_.query(box, [&](uint32_t entry) {
+        const Id cell = placed_[entry];
+        if (area.contains(x_[cell], y_[cell])) fn(cell);
+    });
+}
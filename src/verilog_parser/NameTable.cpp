@@ -0,0 +1,97 @@
+// File: src/verilog_parser/NameTable.cpp
+
+#include "NameTable.h"
+
+#include <algorithm>
+#include <functional>
+
+uint32_t NameTable::hashOf(std::string_view name) {
+    const size_t h = std::hash<std::string_view>()(name);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+const char* NameTable::store(std::string_view name) {
+    const uint32_t len = static_cast<uint32_t>(name.size());
+    char* p = static_cast<char*>(chars_.allocate(sizeof(len) + len, alignof(uint32_t)));
+    std::memcpy(p, &len, sizeof(len));
+    std::memcpy(p + sizeof(len), name.data(), len);
+    return p;
+}
+
+void NameTable::rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.assign(capacity, Slot());
+    const size_t mask = capacity - 1;
+    for (const Slot& s : old) {
+        if (s.id == kNone) continue;
+        size_t i = s.hash & mask;
+        while (slots_[i].id != kNone) i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
+size_t NameTable::probe(std::string_view text, uint32_t hash) {
+    const size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (true) {
+        ++probes_;
+        const Slot& s = slots_[i];
+        if (s.id == kNone || (s.hash == hash && name(s.id) == text)) return i;
+        i = (i + 1) & mask;
+    }
+}
+
+uint32_t NameTable::intern(std::string_view text) {
+    if ((indexed_ + 1) * 2 > slots_.size()) rehash(std::max<size_t>(64, slots_.size() * 2));
+    const uint32_t hash = hashOf(text);
+    Slot& s = slots_[probe(text, hash)];
+    if (s.id != kNone) return s.id;
+
+    s.id = static_cast<uint32_t>(names_.size());
+    s.hash = hash;
+    names_.push_back(store(text));
+    ++indexed_;
+    return s.id;
+}
+
+uint32_t NameTable::append(std::string_view text) {
+    names_.push_back(store(text));
+    return static_cast<uint32_t>(names_.size() - 1);
+}
+
+void NameTable::buildIndex() {
+    size_t capacity = 64;
+    while (capacity < names_.size() * 2) capacity *= 2;
+    if (capacity > slots_.size()) rehash(capacity);
+
+    for (size_t id = indexed_; id < names_.size(); ++id) {
+        const std::string_view text = name(static_cast<uint32_t>(id));
+        const uint32_t hash = hashOf(text);
+        Slot& s = slots_[probe(text, hash)];
+        if (s.id == kNone) {
+            s.id = static_cast<uint32_t>(id);
+            s.hash = hash;
+        }
+    }
+    indexed_ = names_.size();
+}
+
+uint32_t NameTable::find(std::string_view text) const {
+    if (slots_.empty()) return kNone;
+    const uint32_t hash = hashOf(text);
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot& s = slots_[i];
+        if (s.id == kNone) return kNone;
+        if (s.hash == hash && name(s.id) == text) return s.id;
+    }
+}
+
+void NameTable::clear() {
+    chars_.reset();
+    names_ = std::vector<const char*>();
+    slots_ = std::vector<Slot>();
+    indexed_ = 0;
+    probes_ = 0;
+}
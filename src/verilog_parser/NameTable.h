@@ -0,0 +1,122 @@
+// File: src/verilog_parser/NameTable.h
+#pragma once
+
+#include "util/Arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+// Names numbered 0..size()-1. Characters live in an arena behind a 4-byte
+// length prefix, so each name costs one pointer in the table plus its text.
+// The index is an open-addressing table of (id, hash) pairs; there are no
+// per-name heap nodes.
+class NameTable {
+public:
+    static constexpr uint32_t kNone = 0xffffffffu;
+
+    // Returns the existing id of `name` or adds it.
+    uint32_t intern(std::string_view name);
+
+    // Adds `name` without looking it up; call buildIndex() before find().
+    // When a name is appended twice, find() returns the first id.
+    uint32_t append(std::string_view name);
+    void buildIndex();
+
+    uint32_t find(std::string_view name) const;
+
+    std::string_view name(uint32_t id) const {
+        const char* p = names_[id];
+        uint32_t len;
+        std::memcpy(&len, p, sizeof(len));
+        return std::string_view(p + sizeof(len), len);
+    }
+
+    size_t size() const { return names_.size(); }
+
+    void clear();
+
+    // Slots inspected by intern() and buildIndex() since the last clear().
+    uint64_t probes() const { return probes_; }
+
+    size_t nameBytes() const { return chars_.bytesReserved() + names_.capacity() * sizeof(const char*); }
+    size_t indexBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t id = kNone;
+        uint32_t hash = 0;
+    };
+
+    static uint32_t hashOf(std::string_view name);
+    const char* store(std::string_view name);
+    void rehash(size_t capacity);
+    // Slot holding `text`, or the empty slot where it would go.
+    size_t probe(std::string_view text, uint32_t hash);
+
+    Arena chars_{256 << 10};
+    std::vector<const char*> names_;
+    std::vector<Slot> slots_;
+    size_t indexed_ = 0;
+    uint64_t probes_ = 0;
+};
+
+// Names of a run of IDs in a NameTable, produced as string_views without
+// copying. The IDs are either first..first+size-1 or read from an ID
+// array. Views stay valid as long as the table is unchanged.
+class NameRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        iterator(const NameTable* table, const uint32_t* ids, uint32_t first, size_t index)
+            : table_(table), ids_(ids), first_(first), index_(index) {}
+        std::string_view operator*() const {
+            return table_->name(ids_ ? ids_[index_] : first_ + static_cast<uint32_t>(index_));
+        }
+        iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++index_;
+            return old;
+        }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const NameTable* table_;
+        const uint32_t* ids_;
+        uint32_t first_;
+        size_t index_;
+    };
+
+    NameRange() = default;
+    NameRange(const NameTable* table, uint32_t first, size_t size) : table_(table), first_(first), size_(size) {}
+    NameRange(const NameTable* table, const uint32_t* ids, size_t size) : table_(table), ids_(ids), size_(size) {}
+
+    std::string_view operator[](size_t i) const { return table_->name(id(i)); }
+    // ID of the i-th name in its table.
+    uint32_t id(size_t i) const { return ids_ ? ids_[i] : first_ + static_cast<uint32_t>(i); }
+
+    iterator begin() const { return iterator(table_, ids_, first_, 0); }
+    iterator end() const { return iterator(table_, ids_, first_, size_); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const NameTable* table_ = nullptr;
+    const uint32_t* ids_ = nullptr;
+    uint32_t first_ = 0;
+    size_t size_ = 0;
+};
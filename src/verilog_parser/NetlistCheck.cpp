@@ -0,0 +1,233 @@
+// File: src/verilog_parser/NetlistCheck.cpp
+
+#include "NetlistCheck.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+using Id = NetlistDb::Id;
+
+constexpr size_t kNetsPerChunk = 1 << 14;
+
+// Net roles that do not come from instance pins.
+enum NetFlag : uint8_t {
+    kInputPort = 1,
+    kOutputPort = 2,
+    kInoutPort = 4,
+    kWire = 8,
+    kBus = 16,
+    kPort = kInputPort | kOutputPort | kInoutPort,
+};
+
+// Net roles from assign statements.
+enum AssignFlag : uint8_t {
+    kAssignDriven = 1,
+    kAssignLoaded = 2,
+};
+
+// Bits of a bus are connected as "name[i]"; the bus net a bit belongs to,
+// or kNone.
+Id busOf(const NetlistDb& db, std::string_view name) {
+    if (name.size() < 3 || name.back() != ']' || name.front() == '\\') return NetlistDb::kNone;
+    const size_t open = name.rfind('[');
+    if (open == std::string_view::npos || open == 0) return NetlistDb::kNone;
+    return db.findNet(name.substr(0, open));
+}
+
+// Calls fn(net) for each net an assign side names: plain and escaped
+// names, bits as "a[3]", and whole buses or part selects through the bus.
+// Sized literals such as 4'b1010 name nothing.
+template <class F>
+void forEachNetIn(const NetlistDb& db, std::string_view expr, F&& fn) {
+    auto isWordChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$'; };
+    size_t i = 0;
+    while (i < expr.size()) {
+        const char c = expr[i];
+        const size_t begin = i;
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '\'') {
+            while (i < expr.size() && (isWordChar(expr[i]) || expr[i] == '\'' || expr[i] == '?')) ++i;
+            continue;
+        }
+        if (c == '\\') {
+            while (i < expr.size() && !std::isspace(static_cast<unsigned char>(expr[i]))) ++i;
+        } else if (isWordChar(c)) {
+            while (i < expr.size() && isWordChar(expr[i])) ++i;
+        } else {
+            ++i;
+            continue;
+        }
+        const std::string_view name = expr.substr(begin, i - begin);
+        size_t j = i;
+        while (j < expr.size() && std::isspace(static_cast<unsigned char>(expr[j]))) ++j;
+        const size_t close = j < expr.size() && expr[j] == '[' ? expr.find(']', j) : std::string_view::npos;
+        Id net = NetlistDb::kNone;
+        if (close != std::string_view::npos) {
+            const std::string_view select = expr.substr(j, close - j + 1);
+            if (select.find(':') == std::string_view::npos) net = db.findNet(std::string(name) + std::string(select));
+            i = close + 1;
+        }
+        if (net == NetlistDb::kNone) net = db.findNet(name);
+        if (net != NetlistDb::kNone) fn(net);
+    }
+}
+
+void appendList(std::string& out, const char* title, std::vector<Id> ids,
+                const std::function<bool(Id, Id)>& less, const std::function<void(std::string&, Id)>& text,
+                size_t max_items) {
+    if (ids.empty() || max_items == 0) return;
+    const size_t shown = std::min(max_items, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + shown, ids.end(), less);
+    out += title;
+    out += ":\n";
+    for (size_t i = 0; i < shown; ++i) {
+        out += "  ";
+        text(out, ids[i]);
+        out += '\n';
+    }
+    if (shown < ids.size()) out += "  ... " + std::to_string(ids.size() - shown) + " more\n";
+}
+
+void append(std::vector<Id>& to, const std::vector<Id>& from) {
+    to.insert(to.end(), from.begin(), from.end());
+}
+
+}  // namespace
+
+NetlistCheck NetlistCheck::run(const NetlistDb& db, const PinDirections& directions) {
+    TraceScope trace("check", "check_netlist");
+    const PinDirections::Table pin_dir = directions.resolve(db);
+
+    std::vector<uint8_t> flags(db.netCount(), 0);
+    for (size_t i = 0; i < db.ports().size(); ++i) {
+        switch (db.portDirection(i)) {
+            case PortDirection::Input:  flags[db.ports()[i]] |= kInputPort; break;
+            case PortDirection::Output: flags[db.ports()[i]] |= kOutputPort; break;
+            default:                    flags[db.ports()[i]] |= kInoutPort; break;
+        }
+        if (!db.portRange(i).empty()) flags[db.ports()[i]] |= kBus;
+    }
+    for (size_t i = 0; i < db.wires().size(); ++i)
+        flags[db.wires()[i]] |= db.wireRange(i).empty() ? kWire : kWire | kBus;
+    const Id unconnected = db.findNet("");
+    const size_t chunks = (db.netCount() + kNetsPerChunk - 1) / kNetsPerChunk;
+
+    // Bits take the role of their bus port. A bus without pins of its own is
+    // in use when any of its bits has a load or driver.
+    std::vector<Id> bus_of(db.netCount(), NetlistDb::kNone);
+    std::vector<uint8_t> bits_used(db.netCount(), 0);
+    {
+        std::vector<std::vector<Id>> used(chunks);
+        ThreadPool::instance().parallelFor(0, db.netCount(), kNetsPerChunk, [&](size_t b, size_t e) {
+            for (Id net = static_cast<Id>(b); net < e; ++net) {
+                bus_of[net] = busOf(db, db.netName(net));
+                if (bus_of[net] != NetlistDb::kNone && !db.netPins(net).empty())
+                    used[b / kNetsPerChunk].push_back(bus_of[net]);
+            }
+        });
+        for (const auto& u : used) {
+            for (Id bus : u) bits_used[bus] = 1;
+        }
+    }
+
+    // Assigns drive the nets on their left and load the ones on their right;
+    // a bus assigned as a whole does so for each of its bits.
+    std::vector<uint8_t> assigned(db.netCount(), 0);
+    for (size_t i = 0; i < db.assignCount(); ++i) {
+        forEachNetIn(db, db.assignLhs(i), [&](Id net) { assigned[net] |= kAssignDriven; });
+        forEachNetIn(db, db.assignRhs(i), [&](Id net) { assigned[net] |= kAssignLoaded; });
+    }
+
+    // Chunks are fixed, so each one fills its own slot and the merged lists
+    // come out in net ID order whatever the thread count.
+    std::vector<NetlistCheck> local(chunks);
+    ThreadPool::instance().parallelFor(0, db.netCount(), kNetsPerChunk, [&](size_t b, size_t e) {
+        NetlistCheck& out = local[b / kNetsPerChunk];
+        for (Id net = static_cast<Id>(b); net < e; ++net) {
+            const ArenaSpan<const Id> pins = db.netPins(net);
+            if (net == unconnected) {
+                out.unconnected_pins.assign(pins.begin(), pins.end());
+                continue;
+            }
+            if (!db.isSignalNet(net)) continue;
+            const uint8_t flag = flags[net] | (bus_of[net] == NetlistDb::kNone ? 0 : flags[bus_of[net]] & kPort);
+            if (pins.empty() && (flag & kBus) && bits_used[net]) continue;  // connected through its bits
+            ++out.checked_nets;
+
+            const uint8_t by_assign = assigned[net] | (bus_of[net] == NetlistDb::kNone ? 0 : assigned[bus_of[net]]);
+            if (pins.empty() && !by_assign && (flag & kWire) && !(flag & kPort)) {
+                out.unused_wires.push_back(net);
+                continue;
+            }
+            size_t drivers = (flag & kInputPort) || (by_assign & kAssignDriven) ? 1 : 0;
+            size_t loads = (flag & kOutputPort) || (by_assign & kAssignLoaded) ? 1 : 0;
+            size_t either = (flag & kInoutPort) ? 1 : 0;
+            for (Id pin : pins) {
+                switch (pin_dir.of(db, pin)) {
+                    case PortDirection::Output: ++drivers; break;
+                    case PortDirection::Inout:  ++either; break;
+                    default:                    ++loads; break;
+                }
+            }
+            if (drivers + either == 0)
+                out.undriven_nets.push_back(net);
+            else if (drivers > 1)
+                out.multidriven_nets.push_back(net);
+            if (drivers + either > 0 && loads + either == 0) out.unloaded_nets.push_back(net);
+        }
+    });
+
+    NetlistCheck result;
+    for (const auto& r : local) {
+        append(result.undriven_nets, r.undriven_nets);
+        append(result.multidriven_nets, r.multidriven_nets);
+        append(result.unloaded_nets, r.unloaded_nets);
+        append(result.unused_wires, r.unused_wires);
+        append(result.unconnected_pins, r.unconnected_pins);
+        result.checked_nets += r.checked_nets;
+    }
+    return result;
+}
+
+bool NetlistCheck::clean() const {
+    return undriven_nets.empty() && multidriven_nets.empty() && unloaded_nets.empty() && unused_wires.empty() &&
+           unconnected_pins.empty();
+}
+
+std::string NetlistCheck::toText(const NetlistDb& db, size_t max_items) const {
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "Checked %zu nets\n"
+                  "  Undriven nets:          %zu\n"
+                  "  Multiply driven nets:   %zu\n"
+                  "  Nets without loads:     %zu\n"
+                  "  Unused wires:           %zu\n"
+                  "  Unconnected pins:       %zu\n",
+                  checked_nets, undriven_nets.size(), multidriven_nets.size(), unloaded_nets.size(),
+                  unused_wires.size(), unconnected_pins.size());
+    std::string out = buf;
+    if (clean()) out += "No connectivity problems found.\n";
+
+    auto net_less = [&db](Id x, Id y) { return db.netName(x) < db.netName(y); };
+    auto net_text = [&db](std::string& s, Id n) { s += db.netName(n); };
+    auto pin_less = [&db](Id x, Id y) {
+        const int order = db.cellName(db.pinCell(x)).compare(db.cellName(db.pinCell(y)));
+        return order != 0 ? order < 0 : db.pinName(x) < db.pinName(y);
+    };
+    auto pin_text = [&db](std::string& s, Id p) {
+        s += db.cellName(db.pinCell(p));
+        s += '/';
+        s += db.pinName(p);
+    };
+    appendList(out, "Undriven nets", undriven_nets, net_less, net_text, max_items);
+    appendList(out, "Multiply driven nets", multidriven_nets, net_less, net_text, max_items);
+    appendList(out, "Nets without loads", unloaded_nets, net_less, net_text, max_items);
+    appendList(out, "Unused wires", unused_wires, net_less, net_text, max_items);
+    appendList(out, "Unconnected pins", unconnected_pins, pin_less, pin_text, max_items);
+    return out;
+}
@@ -0,0 +1,33 @@
+// File: src/verilog_parser/NetlistCheck.h
+#pragma once
+
+#include "NetlistDb.h"
+#include "PinDirections.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Structural lint of one design. Drivers of a net are output instance pins
+// and input ports; loads are input instance pins and output ports; inout
+// pins and ports count as either. Constant nets (1'b0, ...) are skipped.
+//
+// Every net is classified independently from its net-to-pin list, so the
+// check is one parallel pass over net IDs on the thread pool.
+struct NetlistCheck {
+    using Id = NetlistDb::Id;
+
+    std::vector<Id> undriven_nets;     // connected, but nothing drives them
+    std::vector<Id> multidriven_nets;  // more than one output or input port
+    std::vector<Id> unloaded_nets;     // driven, but nothing reads them
+    std::vector<Id> unused_wires;      // declared wires with no connection
+    std::vector<Id> unconnected_pins;  // instance pins tied to ()
+    size_t checked_nets = 0;
+
+    static NetlistCheck run(const NetlistDb& db, const PinDirections& directions);
+
+    bool clean() const;
+
+    // Summary plus up to `max_items` names per category, sorted by name.
+    std::string toText(const NetlistDb& db, size_t max_items) const;
+};
@@ -0,0 +1,134 @@
+// File: src/verilog_parser/NetlistComponents.cpp
+
+#include "NetlistComponents.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+using Id = NetlistDb::Id;
+
+constexpr size_t kNetsPerChunk = 1 << 12;
+
+// Lock-free disjoint sets. Roots only ever point to a smaller ID, so
+// concurrent unions cannot form a cycle.
+class ConcurrentUnionFind {
+public:
+    explicit ConcurrentUnionFind(size_t n) : parent_(new std::atomic<Id>[n]), size_(n) {
+        for (size_t i = 0; i < n; ++i) parent_[i].store(static_cast<Id>(i), std::memory_order_relaxed);
+    }
+
+    Id find(Id x) {
+        for (;;) {
+            Id p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) return x;
+            Id gp = parent_[p].load(std::memory_order_relaxed);
+            if (gp != p) parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    void unite(Id a, Id b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a < b) std::swap(a, b);
+            Id expected = a;
+            if (parent_[a].compare_exchange_weak(expected, b, std::memory_order_relaxed)) return;
+        }
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    std::unique_ptr<std::atomic<Id>[]> parent_;
+    size_t size_;
+};
+
+}  // namespace
+
+NetlistComponents NetlistComponents::compute(const NetlistDb& db, size_t max_fanout) {
+    TraceScope trace("analysis", "components");
+    ThreadPool& pool = ThreadPool::instance();
+    ConcurrentUnionFind sets(db.cellCount());
+
+    // Unconnected pins and tie-offs share one net name but connect nothing.
+    std::atomic<size_t> ignored{0};
+    pool.parallelFor(0, db.netCount(), kNetsPerChunk, [&](size_t b, size_t e) {
+        size_t local_ignored = 0;
+        for (Id net = static_cast<Id>(b); net < e; ++net) {
+            const ArenaSpan<const Id> pins = db.netPins(net);
+            if (pins.size() < 2) continue;
+            if (!db.isSignalNet(net)) continue;
+            if (max_fanout && pins.size() > max_fanout) {
+                ++local_ignored;
+                continue;
+            }
+            const Id first = db.pinCell(pins[0]);
+            for (size_t i = 1; i < pins.size(); ++i) sets.unite(first, db.pinCell(pins[i]));
+        }
+        ignored.fetch_add(local_ignored, std::memory_order_relaxed);
+    });
+
+    // Roots are the smallest instance ID of their set, so numbering roots
+    // in ID order gives stable component IDs.
+    NetlistComponents result;
+    result.ignored_nets = ignored.load();
+    result.component.resize(db.cellCount());
+    pool.parallelFor(0, db.cellCount(), 1 << 14, [&](size_t b, size_t e) {
+        for (Id c = static_cast<Id>(b); c < e; ++c) result.component[c] = sets.find(c);
+    });
+    std::vector<Id> dense(db.cellCount(), NetlistDb::kNone);
+    for (Id c = 0; c < db.cellCount(); ++c) {
+        Id root = result.component[c];
+        if (dense[root] == NetlistDb::kNone) {
+            dense[root] = static_cast<Id>(result.sizes.size());
+            result.sizes.push_back(0);
+        }
+        result.component[c] = dense[root];
+        ++result.sizes[dense[root]];
+    }
+    return result;
+}
+
+std::string NetlistComponents::toText(const NetlistDb& db, size_t max_items) const {
+    size_t singletons = 0;
+    for (size_t s : sizes) singletons += s == 1;
+
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "Instances:   %zu\n"
+                  "Components:  %zu (%zu single instances)\n",
+                  component.size(), count(), singletons);
+    std::string out = buf;
+    if (ignored_nets) out += "Ignored " + std::to_string(ignored_nets) + " high-fanout nets\n";
+
+    std::vector<Id> order(count());
+    for (Id i = 0; i < order.size(); ++i) order[i] = i;
+    const size_t shown = std::min(max_items, order.size());
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+                      [&](Id a, Id b) { return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : a < b; });
+    if (shown) out += "Largest components:\n";
+
+    // One representative instance per listed component: its first member.
+    std::vector<Id> first(count(), NetlistDb::kNone);
+    for (Id c = 0; c < component.size(); ++c) {
+        if (first[component[c]] == NetlistDb::kNone) first[component[c]] = c;
+    }
+    for (size_t i = 0; i < shown; ++i) {
+        const Id k = order[i];
+        std::snprintf(buf, sizeof(buf), "  %-8zu %6.2f%%  ", sizes[k],
+                      component.empty() ? 0.0 : 100.0 * sizes[k] / component.size());
+        out += buf;
+        out += db.cellName(first[k]);
+        out += '\n';
+    }
+    if (shown < count()) out += "  ... " + std::to_string(count() - shown) + " more\n";
+    return out;
+}
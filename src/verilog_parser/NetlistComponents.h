@@ -0,0 +1,31 @@
+// File: src/verilog_parser/NetlistComponents.h
+#pragma once
+
+#include "NetlistDb.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Connected components of the instance/net incidence graph: two instances
+// are in one component when a chain of nets joins them. Nets with more
+// than `max_fanout` pins (clock, reset, scan enable) can be left out so
+// they do not glue the whole design together.
+//
+// Built with a lock-free union-find: every net links the instances on it
+// in a parallel pass over net IDs, with compare-and-swap on the parent
+// array and path halving on the way up.
+struct NetlistComponents {
+    using Id = NetlistDb::Id;
+
+    std::vector<Id> component;  // per instance, dense component ID
+    std::vector<size_t> sizes;  // instances per component
+    size_t ignored_nets = 0;    // skipped for exceeding max_fanout
+
+    static NetlistComponents compute(const NetlistDb& db, size_t max_fanout = 0);
+
+    size_t count() const { return sizes.size(); }
+
+    // Component count, size spread and the `max_items` largest components.
+    std::string toText(const NetlistDb& db, size_t max_items) const;
+};
@@ -0,0 +1,122 @@
+// File: src/verilog_parser/NetlistCone.cpp
+
+#include "NetlistCone.h"
+#include "util/Tracer.h"
+
+#include <map>
+
+namespace {
+
+using Id = NetlistDb::Id;
+constexpr Id kNone = NetlistDb::kNone;
+
+}  // namespace
+
+NetlistCone::NetlistCone(const NetlistDb& db, const NetlistPath::Endpoint& seed, PinDirections::Table directions,
+                         const Options& options)
+    : seed_(seed), directions_(std::move(directions)), options_(options) {
+    fanin_.forward = false;
+    if (seed.kind == NetlistPath::Kind::Net) {
+        queue(fanin_, seed.id);
+        queue(fanout_, seed.id);
+        return;
+    }
+    index_.emplace(seed.id, 0);
+    cells_.push_back(seed.id);
+    levels_.push_back(0);
+    if (seed.pin == kNone) {
+        startFrom(db, seed.id, fanin_);
+        startFrom(db, seed.id, fanout_);
+        return;
+    }
+    // An inout pin is its own side both ways.
+    const PortDirection dir = directions_.of(db, seed.pin);
+    if (dir != PortDirection::Output) queue(fanin_, db.pinNet(seed.pin));
+    if (dir != PortDirection::Input) queue(fanout_, db.pinNet(seed.pin));
+    if (dir == PortDirection::Output) startFrom(db, seed.id, fanin_);
+    if (dir == PortDirection::Input) startFrom(db, seed.id, fanout_);
+}
+
+bool NetlistCone::enters(const NetlistDb& db, Id pin, bool forward) const {
+    const PortDirection dir = directions_.of(db, pin);
+    if (dir == PortDirection::Inout) return true;
+    return forward == (dir != PortDirection::Output);
+}
+
+void NetlistCone::queue(Side& side, Id net) {
+    uint8_t& crossed = nets_[net];
+    const uint8_t bit = side.forward ? 1 : 2;
+    if (crossed & bit) return;
+    crossed |= bit;
+    side.frontier.push_back(net);
+}
+
+void NetlistCone::startFrom(const NetlistDb& db, Id cell, Side& side) {
+    for (Id pin = db.pinBegin(cell); pin < db.pinEnd(cell); ++pin) {
+        if (enters(db, pin, !side.forward)) queue(side, db.pinNet(pin));
+    }
+}
+
+size_t NetlistCone::step(const NetlistDb& db, Side& side) {
+    std::vector<Id> nets;
+    nets.swap(side.frontier);
+    ++side.level;
+    const int level = side.forward ? side.level : -side.level;
+    const size_t first = cells_.size();
+    for (Id net : nets) {
+        const auto pins = db.netPins(net);
+        if (!db.isSignalNet(net)) continue;
+        if (options_.max_fanout != 0 && pins.size() > options_.max_fanout) continue;
+        for (Id pin : pins) {
+            const Id cell = db.pinCell(pin);
+            if (!enters(db, pin, side.forward) || index_.count(cell)) continue;
+            if (options_.max_cells != 0 && cells_.size() >= options_.max_cells) {
+                truncated_ = true;
+                break;
+            }
+            index_.emplace(cell, static_cast<Id>(cells_.size()));
+            cells_.push_back(cell);
+            levels_.push_back(level);
+        }
+    }
+    for (size_t i = first; i < cells_.size(); ++i) startFrom(db, cells_[i], side);
+    return cells_.size() - first;
+}
+
+size_t NetlistCone::grow(const NetlistDb& db, int fanin, int fanout) {
+    TraceScope trace("analysis", "cone");
+    // Both sides take turns so a cell limit cuts them off evenly.
+    size_t added = 0;
+    while (!truncated_ && (fanin_.level < fanin || fanout_.level < fanout)) {
+        if (fanin_.level < fanin) added += step(db, fanin_);
+        if (!truncated_ && fanout_.level < fanout) added += step(db, fanout_);
+    }
+    return added;
+}
+
+NetlistCone::Id NetlistCone::indexOf(Id cell) const {
+    const auto it = index_.find(cell);
+    return it == index_.end() ? kNone : it->second;
+}
+
+std::string NetlistCone::toText(const NetlistDb& db) const {
+    std::string seed;
+    if (seed_.kind == NetlistPath::Kind::Net) {
+        seed = db.netName(seed_.id);
+    } else {
+        seed = db.cellName(seed_.id);
+        if (seed_.pin != kNone) {
+            seed += '/';
+            seed += db.pinName(seed_.pin);
+        }
+    }
+    std::string out = "Cone of " + seed + ": " + std::to_string(cells_.size()) + " instances, " +
+                      std::to_string(nets_.size()) + " nets (fanin " + std::to_string(fanin_.level) +
+                      " levels, fanout " + std::to_string(fanout_.level) + " levels)\n";
+    std::map<int, size_t> perLevel;
+    for (int level : levels_) ++perLevel[level];
+    for (const auto& [level, count] : perLevel)
+        out += "  level " + std::to_string(level) + ": " + std::to_string(count) + " instances\n";
+    if (truncated_) out += "  stopped at " + std::to_string(options_.max_cells) + " instances\n";
+    return out;
+}
@@ -0,0 +1,87 @@
+// File: src/verilog_parser/NetlistCone.h
+#pragma once
+
+#include "NetlistDb.h"
+#include "NetlistPath.h"
+#include "PinDirections.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The neighbourhood of a seed along signal flow: the cells up to some
+// number of logic levels before it (fanin) and after it (fanout).
+//
+// Both sides grow one level at a time from a frontier of nets. Visited
+// cells and nets live in hash tables sized by the cone, not arrays sized
+// by the design, so a cone costs the same in any design and one more
+// level costs only the cells it adds.
+class NetlistCone {
+public:
+    using Id = NetlistDb::Id;
+
+    struct Options {
+        size_t max_fanout = 64;  // larger nets end the cone instead of crossing it; 0 crosses all
+        size_t max_cells = 0;    // stop growing at this many cells; 0 is no limit
+    };
+
+    // A cell seed is level 0 and its cones start on its output and input
+    // nets. A pin seed starts its own side on the pin's net and the other
+    // side on the cell's pins of the other direction. A net seed has no
+    // level 0; its drivers and loads are levels -1 and 1.
+    NetlistCone(const NetlistDb& db, const NetlistPath::Endpoint& seed, PinDirections::Table directions,
+                const Options& options);
+
+    // Grows to `fanin` levels back and `fanout` forward. Levels already
+    // reached are kept and only the new ones are walked. Returns the
+    // number of cells added.
+    size_t grow(const NetlistDb& db, int fanin, int fanout);
+
+    const NetlistPath::Endpoint& seed() const { return seed_; }
+    const Options& options() const { return options_; }
+    const PinDirections::Table& directions() const { return directions_; }
+    int faninLevels() const { return fanin_.level; }
+    int fanoutLevels() const { return fanout_.level; }
+    bool truncated() const { return truncated_; }
+
+    // Cells in the order reached, so each level is a range and a cone
+    // grown further starts with the cells of the smaller one.
+    const std::vector<Id>& cells() const { return cells_; }
+    // Negative for fanin, 0 for the seed cell, positive for fanout.
+    int level(size_t index) const { return levels_[index]; }
+    // Position of `cell` in cells(), or NetlistDb::kNone.
+    Id indexOf(Id cell) const;
+    size_t netCount() const { return nets_.size(); }
+
+    // Seed, size, and the cell count of every level.
+    std::string toText(const NetlistDb& db) const;
+
+private:
+    struct Side {
+        std::vector<Id> frontier;  // nets the next level is reached through
+        int level = 0;
+        bool forward = true;
+    };
+
+    // Whether going `forward` a pin takes the cone into its cell. Leaving
+    // a cell one way is entering it the other.
+    bool enters(const NetlistDb& db, Id pin, bool forward) const;
+    void queue(Side& side, Id net);
+    // Queues the nets `cell` leaves through on `side`.
+    void startFrom(const NetlistDb& db, Id cell, Side& side);
+    size_t step(const NetlistDb& db, Side& side);
+
+    NetlistPath::Endpoint seed_;
+    PinDirections::Table directions_;
+    Options options_;
+    Side fanin_;
+    Side fanout_;
+    std::vector<Id> cells_;
+    std::vector<int> levels_;
+    std::unordered_map<Id, Id> index_;
+    // Per net: bit 0 once crossed forward, bit 1 once crossed backward.
+    std::unordered_map<Id, uint8_t> nets_;
+    bool truncated_ = false;
+};
@@ -0,0 +1,154 @@
+// File: src/verilog_parser/NetlistDb.cpp
+
+#include "NetlistDb.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+void NetlistDb::reserve(size_t cells, size_t pins) {
+    cell_master_ = arena_.allocateArray<Id>(cells);
+    pin_offset_ = arena_.allocateArray<Id>(cells + 1);
+    pin_name_ = arena_.allocateArray<Id>(pins);
+    pin_net_ = arena_.allocateArray<Id>(pins);
+    pin_cell_ = arena_.allocateArray<Id>(pins);
+    pin_offset_[0] = 0;
+}
+
+void NetlistDb::setModuleName(std::string_view name) {
+    module_ = arena_.copy(name);
+}
+
+void NetlistDb::addPort(std::string_view name) {
+    ports_.push_back(nets_.intern(name));
+    port_dir_.push_back(PortDirection::Unknown);
+    port_range_.push_back(kNone);
+}
+
+void NetlistDb::addPortDeclaration(std::string_view name, std::string_view range, PortDirection direction) {
+    port_decls_.push_back({nets_.intern(name), rangeId(range), direction});
+}
+
+void NetlistDb::addWire(std::string_view name, std::string_view range) {
+    wires_.push_back(nets_.intern(name));
+    wire_range_.push_back(rangeId(range));
+}
+
+NetlistDb::Id NetlistDb::addCell(std::string_view name, std::string_view master) {
+    const Id cell = cells_.append(name);
+    cell_master_[cell] = masters_.intern(master);
+    pin_offset_[cell + 1] = static_cast<Id>(pin_count_);
+    return cell;
+}
+
+void NetlistDb::addPin(std::string_view pin, std::string_view net) {
+    pin_name_[pin_count_] = pin_names_.intern(pin);
+    pin_net_[pin_count_] = nets_.intern(net);
+    pin_cell_[pin_count_] = static_cast<Id>(cells_.size() - 1);
+    ++pin_count_;
+    pin_offset_[cells_.size()] = static_cast<Id>(pin_count_);
+}
+
+void NetlistDb::setCellParameters(std::string_view params) {
+    if (!params.empty()) cell_params_.emplace_back(static_cast<Id>(cells_.size() - 1), texts_.intern(params));
+}
+
+void NetlistDb::addAssign(std::string_view lhs, std::string_view rhs) {
+    assigns_.push_back({texts_.intern(lhs), texts_.intern(rhs)});
+}
+
+std::string_view NetlistDb::cellParameters(Id cell) const {
+    auto it = std::lower_bound(cell_params_.begin(), cell_params_.end(), std::make_pair(cell, Id(0)));
+    return it != cell_params_.end() && it->first == cell ? texts_.name(it->second) : std::string_view();
+}
+
+void NetlistDb::finish() {
+    cells_.buildIndex();
+
+    // Direction declarations may come before or after the module header.
+    std::unordered_map<Id, size_t> port_of_net;
+    for (size_t i = 0; i < ports_.size(); ++i) port_of_net.emplace(ports_[i], i);
+    for (const auto& decl : port_decls_) {
+        auto it = port_of_net.find(decl.net);
+        if (it == port_of_net.end()) continue;
+        port_dir_[it->second] = decl.direction;
+        port_range_[it->second] = decl.range;
+    }
+    port_decls_ = std::vector<PortDeclaration>();
+
+    // Net-to-pin index: count, prefix-sum, scatter. Scattering in pin order
+    // keeps each net's pins sorted by cell.
+    const size_t nets = nets_.size();
+    net_pin_offset_ = arena_.allocateArray<Id>(nets + 1);
+    net_pins_ = arena_.allocateArray<Id>(pin_count_);
+    std::fill(net_pin_offset_, net_pin_offset_ + nets + 1, 0);
+    for (size_t p = 0; p < pin_count_; ++p) ++net_pin_offset_[pin_net_[p] + 1];
+    for (size_t n = 0; n < nets; ++n) net_pin_offset_[n + 1] += net_pin_offset_[n];
+    std::vector<Id> fill(net_pin_offset_, net_pin_offset_ + nets);
+    for (size_t p = 0; p < pin_count_; ++p) net_pins_[fill[pin_net_[p]]++] = static_cast<Id>(p);
+}
+
+void NetlistDb::clear() {
+    cells_.clear();
+    nets_.clear();
+    pin_names_.clear();
+    masters_.clear();
+    ranges_.clear();
+    texts_.clear();
+    module_ = std::string_view();
+    ports_ = std::vector<Id>();
+    port_dir_ = std::vector<PortDirection>();
+    port_range_ = std::vector<Id>();
+    wires_ = std::vector<Id>();
+    wire_range_ = std::vector<Id>();
+    port_decls_ = std::vector<PortDeclaration>();
+    cell_params_ = std::vector<std::pair<Id, Id>>();
+    assigns_ = std::vector<Assign>();
+    arena_.reset();
+    cell_master_ = pin_offset_ = pin_name_ = pin_net_ = pin_cell_ = nullptr;
+    net_pin_offset_ = net_pins_ = nullptr;
+    pin_count_ = 0;
+}
+
+bool NetlistDb::isSignalNet(Id net) const {
+    const std::string_view name = netName(net);
+    if (name.empty()) return false;
+    return !(name.front() >= '0' && name.front() <= '9' && name.find('\'') != std::string_view::npos);
+}
+
+NetlistDb::Id NetlistDb::findPin(Id cell, std::string_view name) const {
+    // Cells have a handful of pins; a scan beats any index here.
+    for (Id p = pinBegin(cell); p < pinEnd(cell); ++p) {
+        if (pinName(p) == name) return p;
+    }
+    return kNone;
+}
+
+NameRange NetlistDb::pinNamesOf(std::string_view cell) const {
+    Id c = findCell(cell);
+    return c == kNone ? NameRange() : pinNames(c);
+}
+
+std::string_view NetlistDb::netOfPin(std::string_view cell, std::string_view pin) const {
+    Id c = findCell(cell);
+    if (c == kNone) return {};
+    Id p = findPin(c, pin);
+    return p == kNone ? std::string_view() : netName(pinNet(p));
+}
+
+uint64_t NetlistDb::hashProbes() const {
+    return cells_.probes() + nets_.probes() + pin_names_.probes() + masters_.probes();
+}
+
+MemoryUsage NetlistDb::memoryUsage() const {
+    MemoryUsage usage;
+    usage.names = cells_.nameBytes() + nets_.nameBytes() + pin_names_.nameBytes() + masters_.nameBytes() +
+                  ranges_.nameBytes() + texts_.nameBytes();
+    usage.connectivity = arena_.bytesReserved() +
+                         (ports_.capacity() + port_range_.capacity() + wires_.capacity() + wire_range_.capacity()) *
+                             sizeof(Id) +
+                         port_dir_.capacity() * sizeof(PortDirection) +
+                         cell_params_.capacity() * sizeof(cell_params_[0]) + assigns_.capacity() * sizeof(Assign);
+    usage.indexes = cells_.indexBytes() + nets_.indexBytes() + pin_names_.indexBytes() + masters_.indexBytes() +
+                    ranges_.indexBytes() + texts_.indexBytes();
+    return usage;
+}
@@ -0,0 +1,160 @@
+// File: src/verilog_parser/NetlistDb.h
+#pragma once
+
+#include "NameTable.h"
+#include "NetlistTokenizer.h"
+#include "util/Arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Bytes held by each part of the database, as shown by report_memory.
+struct MemoryUsage {
+    size_t names = 0;         // name text and name tables
+    size_t connectivity = 0;  // per-pin ID arrays, port and wire lists
+    size_t indexes = 0;       // name lookup tables
+};
+
+// Compact storage for one loaded netlist. Once loaded it is never modified;
+// VerilogParser publishes it as an immutable snapshot. Cells, nets and pin names are
+// dense uint32 IDs; connectivity is a CSR layout where the pins of cell c
+// are pinBegin(c)..pinEnd(c)-1, each with a pin-name ID and a net ID.
+// finish() adds the reverse CSR from each net to its pins. The per-pin
+// arrays are sized once and live in an arena, so the whole design is
+// released in one go by clear().
+class NetlistDb {
+public:
+    using Id = uint32_t;
+    static constexpr Id kNone = NameTable::kNone;
+
+    // Loading. Cells and pins are added in order; reserve() must cover the
+    // totals before the first addCell().
+    void reserve(size_t cells, size_t pins);
+    void setModuleName(std::string_view name);
+    void addPort(std::string_view name);
+    void addPortDeclaration(std::string_view name, std::string_view range, PortDirection direction);
+    void addWire(std::string_view name, std::string_view range = {});
+    Id addCell(std::string_view name, std::string_view master);
+    void addPin(std::string_view pin, std::string_view net);  // on the last added cell
+    void setCellParameters(std::string_view params);        // on the last added cell
+    void addAssign(std::string_view lhs, std::string_view rhs);
+    void finish();
+
+    void clear();
+
+    std::string_view moduleName() const { return module_; }
+
+    size_t cellCount() const { return cells_.size(); }
+    std::string_view cellName(Id cell) const { return cells_.name(cell); }
+    Id findCell(std::string_view name) const { return cells_.find(name); }
+
+    // Library cell names; cells of the same master share one master ID.
+    size_t masterCount() const { return masters_.size(); }
+    Id cellMasterId(Id cell) const { return cell_master_[cell]; }
+    std::string_view cellMaster(Id cell) const { return masters_.name(cell_master_[cell]); }
+    std::string_view masterName(Id master) const { return masters_.name(master); }
+    // The "(...)" of `master #(...) name`, as written; empty for most cells.
+    std::string_view cellParameters(Id cell) const;
+
+    // Continuous assignments `assign lhs = rhs;`, sides as written.
+    size_t assignCount() const { return assigns_.size(); }
+    std::string_view assignLhs(size_t i) const { return texts_.name(assigns_[i].lhs); }
+    std::string_view assignRhs(size_t i) const { return texts_.name(assigns_[i].rhs); }
+
+    // Every net name seen, declared or only connected (ports, undeclared nets).
+    size_t netCount() const { return nets_.size(); }
+    std::string_view netName(Id net) const { return nets_.name(net); }
+    Id findNet(std::string_view name) const { return nets_.find(name); }
+    // False for sized literals such as 1'b0 and for "", the net of pins
+    // connected as `.A()`; connectivity queries do not follow those.
+    bool isSignalNet(Id net) const;
+
+    // Module ports and `wire` declarations in file order, as net IDs.
+    ArenaSpan<const Id> ports() const { return {ports_.data(), ports_.size()}; }
+    ArenaSpan<const Id> wires() const { return {wires_.data(), wires_.size()}; }
+    // Declared direction and "[msb:lsb]" range of ports()[i] / wires()[i].
+    PortDirection portDirection(size_t i) const { return port_dir_[i]; }
+    std::string_view portRange(size_t i) const { return rangeText(port_range_[i]); }
+    std::string_view wireRange(size_t i) const { return rangeText(wire_range_[i]); }
+
+    // Name views over the same data; valid until clear().
+    NameRange cellNames() const { return NameRange(&cells_, 0u, cells_.size()); }
+    NameRange portNames() const { return NameRange(&nets_, ports_.data(), ports_.size()); }
+    NameRange wireNames() const { return NameRange(&nets_, wires_.data(), wires_.size()); }
+    NameRange pinNames(Id cell) const {
+        return NameRange(&pin_names_, pin_name_ + pinBegin(cell), pinEnd(cell) - pinBegin(cell));
+    }
+
+    size_t pinCount() const { return pin_count_; }
+    Id pinBegin(Id cell) const { return pin_offset_[cell]; }
+    Id pinEnd(Id cell) const { return pin_offset_[cell + 1]; }
+    std::string_view pinName(Id pin) const { return pin_names_.name(pin_name_[pin]); }
+    // Pin names are shared across cells: A1, ZN, ...
+    Id pinNameId(Id pin) const { return pin_name_[pin]; }
+    size_t pinNameCount() const { return pin_names_.size(); }
+    std::string_view pinNameById(Id name) const { return pin_names_.name(name); }
+    Id pinNet(Id pin) const { return pin_net_[pin]; }
+    Id pinCell(Id pin) const { return pin_cell_[pin]; }
+    Id findPin(Id cell, std::string_view name) const;
+
+    // Pins on a net, in cell order. Built by finish().
+    ArenaSpan<const Id> netPins(Id net) const {
+        return {net_pins_ + net_pin_offset_[net], net_pin_offset_[net + 1] - net_pin_offset_[net]};
+    }
+
+    // Name-based lookups for the query commands; empty when not found.
+    NameRange pinNamesOf(std::string_view cell) const;
+    std::string_view netOfPin(std::string_view cell, std::string_view pin) const;
+
+    // Name and index lookups made while loading.
+    uint64_t hashProbes() const;
+
+    MemoryUsage memoryUsage() const;
+
+private:
+    std::string_view rangeText(Id range) const { return range == kNone ? std::string_view() : ranges_.name(range); }
+    Id rangeId(std::string_view range) { return range.empty() ? kNone : ranges_.intern(range); }
+
+    Arena arena_{64 << 10};
+    std::string_view module_;
+    NameTable cells_;
+    NameTable nets_;
+    NameTable pin_names_;
+    NameTable masters_;
+    NameTable ranges_;
+    NameTable texts_;  // parameter lists and assign sides
+
+    std::vector<Id> ports_;
+    std::vector<PortDirection> port_dir_;
+    std::vector<Id> port_range_;
+    std::vector<Id> wires_;
+    std::vector<Id> wire_range_;
+
+    struct PortDeclaration {
+        Id net;
+        Id range;
+        PortDirection direction;
+    };
+    std::vector<PortDeclaration> port_decls_;  // resolved against ports_ by finish()
+
+    Id* cell_master_ = nullptr;
+    std::vector<std::pair<Id, Id>> cell_params_;  // (cell, text), in cell order
+
+    struct Assign {
+        Id lhs;
+        Id rhs;
+    };
+    std::vector<Assign> assigns_;
+
+    Id* pin_offset_ = nullptr;  // cellCount() + 1 entries
+    Id* pin_name_ = nullptr;
+    Id* pin_net_ = nullptr;
+    Id* pin_cell_ = nullptr;
+    size_t pin_count_ = 0;
+
+    Id* net_pin_offset_ = nullptr;  // netCount() + 1 entries
+    Id* net_pins_ = nullptr;
+};
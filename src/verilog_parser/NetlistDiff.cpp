@@ -0,0 +1,249 @@
+// File: src/verilog_parser/NetlistDiff.cpp
+
+#include "NetlistDiff.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+namespace {
+
+using Id = NetlistDb::Id;
+
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t hashName(std::string_view name) {
+    return mix(std::hash<std::string_view>()(name));
+}
+
+// Name and connectivity hash of every instance and net of one design.
+// Connectivity hashes are sums of per-pin terms so pin order is irrelevant,
+// and they use names only so they compare across designs.
+struct Keys {
+    std::vector<uint64_t> cell_name;
+    std::vector<uint64_t> cell_conn;
+    std::vector<uint64_t> net_name;
+    std::vector<uint64_t> net_conn;
+};
+
+Keys computeKeys(const NetlistDb& db) {
+    TraceScope trace("diff", "hash");
+    Keys keys;
+    ThreadPool& pool = ThreadPool::instance();
+
+    keys.net_name.resize(db.netCount());
+    pool.parallelFor(0, db.netCount(), 1 << 14, [&](size_t b, size_t e) {
+        for (size_t n = b; n < e; ++n) keys.net_name[n] = hashName(db.netName(static_cast<Id>(n)));
+    });
+
+    std::vector<uint64_t> pin_name(db.pinNameCount());
+    for (Id i = 0; i < pin_name.size(); ++i) pin_name[i] = hashName(db.pinNameById(i));
+    std::vector<uint64_t> master(db.masterCount());
+    for (Id i = 0; i < master.size(); ++i) master[i] = hashName(db.masterName(i));
+
+    std::unique_ptr<std::atomic<uint64_t>[]> net_conn(new std::atomic<uint64_t>[db.netCount()]());
+    keys.cell_name.resize(db.cellCount());
+    keys.cell_conn.resize(db.cellCount());
+    pool.parallelFor(0, db.cellCount(), 1 << 12, [&](size_t b, size_t e) {
+        for (Id c = static_cast<Id>(b); c < e; ++c) {
+            const uint64_t name = hashName(db.cellName(c));
+            uint64_t conn = rotl(master[db.cellMasterId(c)], 7);
+            for (Id p = db.pinBegin(c); p < db.pinEnd(c); ++p) {
+                const uint64_t pin = pin_name[db.pinNameId(p)];
+                const Id net = db.pinNet(p);
+                conn += mix(pin ^ rotl(keys.net_name[net], 17));
+                net_conn[net].fetch_add(mix(name ^ rotl(pin, 29)), std::memory_order_relaxed);
+            }
+            keys.cell_name[c] = name;
+            keys.cell_conn[c] = mix(conn);
+        }
+    });
+
+    keys.net_conn.resize(db.netCount());
+    for (size_t n = 0; n < db.netCount(); ++n) keys.net_conn[n] = net_conn[n].load(std::memory_order_relaxed);
+    return keys;
+}
+
+// IDs grouped by the top bits of their name hash.
+struct Partitions {
+    std::vector<size_t> offsets;  // partition k is ids[offsets[k], offsets[k+1])
+    std::vector<Id> ids;
+};
+
+Partitions partition(const std::vector<uint64_t>& name_hash, int bits,
+                     const std::function<bool(Id)>& skip) {
+    const size_t parts = size_t(1) << bits;
+    Partitions result;
+    result.offsets.assign(parts + 1, 0);
+    for (Id i = 0; i < name_hash.size(); ++i) {
+        if (!skip(i)) ++result.offsets[(name_hash[i] >> (64 - bits)) + 1];
+    }
+    for (size_t k = 0; k < parts; ++k) result.offsets[k + 1] += result.offsets[k];
+    result.ids.resize(result.offsets[parts]);
+    std::vector<size_t> fill(result.offsets.begin(), result.offsets.end() - 1);
+    for (Id i = 0; i < name_hash.size(); ++i) {
+        if (!skip(i)) result.ids[fill[name_hash[i] >> (64 - bits)]++] = i;
+    }
+    return result;
+}
+
+struct MatchResult {
+    std::vector<Id> added;
+    std::vector<Id> removed;
+    std::vector<Id> rewired;
+    size_t matched = 0;
+};
+
+// Sort-merge join of each partition pair on (name hash, name).
+MatchResult match(const std::vector<uint64_t>& a_name, const std::vector<uint64_t>& a_conn,
+                  const std::function<std::string_view(Id)>& a_text, const std::vector<uint64_t>& b_name,
+                  const std::vector<uint64_t>& b_conn, const std::function<std::string_view(Id)>& b_text,
+                  const std::function<bool(Id)>& a_skip, const std::function<bool(Id)>& b_skip, int bits) {
+    Partitions pa = partition(a_name, bits, a_skip);
+    Partitions pb = partition(b_name, bits, b_skip);
+    const size_t parts = size_t(1) << bits;
+
+    std::vector<MatchResult> local(parts);
+    ThreadPool::instance().parallelFor(0, parts, 1, [&](size_t k, size_t) {
+        auto a_begin = pa.ids.begin() + pa.offsets[k], a_end = pa.ids.begin() + pa.offsets[k + 1];
+        auto b_begin = pb.ids.begin() + pb.offsets[k], b_end = pb.ids.begin() + pb.offsets[k + 1];
+        std::sort(a_begin, a_end, [&](Id x, Id y) {
+            return a_name[x] != a_name[y] ? a_name[x] < a_name[y] : a_text(x) < a_text(y);
+        });
+        std::sort(b_begin, b_end, [&](Id x, Id y) {
+            return b_name[x] != b_name[y] ? b_name[x] < b_name[y] : b_text(x) < b_text(y);
+        });
+
+        MatchResult& out = local[k];
+        auto ia = a_begin, ib = b_begin;
+        while (ia != a_end || ib != b_end) {
+            int order;
+            if (ia == a_end) order = 1;
+            else if (ib == b_end) order = -1;
+            else if (a_name[*ia] != b_name[*ib]) order = a_name[*ia] < b_name[*ib] ? -1 : 1;
+            else order = a_text(*ia).compare(b_text(*ib));
+
+            if (order < 0) {
+                out.removed.push_back(*ia++);
+            } else if (order > 0) {
+                out.added.push_back(*ib++);
+            } else {
+                ++out.matched;
+                if (a_conn[*ia] != b_conn[*ib]) out.rewired.push_back(*ia);
+                ++ia;
+                ++ib;
+            }
+        }
+    });
+
+    MatchResult result;
+    for (auto& r : local) {
+        result.added.insert(result.added.end(), r.added.begin(), r.added.end());
+        result.removed.insert(result.removed.end(), r.removed.begin(), r.removed.end());
+        result.rewired.insert(result.rewired.end(), r.rewired.begin(), r.rewired.end());
+        result.matched += r.matched;
+    }
+    return result;
+}
+
+void appendList(std::string& out, const char* title, std::vector<Id> ids,
+                const std::function<std::string_view(Id)>& text, size_t max_items) {
+    if (ids.empty() || max_items == 0) return;
+    const size_t shown = std::min(max_items, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + shown, ids.end(),
+                      [&](Id x, Id y) { return text(x) < text(y); });
+    out += title;
+    out += ":\n";
+    for (size_t i = 0; i < shown; ++i) {
+        out += "  ";
+        out += text(ids[i]);
+        out += '\n';
+    }
+    if (shown < ids.size()) out += "  ... " + std::to_string(ids.size() - shown) + " more\n";
+}
+
+}  // namespace
+
+NetlistDiff NetlistDiff::compare(const NetlistDb& a, const NetlistDb& b, int num_threads) {
+    TraceScope trace("diff", "compare");
+    // Hash both designs at once; each pass is itself data-parallel.
+    Keys ka, kb;
+    ThreadPool::instance().parallelFor(0, 2, 1, [&](size_t i, size_t) {
+        if (i == 0)
+            ka = computeKeys(a);
+        else
+            kb = computeKeys(b);
+    });
+
+    int bits = 4;
+    while ((1 << bits) < num_threads * 8 && bits < 12) ++bits;
+
+    NetlistDiff diff;
+    {
+        TraceScope match_trace("diff", "match cells");
+        auto none = [](Id) { return false; };
+        MatchResult cells = match(
+            ka.cell_name, ka.cell_conn, [&a](Id c) { return a.cellName(c); }, kb.cell_name, kb.cell_conn,
+            [&b](Id c) { return b.cellName(c); }, none, none, bits);
+        diff.added_cells = std::move(cells.added);
+        diff.removed_cells = std::move(cells.removed);
+        diff.rewired_cells = std::move(cells.rewired);
+        diff.matched_cells = cells.matched;
+    }
+    {
+        // Unconnected pins share the empty net name; it is not a real net.
+        TraceScope match_trace("diff", "match nets");
+        MatchResult nets = match(
+            ka.net_name, ka.net_conn, [&a](Id n) { return a.netName(n); }, kb.net_name, kb.net_conn,
+            [&b](Id n) { return b.netName(n); }, [&a](Id n) { return a.netName(n).empty(); },
+            [&b](Id n) { return b.netName(n).empty(); }, bits);
+        diff.added_nets = std::move(nets.added);
+        diff.removed_nets = std::move(nets.removed);
+        diff.rewired_nets = std::move(nets.rewired);
+        diff.matched_nets = nets.matched;
+    }
+    return diff;
+}
+
+bool NetlistDiff::identical() const {
+    return added_cells.empty() && removed_cells.empty() && rewired_cells.empty() && added_nets.empty() &&
+           removed_nets.empty() && rewired_nets.empty();
+}
+
+std::string NetlistDiff::toText(const NetlistDb& a, const NetlistDb& b, size_t max_items) const {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "Instances: %zu matched, %zu added, %zu removed, %zu rewired\n"
+                  "Nets:      %zu matched, %zu added, %zu removed, %zu rewired\n",
+                  matched_cells, added_cells.size(), removed_cells.size(), rewired_cells.size(), matched_nets,
+                  added_nets.size(), removed_nets.size(), rewired_nets.size());
+    std::string out = buf;
+    if (identical()) out += "Netlists are structurally identical.\n";
+
+    auto a_cell = [&a](Id c) { return a.cellName(c); };
+    auto b_cell = [&b](Id c) { return b.cellName(c); };
+    auto a_net = [&a](Id n) { return a.netName(n); };
+    auto b_net = [&b](Id n) { return b.netName(n); };
+    appendList(out, "Added instances", added_cells, b_cell, max_items);
+    appendList(out, "Removed instances", removed_cells, a_cell, max_items);
+    appendList(out, "Rewired instances", rewired_cells, a_cell, max_items);
+    appendList(out, "Added nets", added_nets, b_net, max_items);
+    appendList(out, "Removed nets", removed_nets, a_net, max_items);
+    appendList(out, "Rewired nets", rewired_nets, a_net, max_items);
+    return out;
+}
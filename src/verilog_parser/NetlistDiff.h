@@ -0,0 +1,36 @@
+// File: src/verilog_parser/NetlistDiff.h
+#pragma once
+
+#include "NetlistDb.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Structural difference between two designs. Instances and nets are matched
+// by name. An instance is rewired when its master or any pin-to-net
+// connection changed; a net is rewired when the set of (instance, pin) it
+// connects changed.
+//
+// Every instance and net gets a name hash and a connectivity hash in one
+// parallel pass. Both designs are then scattered into hash partitions that
+// are sorted and merge-joined independently on the thread pool.
+struct NetlistDiff {
+    using Id = NetlistDb::Id;
+
+    std::vector<Id> added_cells;     // IDs in b
+    std::vector<Id> removed_cells;   // IDs in a
+    std::vector<Id> rewired_cells;   // IDs in a
+    std::vector<Id> added_nets;      // IDs in b
+    std::vector<Id> removed_nets;    // IDs in a
+    std::vector<Id> rewired_nets;    // IDs in a
+    size_t matched_cells = 0;
+    size_t matched_nets = 0;
+
+    static NetlistDiff compare(const NetlistDb& a, const NetlistDb& b, int num_threads);
+
+    bool identical() const;
+
+    // Summary plus up to `max_items` names per category, sorted by name.
+    std::string toText(const NetlistDb& a, const NetlistDb& b, size_t max_items) const;
+};
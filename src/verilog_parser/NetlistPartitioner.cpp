@@ -0,0 +1,620 @@
+// File: src/verilog_parser/NetlistPartitioner.cpp
+
+#include "NetlistPartitioner.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+
+namespace {
+
+using Id = NetlistDb::Id;
+constexpr Id kNone = NetlistDb::kNone;
+
+constexpr size_t kGrain = 1 << 12;
+constexpr size_t kCoarsestPerPart = 40;  // stop coarsening near this many vertices per part
+constexpr size_t kRatingEdgeLimit = 64;  // larger nets do not steer matching
+constexpr int kInitialTries = 8;
+constexpr int kRefineRounds = 8;
+
+// Hypergraph in both directions: the pins of edge e are
+// edge_pins[edge_offset[e], edge_offset[e + 1]), the edges of vertex v
+// are vertex_edges[vertex_offset[v], vertex_offset[v + 1]).
+struct Hypergraph {
+    std::vector<uint32_t> vertex_weight;
+    std::vector<Id> edge_offset;
+    std::vector<Id> edge_pins;
+    std::vector<uint32_t> edge_weight;
+    std::vector<Id> vertex_offset;
+    std::vector<Id> vertex_edges;
+
+    size_t vertexCount() const { return vertex_weight.size(); }
+    size_t edgeCount() const { return edge_weight.size(); }
+    const Id* pinsBegin(Id e) const { return edge_pins.data() + edge_offset[e]; }
+    const Id* pinsEnd(Id e) const { return edge_pins.data() + edge_offset[e + 1]; }
+    size_t edgeSize(Id e) const { return edge_offset[e + 1] - edge_offset[e]; }
+    const Id* edgesBegin(Id v) const { return vertex_edges.data() + vertex_offset[v]; }
+    const Id* edgesEnd(Id v) const { return vertex_edges.data() + vertex_offset[v + 1]; }
+};
+
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Fills the vertex-to-edge side from the edge lists. Vertex lists are
+// sorted afterwards so the result does not depend on thread timing.
+void buildIncidence(Hypergraph& h) {
+    ThreadPool& pool = ThreadPool::instance();
+    const size_t n = h.vertexCount();
+    std::unique_ptr<std::atomic<Id>[]> cursor(new std::atomic<Id>[n + 1]());
+    pool.parallelFor(0, h.edgeCount(), kGrain, [&](size_t b, size_t e) {
+        for (Id edge = static_cast<Id>(b); edge < e; ++edge) {
+            for (const Id* p = h.pinsBegin(edge); p != h.pinsEnd(edge); ++p)
+                cursor[*p + 1].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    h.vertex_offset.assign(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) h.vertex_offset[v + 1] = h.vertex_offset[v] + cursor[v + 1].load();
+    for (size_t v = 0; v < n; ++v) cursor[v].store(h.vertex_offset[v], std::memory_order_relaxed);
+
+    h.vertex_edges.resize(h.vertex_offset[n]);
+    pool.parallelFor(0, h.edgeCount(), kGrain, [&](size_t b, size_t e) {
+        for (Id edge = static_cast<Id>(b); edge < e; ++edge) {
+            for (const Id* p = h.pinsBegin(edge); p != h.pinsEnd(edge); ++p)
+                h.vertex_edges[cursor[*p].fetch_add(1, std::memory_order_relaxed)] = edge;
+        }
+    });
+    pool.parallelFor(0, n, kGrain, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v)
+            std::sort(h.vertex_edges.begin() + h.vertex_offset[v], h.vertex_edges.begin() + h.vertex_offset[v + 1]);
+    });
+}
+
+// Edges of `size[e]` pins each, laid out back to back; edges of size 0 are
+// dropped. fill(e, out) writes the pins of kept edge e.
+template <class Fill>
+void buildEdges(Hypergraph& h, const std::vector<Id>& size, const std::vector<uint32_t>& weight, Fill&& fill) {
+    std::vector<Id> kept;
+    h.edge_offset.assign(1, 0);
+    for (Id e = 0; e < size.size(); ++e) {
+        if (!size[e]) continue;
+        kept.push_back(e);
+        h.edge_offset.push_back(h.edge_offset.back() + size[e]);
+        h.edge_weight.push_back(weight.empty() ? 1 : weight[e]);
+    }
+    h.edge_pins.resize(h.edge_offset.back());
+    ThreadPool::instance().parallelFor(0, kept.size(), kGrain, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) fill(kept[i], h.edge_pins.data() + h.edge_offset[i]);
+    });
+}
+
+// Instances are vertices; every usable net with two or more instances is
+// an edge. A net's pins come in cell order, so repeats are adjacent.
+Hypergraph fromNetlist(const NetlistDb& db, size_t max_fanout) {
+    Hypergraph h;
+    h.vertex_weight.assign(db.cellCount(), 1);
+    std::vector<Id> size(db.netCount(), 0);
+    ThreadPool::instance().parallelFor(0, db.netCount(), kGrain, [&](size_t b, size_t e) {
+        for (Id net = static_cast<Id>(b); net < e; ++net) {
+            const ArenaSpan<const Id> pins = db.netPins(net);
+            if (pins.size() < 2 || !db.isSignalNet(net)) continue;
+            if (max_fanout && pins.size() > max_fanout) continue;
+            Id distinct = 1;
+            for (size_t i = 1; i < pins.size(); ++i) distinct += db.pinCell(pins[i]) != db.pinCell(pins[i - 1]);
+            if (distinct >= 2) size[net] = distinct;
+        }
+    });
+    buildEdges(h, size, {}, [&](Id net, Id* out) {
+        const ArenaSpan<const Id> pins = db.netPins(net);
+        *out++ = db.pinCell(pins[0]);
+        for (size_t i = 1; i < pins.size(); ++i) {
+            if (db.pinCell(pins[i]) != db.pinCell(pins[i - 1])) *out++ = db.pinCell(pins[i]);
+        }
+    });
+    buildIncidence(h);
+    return h;
+}
+
+// One coarsening step: every vertex rates its neighbours by the nets they
+// share (small nets count more, heavy vertices less), then vertices join
+// their best neighbour's cluster while the cluster stays under
+// `max_weight`. Returns false when the graph barely shrinks.
+bool coarsen(const Hypergraph& h, uint64_t max_weight, Hypergraph& coarse, std::vector<Id>& map) {
+    ThreadPool& pool = ThreadPool::instance();
+    const size_t n = h.vertexCount();
+
+    // Dense rating arrays, one per chunk running at a time. A chunk takes a
+    // free one and hands it back, so no more are built than there are
+    // threads, and all of them go when this level is done.
+    struct Scratch {
+        std::vector<float> score;
+        std::vector<Id> touched;
+    };
+    std::mutex scratch_mutex;
+    std::vector<std::unique_ptr<Scratch>> free_scratch;
+
+    std::vector<Id> prefer(n, kNone);
+    pool.parallelFor(0, n, kGrain, [&](size_t b, size_t e) {
+        std::unique_ptr<Scratch> scratch;
+        {
+            std::lock_guard<std::mutex> lock(scratch_mutex);
+            if (!free_scratch.empty()) {
+                scratch = std::move(free_scratch.back());
+                free_scratch.pop_back();
+            }
+        }
+        if (!scratch) {
+            scratch = std::make_unique<Scratch>();
+            scratch->score.assign(n, 0.0f);
+        }
+        std::vector<float>& score = scratch->score;
+        std::vector<Id>& touched = scratch->touched;
+        for (Id u = static_cast<Id>(b); u < e; ++u) {
+            for (const Id* edge = h.edgesBegin(u); edge != h.edgesEnd(u); ++edge) {
+                const size_t size = h.edgeSize(*edge);
+                if (size > kRatingEdgeLimit) continue;
+                const float w = static_cast<float>(h.edge_weight[*edge]) / static_cast<float>(size - 1);
+                for (const Id* v = h.pinsBegin(*edge); v != h.pinsEnd(*edge); ++v) {
+                    if (*v == u) continue;
+                    if (score[*v] == 0.0f) touched.push_back(*v);
+                    score[*v] += w;
+                }
+            }
+            Id best = kNone;
+            float best_rating = 0.0f;
+            for (Id v : touched) {
+                if (h.vertex_weight[u] + h.vertex_weight[v] <= max_weight) {
+                    const float rating = score[v] / (static_cast<float>(h.vertex_weight[u]) * h.vertex_weight[v]);
+                    if (rating > best_rating || (rating == best_rating && v < best)) {
+                        best = v;
+                        best_rating = rating;
+                    }
+                }
+                score[v] = 0.0f;
+            }
+            touched.clear();
+            prefer[u] = best;
+        }
+        std::lock_guard<std::mutex> lock(scratch_mutex);
+        free_scratch.push_back(std::move(scratch));
+    });
+
+    map.assign(n, kNone);
+    std::vector<uint64_t> cluster_weight;
+    Id lonely = kNone;  // last vertex without any edge, waiting for a partner
+    for (Id u = 0; u < n; ++u) {
+        if (map[u] != kNone) continue;
+        const Id v = prefer[u];
+        if (v != kNone && map[v] == kNone) {
+            map[u] = map[v] = static_cast<Id>(cluster_weight.size());
+            cluster_weight.push_back(h.vertex_weight[u] + h.vertex_weight[v]);
+            continue;
+        }
+        if (v != kNone && cluster_weight[map[v]] + h.vertex_weight[u] <= max_weight) {
+            map[u] = map[v];
+            cluster_weight[map[v]] += h.vertex_weight[u];
+            continue;
+        }
+        if (h.vertex_offset[u] == h.vertex_offset[u + 1]) {
+            if (lonely != kNone && cluster_weight[map[lonely]] + h.vertex_weight[u] <= max_weight) {
+                map[u] = map[lonely];
+                cluster_weight[map[u]] += h.vertex_weight[u];
+                lonely = kNone;
+                continue;
+            }
+            lonely = u;
+        }
+        map[u] = static_cast<Id>(cluster_weight.size());
+        cluster_weight.push_back(h.vertex_weight[u]);
+    }
+    if (cluster_weight.size() > n - n / 10) return false;
+
+    coarse = Hypergraph();
+    coarse.vertex_weight.assign(cluster_weight.begin(), cluster_weight.end());
+
+    // Map every edge's pins, drop repeats and edges left inside a cluster.
+    std::vector<Id> pins(h.edge_pins.size());
+    std::vector<Id> size(h.edgeCount(), 0);
+    std::vector<uint64_t> key(h.edgeCount(), 0);
+    pool.parallelFor(0, h.edgeCount(), kGrain, [&](size_t b, size_t e) {
+        for (Id edge = static_cast<Id>(b); edge < e; ++edge) {
+            Id* first = pins.data() + h.edge_offset[edge];
+            Id* last = first;
+            for (const Id* p = h.pinsBegin(edge); p != h.pinsEnd(edge); ++p) *last++ = map[*p];
+            std::sort(first, last);
+            const Id distinct = static_cast<Id>(std::unique(first, last) - first);
+            if (distinct < 2) continue;
+            size[edge] = distinct;
+            uint64_t hash = distinct;
+            for (const Id* p = first; p != first + distinct; ++p) hash = mix(hash ^ *p);
+            key[edge] = hash;
+        }
+    });
+
+    // Nets that now join the same clusters become one edge with the summed
+    // weight. Edges are bucketed by hash and each bucket is sorted and
+    // scanned on its own.
+    std::vector<uint32_t> weight(h.edge_weight);
+    {
+        constexpr int kBits = 8;
+        std::vector<size_t> offset((1 << kBits) + 1, 0);
+        for (Id edge = 0; edge < h.edgeCount(); ++edge) {
+            if (size[edge]) ++offset[(key[edge] >> (64 - kBits)) + 1];
+        }
+        for (size_t k = 0; k < (1 << kBits); ++k) offset[k + 1] += offset[k];
+        std::vector<Id> bucketed(offset.back());
+        std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+        for (Id edge = 0; edge < h.edgeCount(); ++edge) {
+            if (size[edge]) bucketed[fill[key[edge] >> (64 - kBits)]++] = edge;
+        }
+        auto same = [&](Id a, Id b) {
+            return size[a] == size[b] && std::equal(pins.data() + h.edge_offset[a],
+                                                    pins.data() + h.edge_offset[a] + size[a],
+                                                    pins.data() + h.edge_offset[b]);
+        };
+        pool.parallelFor(0, size_t(1) << kBits, 1, [&](size_t k, size_t) {
+            auto first = bucketed.begin() + offset[k], last = bucketed.begin() + offset[k + 1];
+            std::sort(first, last, [&](Id a, Id b) { return key[a] != key[b] ? key[a] < key[b] : a < b; });
+            for (auto rep = first; rep != last;) {
+                auto it = rep + 1;
+                for (; it != last && key[*it] == key[*rep]; ++it) {
+                    if (!same(*rep, *it)) continue;  // hash collision; keep both
+                    weight[*rep] += weight[*it];
+                    size[*it] = 0;
+                }
+                rep = it;
+            }
+        });
+    }
+
+    buildEdges(coarse, size, weight, [&](Id edge, Id* out) {
+        std::copy_n(pins.data() + h.edge_offset[edge], size[edge], out);
+    });
+    buildIncidence(coarse);
+    return true;
+}
+
+// Pins per part of every edge larger than the part count, where looking
+// the parts up beats scanning the pins.
+class PinCounts {
+public:
+    PinCounts(const Hypergraph& h, const std::vector<uint32_t>& part, int parts)
+        : h_(h), parts_(static_cast<size_t>(parts)), row_(h.edgeCount(), kNone) {
+        Id rows = 0;
+        for (Id e = 0; e < h.edgeCount(); ++e) {
+            if (h.edgeSize(e) > parts_) row_[e] = rows++;
+        }
+        count_.assign(size_t(rows) * parts_, 0);
+        ThreadPool::instance().parallelFor(0, h.edgeCount(), kGrain, [&](size_t b, size_t e) {
+            for (Id edge = static_cast<Id>(b); edge < e; ++edge) {
+                if (row_[edge] == kNone) continue;
+                uint32_t* counts = &count_[size_t(row_[edge]) * parts_];
+                for (const Id* p = h.pinsBegin(edge); p != h.pinsEnd(edge); ++p) ++counts[part[*p]];
+            }
+        });
+    }
+
+    // Counts of `edge` by part, or null when the edge is not counted.
+    const uint32_t* of(Id edge) const { return row_[edge] == kNone ? nullptr : &count_[size_t(row_[edge]) * parts_]; }
+
+    void move(Id v, uint32_t from, uint32_t to) {
+        for (const Id* edge = h_.edgesBegin(v); edge != h_.edgesEnd(v); ++edge) {
+            if (row_[*edge] == kNone) continue;
+            --count_[size_t(row_[*edge]) * parts_ + from];
+            ++count_[size_t(row_[*edge]) * parts_ + to];
+        }
+    }
+
+private:
+    const Hypergraph& h_;
+    size_t parts_;
+    std::vector<Id> row_;
+    std::vector<uint32_t> count_;
+};
+
+// Best single move of a vertex under the connectivity objective. For the
+// nets of v, A is the weight of nets where v is alone in its part (moving
+// it away removes that part from them) and W the total; moving to q costs
+// every net that does not reach q yet, so gain(q) = A - W + reach(q).
+class MoveFinder {
+public:
+    MoveFinder(const Hypergraph& h, const std::vector<uint32_t>& part, const PinCounts& counts, int parts)
+        : h_(h), part_(part), counts_(counts), parts_(static_cast<uint32_t>(parts)), reach_(parts, 0),
+          seen_(parts, 0) {}
+
+    struct Move {
+        uint32_t to = 0;
+        int64_t gain = 0;
+    };
+
+    Move best(Id v, const std::vector<uint64_t>& part_weight, uint64_t max_weight) {
+        const uint32_t from = part_[v];
+        int64_t alone = 0, total = 0;
+        for (const Id* edge = h_.edgesBegin(v); edge != h_.edgesEnd(v); ++edge) {
+            const int64_t w = h_.edge_weight[*edge];
+            total += w;
+            if (const uint32_t* counts = counts_.of(*edge)) {
+                for (uint32_t q = 0; q < parts_; ++q) {
+                    if (q == from || counts[q] == 0) continue;
+                    if (reach_[q] == 0) touched_.push_back(q);
+                    reach_[q] += w;
+                }
+                if (counts[from] == 1) alone += w;
+                continue;
+            }
+            if (++stamp_ == 0) {
+                std::fill(seen_.begin(), seen_.end(), 0);
+                stamp_ = 1;
+            }
+            for (const Id* p = h_.pinsBegin(*edge); p != h_.pinsEnd(*edge); ++p) {
+                if (*p == v) continue;
+                const uint32_t q = part_[*p];
+                if (seen_[q] == stamp_) continue;
+                seen_[q] = stamp_;
+                if (q == from) continue;
+                if (reach_[q] == 0) touched_.push_back(q);
+                reach_[q] += w;
+            }
+            if (seen_[from] != stamp_) alone += w;
+        }
+
+        Move move;
+        move.to = from;
+        for (uint32_t q : touched_) {
+            if (part_weight[q] + h_.vertex_weight[v] <= max_weight) {
+                const int64_t gain = alone - total + reach_[q];
+                if (gain > move.gain || (gain == move.gain && move.to != from && q < move.to)) {
+                    move.to = q;
+                    move.gain = gain;
+                }
+            }
+            reach_[q] = 0;
+        }
+        touched_.clear();
+        if (move.to == from) move.gain = 0;
+        return move;
+    }
+
+private:
+    const Hypergraph& h_;
+    const std::vector<uint32_t>& part_;
+    const PinCounts& counts_;
+    uint32_t parts_;
+    std::vector<int64_t> reach_;
+    std::vector<uint32_t> seen_;
+    std::vector<uint32_t> touched_;
+    uint32_t stamp_ = 0;
+};
+
+// Rounds of greedy moves. Candidates with a positive gain are found in
+// parallel against a frozen partition, then committed best-first, each one
+// re-rated against the moves already made. Stops once a round gains less
+// than a thousandth of the cost it started from.
+void refine(const Hypergraph& h, std::vector<uint32_t>& part, int parts, uint64_t max_weight) {
+    std::vector<uint64_t> part_weight(parts, 0);
+    for (Id v = 0; v < h.vertexCount(); ++v) part_weight[part[v]] += h.vertex_weight[v];
+    PinCounts counts(h, part, parts);
+    uint64_t edge_weight = 0;
+    for (uint32_t w : h.edge_weight) edge_weight += w;
+
+    struct Candidate {
+        int64_t gain;
+        Id vertex;
+    };
+    const size_t chunks = (h.vertexCount() + kGrain - 1) / kGrain;
+    for (int round = 0; round < kRefineRounds; ++round) {
+        std::vector<std::vector<Candidate>> found(chunks);
+        ThreadPool::instance().parallelFor(0, h.vertexCount(), kGrain, [&](size_t b, size_t e) {
+            MoveFinder finder(h, part, counts, parts);
+            for (Id v = static_cast<Id>(b); v < e; ++v) {
+                const MoveFinder::Move move = finder.best(v, part_weight, max_weight);
+                if (move.gain > 0) found[b / kGrain].push_back({move.gain, v});
+            }
+        });
+        std::vector<Candidate> candidates;
+        for (auto& f : found) candidates.insert(candidates.end(), f.begin(), f.end());
+        if (candidates.empty()) break;
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Candidate& a, const Candidate& b) { return a.gain > b.gain; });
+
+        MoveFinder finder(h, part, counts, parts);
+        int64_t improved = 0;
+        for (const Candidate& c : candidates) {
+            const MoveFinder::Move move = finder.best(c.vertex, part_weight, max_weight);
+            if (move.gain <= 0) continue;
+            const uint32_t from = part[c.vertex];
+            part_weight[from] -= h.vertex_weight[c.vertex];
+            part_weight[move.to] += h.vertex_weight[c.vertex];
+            part[c.vertex] = move.to;
+            counts.move(c.vertex, from, move.to);
+            improved += move.gain;
+        }
+        if (static_cast<uint64_t>(improved) * 1000 < edge_weight) break;
+    }
+}
+
+uint64_t connectivityOf(const Hypergraph& h, const std::vector<uint32_t>& part) {
+    uint64_t sum = 0;
+    std::vector<uint32_t> touched;
+    for (Id e = 0; e < h.edgeCount(); ++e) {
+        touched.clear();
+        for (const Id* p = h.pinsBegin(e); p != h.pinsEnd(e); ++p) touched.push_back(part[*p]);
+        std::sort(touched.begin(), touched.end());
+        sum += h.edge_weight[e] * (std::unique(touched.begin(), touched.end()) - touched.begin() - 1);
+    }
+    return sum;
+}
+
+// Grows the parts one after another, breadth-first from random seeds, each
+// to its share of what is left; the last part takes the rest.
+std::vector<uint32_t> growRegions(const Hypergraph& h, int parts, uint64_t seed) {
+    const size_t n = h.vertexCount();
+    constexpr uint32_t kUnassigned = ~0u;
+    std::vector<uint32_t> part(n, kUnassigned);
+    std::vector<Id> order(n);
+    for (Id v = 0; v < n; ++v) order[v] = v;
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+
+    uint64_t left = 0;
+    for (uint32_t w : h.vertex_weight) left += w;
+    size_t next_seed = 0;
+    std::vector<Id> queue;
+    for (int k = 0; k < parts - 1; ++k) {
+        const uint64_t target = left / static_cast<uint64_t>(parts - k);
+        uint64_t weight = 0;
+        queue.clear();
+        size_t head = 0;
+        while (weight < target) {
+            if (head == queue.size()) {
+                while (next_seed < n && part[order[next_seed]] != kUnassigned) ++next_seed;
+                if (next_seed == n) break;
+                queue.push_back(order[next_seed]);
+            }
+            const Id v = queue[head++];
+            if (part[v] != kUnassigned) continue;
+            part[v] = static_cast<uint32_t>(k);
+            weight += h.vertex_weight[v];
+            for (const Id* edge = h.edgesBegin(v); edge != h.edgesEnd(v); ++edge) {
+                if (h.edgeSize(*edge) > kRatingEdgeLimit) continue;
+                for (const Id* p = h.pinsBegin(*edge); p != h.pinsEnd(*edge); ++p) {
+                    if (part[*p] == kUnassigned) queue.push_back(*p);
+                }
+            }
+        }
+        left -= weight;
+    }
+    for (auto& p : part) {
+        if (p == kUnassigned) p = static_cast<uint32_t>(parts - 1);
+    }
+    return part;
+}
+
+}  // namespace
+
+NetlistPartition NetlistPartition::compute(const NetlistDb& db, int parts, double imbalance, size_t max_fanout) {
+    TraceScope trace("analysis", "partition");
+    parts = std::max(1, parts);
+    if (static_cast<size_t>(parts) > db.cellCount()) parts = static_cast<int>(std::max<size_t>(1, db.cellCount()));
+    NetlistPartition result;
+    const uint64_t total = db.cellCount();
+    const uint64_t max_weight = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil((1.0 + imbalance) * static_cast<double>(total) / parts)));
+
+    std::vector<Hypergraph> graphs;
+    std::vector<std::vector<Id>> maps;  // maps[i]: vertex of graphs[i] -> vertex of graphs[i + 1]
+    {
+        TraceScope coarsen_trace("analysis", "coarsen");
+        graphs.push_back(fromNetlist(db, max_fanout));
+        const size_t coarsest = static_cast<size_t>(parts) * kCoarsestPerPart;
+        const uint64_t max_cluster = std::max<uint64_t>(1, total / coarsest);
+        while (graphs.back().vertexCount() > coarsest) {
+            Hypergraph coarse;
+            std::vector<Id> map;
+            if (!coarsen(graphs.back(), max_cluster, coarse, map)) break;
+            graphs.push_back(std::move(coarse));
+            maps.push_back(std::move(map));
+        }
+    }
+
+    std::vector<uint32_t> part;
+    {
+        TraceScope initial_trace("analysis", "initial partition");
+        const Hypergraph& coarsest = graphs.back();
+        std::vector<std::vector<uint32_t>> tries(kInitialTries);
+        std::vector<uint64_t> cost(kInitialTries);
+        ThreadPool::instance().parallelFor(0, kInitialTries, 1, [&](size_t t, size_t) {
+            tries[t] = growRegions(coarsest, parts, 0x9e3779b97f4a7c15ULL * (t + 1));
+            refine(coarsest, tries[t], parts, max_weight);
+            cost[t] = connectivityOf(coarsest, tries[t]);
+        });
+        part = std::move(tries[std::min_element(cost.begin(), cost.end()) - cost.begin()]);
+    }
+    {
+        TraceScope refine_trace("analysis", "uncoarsen");
+        for (size_t level = maps.size(); level-- > 0;) {
+            std::vector<uint32_t> finer(graphs[level].vertexCount());
+            for (Id v = 0; v < finer.size(); ++v) finer[v] = part[maps[level][v]];
+            part = std::move(finer);
+            refine(graphs[level], part, parts, max_weight);
+        }
+    }
+    result.levels = graphs.size();
+    result.part = std::move(part);
+    result.part_sizes.assign(parts, 0);
+    for (uint32_t p : result.part) ++result.part_sizes[p];
+
+    // Score against every real net, including the ones left out above.
+    std::atomic<size_t> cut{0};
+    std::atomic<uint64_t> km1{0};
+    ThreadPool::instance().parallelFor(0, db.netCount(), kGrain, [&](size_t b, size_t e) {
+        std::vector<uint32_t> touched;
+        size_t local_cut = 0;
+        uint64_t local_km1 = 0;
+        for (Id net = static_cast<Id>(b); net < e; ++net) {
+            if (!db.isSignalNet(net)) continue;
+            touched.clear();
+            for (Id pin : db.netPins(net)) touched.push_back(result.part[db.pinCell(pin)]);
+            std::sort(touched.begin(), touched.end());
+            const size_t touches = std::unique(touched.begin(), touched.end()) - touched.begin();
+            if (touches > 1) {
+                ++local_cut;
+                local_km1 += touches - 1;
+            }
+        }
+        cut.fetch_add(local_cut, std::memory_order_relaxed);
+        km1.fetch_add(local_km1, std::memory_order_relaxed);
+    });
+    result.cut_nets = cut.load();
+    result.connectivity = km1.load();
+    return result;
+}
+
+std::string NetlistPartition::toText() const {
+    size_t smallest = part_sizes.empty() ? 0 : *std::min_element(part_sizes.begin(), part_sizes.end());
+    size_t largest = part_sizes.empty() ? 0 : *std::max_element(part_sizes.begin(), part_sizes.end());
+    const double average = part_sizes.empty() ? 0.0 : static_cast<double>(part.size()) / part_sizes.size();
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "Parts:        %zu (%zu levels)\n"
+                  "Instances:    %zu\n"
+                  "Part sizes:   %zu .. %zu (largest %+.2f%% of average)\n"
+                  "Cut nets:     %zu\n"
+                  "Connectivity: %llu\n",
+                  part_sizes.size(), levels, part.size(), smallest, largest,
+                  average > 0 ? 100.0 * (largest - average) / average : 0.0, cut_nets,
+                  static_cast<unsigned long long>(connectivity));
+    return buf;
+}
+
+bool NetlistPartition::write(const NetlistDb& db, const std::string& file_path) const {
+    std::FILE* out = std::fopen(file_path.c_str(), "w");
+    if (!out) {
+        std::cerr << "[ERROR] Failed to open file for writing: " << file_path << std::endl;
+        return false;
+    }
+    std::string buf;
+    for (Id c = 0; c < part.size(); ++c) {
+        buf += db.cellName(c);
+        buf += ' ';
+        buf += std::to_string(part[c]);
+        buf += '\n';
+        if (buf.size() >= (1u << 20)) {
+            std::fwrite(buf.data(), 1, buf.size(), out);
+            buf.clear();
+        }
+    }
+    std::fwrite(buf.data(), 1, buf.size(), out);
+    return std::fclose(out) == 0;
+}
@@ -0,0 +1,42 @@
+// File: src/verilog_parser/NetlistPartitioner.h
+#pragma once
+
+#include "NetlistDb.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Min-cut k-way partition of the instances, for splitting a design into
+// jobs that run in parallel downstream. Nets are hyperedges over the
+// instances they connect; the objective is the connectivity of every net
+// (parts it touches minus one) under a balance limit on instance counts.
+//
+// Multilevel scheme: instances are matched pairwise along heavy nets and
+// contracted until the hypergraph is small, the coarsest level is split
+// by growing regions from several seeds, and the split is projected back
+// level by level with greedy move refinement. Ratings, contraction, gains
+// and seeds run on the thread pool; only the matching and the commit of
+// moves are sequential.
+struct NetlistPartition {
+    using Id = NetlistDb::Id;
+
+    std::vector<uint32_t> part;       // per instance
+    std::vector<size_t> part_sizes;   // instances per part
+    size_t cut_nets = 0;              // nets touching more than one part
+    uint64_t connectivity = 0;        // sum over nets of (parts touched - 1)
+    size_t levels = 0;                // hypergraphs in the coarsening chain
+
+    // `imbalance` is the allowed excess of the largest part over the
+    // average, as a fraction. Nets with more than `max_fanout` pins are left
+    // out of the optimization but still counted in the result. `parts` is
+    // clamped to 1..cellCount(), so no part is ever empty by construction.
+    static NetlistPartition compute(const NetlistDb& db, int parts, double imbalance = 0.03,
+                                    size_t max_fanout = 1000);
+
+    std::string toText() const;
+
+    // One "instance part" line per instance.
+    bool write(const NetlistDb& db, const std::string& file_path) const;
+};
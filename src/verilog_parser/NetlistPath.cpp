@@ -0,0 +1,204 @@
+// File: src/verilog_parser/NetlistPath.cpp
+
+#include "NetlistPath.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+
+namespace {
+
+using Id = NetlistDb::Id;
+constexpr Id kNone = NetlistDb::kNone;
+constexpr Id kRoot = NetlistDb::kNone - 1;
+constexpr Id kBlocked = NetlistDb::kNone - 2;  // never entered by this side
+
+// One side of the search. Nodes are cells [0, cellCount()) followed by
+// nets; `via` holds the pin a node was reached through.
+struct Side {
+    std::vector<Id> via;
+    std::vector<uint32_t> depth;
+    std::vector<Id> frontier;
+    std::vector<Id> next;
+    uint32_t level = 0;
+    bool forward = true;
+};
+
+}  // namespace
+
+bool NetlistPath::resolve(const NetlistDb& db, std::string_view name, Endpoint& endpoint) {
+    endpoint = Endpoint();
+    if (name.empty()) return false;
+    const Id cell = db.findCell(name);
+    if (cell != kNone) {
+        endpoint.kind = Kind::Cell;
+        endpoint.id = cell;
+        return true;
+    }
+    const size_t slash = name.rfind('/');
+    if (slash != std::string_view::npos) {
+        const Id owner = db.findCell(name.substr(0, slash));
+        const Id pin = owner == kNone ? kNone : db.findPin(owner, name.substr(slash + 1));
+        if (pin != kNone) {
+            endpoint.kind = Kind::Cell;
+            endpoint.id = owner;
+            endpoint.pin = pin;
+            return true;
+        }
+    }
+    const Id net = db.findNet(name);
+    if (net == kNone) return false;
+    endpoint.kind = Kind::Net;
+    endpoint.id = net;
+    return true;
+}
+
+NetlistPath NetlistPath::find(const NetlistDb& db, const Endpoint& from, const Endpoint& to, const Options& options) {
+    TraceScope trace("analysis", "get_path");
+    const Id cells = static_cast<Id>(db.cellCount());
+    const size_t nodes = db.cellCount() + db.netCount();
+
+    // A pin endpoint starts the search on the pin's net.
+    auto nodeOf = [&](const Endpoint& e) -> Id {
+        if (e.kind == Kind::Net) return cells + e.id;
+        return e.pin == kNone ? e.id : cells + db.pinNet(e.pin);
+    };
+    const Id source = nodeOf(from);
+    const Id target = nodeOf(to);
+    auto otherEnd = [&](Id node, Id pin) { return node < cells ? cells + db.pinNet(pin) : db.pinCell(pin); };
+
+    auto usable = [&](Id net) {
+        if (cells + net == source || cells + net == target) return true;
+        if (!db.isSignalNet(net)) return false;
+        return options.max_fanout == 0 || db.netPins(net).size() <= options.max_fanout;
+    };
+    // Forward: out of cells through outputs, into cells through inputs.
+    // Backward: the other way round. Inout pins go both ways.
+    auto follows = [&](Id pin, bool into_cell, bool forward) {
+        if (!options.directions) return true;
+        const PortDirection dir = options.directions->of(db, pin);
+        if (dir == PortDirection::Inout) return true;
+        const bool output = dir == PortDirection::Output;
+        return forward == into_cell ? !output : output;
+    };
+
+    NetlistPath path;
+    Side f, b;
+    b.forward = false;
+    for (Side* s : {&f, &b}) {
+        s->via.assign(nodes, kNone);
+        s->depth.assign(nodes, 0);
+    }
+    // The cell of a pin endpoint is left or entered through that pin only.
+    if (from.kind == Kind::Cell && from.pin != kNone) f.via[from.id] = kBlocked;
+    if (to.kind == Kind::Cell && to.pin != kNone) b.via[to.id] = kBlocked;
+    f.via[source] = kRoot;
+    f.frontier.push_back(source);
+    b.via[target] = kRoot;
+    b.frontier.push_back(target);
+    path.visited = source == target ? 1 : 2;
+
+    Id meet = source == target ? source : kNone;
+    uint32_t best = ~0u;
+    auto expand = [&](Side& s, const Side& other) {
+        s.next.clear();
+        auto visit = [&](Id node, Id pin) {
+            if (s.via[node] != kNone) return;
+            s.via[node] = pin;
+            s.depth[node] = s.level + 1;
+            s.next.push_back(node);
+            ++path.visited;
+            if (other.via[node] == kNone || other.via[node] == kBlocked) return;
+            if (s.depth[node] + other.depth[node] < best) {
+                best = s.depth[node] + other.depth[node];
+                meet = node;
+            }
+        };
+        for (Id node : s.frontier) {
+            if (node < cells) {
+                for (Id pin = db.pinBegin(node); pin < db.pinEnd(node); ++pin) {
+                    if (usable(db.pinNet(pin)) && follows(pin, false, s.forward)) visit(cells + db.pinNet(pin), pin);
+                }
+            } else {
+                for (Id pin : db.netPins(node - cells)) {
+                    if (follows(pin, true, s.forward)) visit(db.pinCell(pin), pin);
+                }
+            }
+        }
+        ++s.level;
+        s.frontier.swap(s.next);
+    };
+    // A level that finds meets is finished before stopping, so the
+    // shortest of them wins.
+    while (meet == kNone && !f.frontier.empty() && !b.frontier.empty()) {
+        if (f.frontier.size() <= b.frontier.size())
+            expand(f, b);
+        else
+            expand(b, f);
+    }
+    if (meet == kNone) return path;
+
+    // Source to meeting point, then on to the target.
+    std::vector<std::pair<Id, Id>> route;  // (node, pin from the previous node)
+    for (Id node = meet; node != source;) {
+        const Id pin = f.via[node];
+        route.emplace_back(node, pin);
+        node = otherEnd(node, pin);
+    }
+    route.emplace_back(source, kNone);
+    std::reverse(route.begin(), route.end());
+    for (Id node = meet; node != target;) {
+        const Id pin = b.via[node];
+        node = otherEnd(node, pin);
+        route.emplace_back(node, pin);
+    }
+
+    if (from.kind == Kind::Cell && from.pin != kNone) {
+        path.steps.push_back({Kind::Cell, from.id, kNone});
+        route.front().second = from.pin;
+    }
+    for (const auto& [node, pin] : route) {
+        if (node < cells)
+            path.steps.push_back({Kind::Cell, node, pin});
+        else
+            path.steps.push_back({Kind::Net, node - cells, pin});
+    }
+    if (to.kind == Kind::Cell && to.pin != kNone) path.steps.push_back({Kind::Cell, to.id, to.pin});
+    return path;
+}
+
+size_t NetlistPath::cellCount() const {
+    return static_cast<size_t>(
+        std::count_if(steps.begin(), steps.end(), [](const Step& s) { return s.kind == Kind::Cell; }));
+}
+
+std::string NetlistPath::toText(const NetlistDb& db) const {
+    if (!found()) return "No path found (" + std::to_string(visited) + " cells and nets searched)\n";
+    std::string out = "Path: " + std::to_string(cellCount()) + " instances, " +
+                      std::to_string(steps.size() - cellCount()) + " nets (" + std::to_string(visited) +
+                      " cells and nets searched)\n";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const Step& step = steps[i];
+        out += "  ";
+        if (step.kind == Kind::Net) {
+            out += db.netName(step.id);
+            out += '\n';
+            continue;
+        }
+        out += db.cellName(step.id);
+        out += " (";
+        out += db.cellMaster(step.id);
+        out += ")";
+        const Id in = step.pin;
+        const Id out_pin = i + 1 < steps.size() ? steps[i + 1].pin : kNone;
+        if (in != kNone) {
+            out += ' ';
+            out += db.pinName(in);
+        }
+        if (out_pin != kNone) {
+            out += " -> ";
+            out += db.pinName(out_pin);
+        }
+        out += '\n';
+    }
+    return out;
+}
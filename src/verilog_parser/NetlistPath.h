@@ -0,0 +1,56 @@
+// File: src/verilog_parser/NetlistPath.h
+#pragma once
+
+#include "NetlistDb.h"
+#include "PinDirections.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shortest connection between two objects in the bipartite cell/net graph,
+// where every pin is an edge between its cell and its net.
+//
+// Bidirectional BFS: both ends grow one level at a time, always the
+// smaller frontier, until they meet. With directions, the forward side
+// only leaves cells through output pins and enters them through inputs,
+// and the backward side does the reverse, so the path follows signal flow.
+struct NetlistPath {
+    using Id = NetlistDb::Id;
+
+    enum class Kind { Cell, Net };
+
+    // A path endpoint: a cell, a pin (cell plus pin ID) or a net or port.
+    struct Endpoint {
+        Kind kind = Kind::Cell;
+        Id id = NetlistDb::kNone;
+        Id pin = NetlistDb::kNone;
+    };
+
+    // One object on the path; `pin` joins it to the previous step.
+    struct Step {
+        Kind kind;
+        Id id;
+        Id pin;
+    };
+
+    struct Options {
+        const PinDirections::Table* directions = nullptr;  // follow signal flow when set
+        size_t max_fanout = 0;                               // skip larger nets; 0 keeps all
+    };
+
+    std::vector<Step> steps;  // empty when there is no path
+    size_t visited = 0;       // cells and nets reached by both searches
+
+    // Looks `name` up as a cell, then as "cell/pin", then as a net.
+    static bool resolve(const NetlistDb& db, std::string_view name, Endpoint& endpoint);
+
+    static NetlistPath find(const NetlistDb& db, const Endpoint& from, const Endpoint& to, const Options& options);
+
+    bool found() const { return !steps.empty(); }
+    size_t cellCount() const;
+
+    // One line per step: cells with master and the pins used, then nets.
+    std::string toText(const NetlistDb& db) const;
+};
@@ -0,0 +1,385 @@
+// File: src/verilog_parser/NetlistTokenizer.cpp
+
+#include "NetlistTokenizer.h"
+#include <array>
+#include <cstring>
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Splits on whitespace. Escaped identifiers end at whitespace too, so they
+// come out as a single word.
+std::vector<std::string_view> splitWords(std::string_view s) {
+    std::vector<std::string_view> words;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && isSpace(s[i])) ++i;
+        size_t start = i;
+        while (i < s.size() && !isSpace(s[i])) ++i;
+        if (i > start) words.push_back(s.substr(start, i - start));
+    }
+    return words;
+}
+
+// Drops any leading `endmodule`, which has no terminating ';' and so ends up
+// in front of the next statement.
+void dropEndmodule(std::vector<std::string_view>& words) {
+    size_t n = 0;
+    while (n < words.size() && words[n] == "endmodule") ++n;
+    words.erase(words.begin(), words.begin() + n);
+}
+
+PortDirection directionOf(std::string_view keyword) {
+    if (keyword == "input") return PortDirection::Input;
+    if (keyword == "output") return PortDirection::Output;
+    if (keyword == "inout") return PortDirection::Inout;
+    return PortDirection::Unknown;
+}
+
+// Characters nextStatementBoundary() has to look at; it steps over the rest.
+constexpr std::array<bool, 256> kBoundarySpecial = [] {
+    std::array<bool, 256> table{};
+    for (unsigned char c : {'/', '*', '\\', '"', ';'}) table[c] = true;
+    return table;
+}();
+
+inline int countTrailingZeros(uint64_t v) {
+    return __builtin_ctzll(v);
+}
+
+inline int popCount(uint64_t v) {
+    return __builtin_popcountll(v);
+}
+
+}  // namespace
+
+NetlistTokenizer::NetlistTokenizer(const StructuralScanner& scanner, ParsedChunk& out)
+    : scanner_(scanner), out_(out) {}
+
+void NetlistTokenizer::tokenize(const char* data, size_t len) {
+    data_ = data;
+    len_ = len;
+    skip_until_ = 0;
+    stmt_begin_ = 0;
+    depth_ = 0;
+    in_pin_ = false;
+    stmt_ = Statement::None;
+    params_master_ = params_ = std::string_view();
+
+    StructuralBlock block;
+    for (size_t base = 0; base < len; base += 64) {
+        if (len - base >= 64)
+            scanner_.scanBlock(data + base, block);
+        else
+            scanner_.scanPartialBlock(data + base, len - base, block);
+        if (count_lines_) out_.lines += popCount(block.newline);
+
+        uint64_t mask = block.semicolon | block.open_paren | block.close_paren |
+                        block.dot | block.slash | block.backslash;
+        while (mask) {
+            size_t pos = base + countTrailingZeros(mask);
+            mask &= mask - 1;
+            if (pos >= skip_until_) onStructural(pos);
+        }
+    }
+}
+
+size_t NetlistTokenizer::nextStatementBoundary(const char* data, size_t len, size_t from, size_t pos) {
+    auto skipTo = [&](size_t i, char c) {
+        if (i >= len) return len;
+        const void* hit = std::memchr(data + i, c, len - i);
+        return hit ? static_cast<size_t>(static_cast<const char*>(hit) - data) : len;
+    };
+    size_t i = from;
+    while (i < len) {
+        switch (data[i]) {
+            case '/':
+                if (i + 1 < len && data[i + 1] == '/') {
+                    i = skipTo(i, '\n');
+                } else if (i + 1 < len && data[i + 1] == '*') {
+                    i += 2;
+                    while (i < len && !(data[i] == '*' && i + 1 < len && data[i + 1] == '/')) i = skipTo(i + 1, '*');
+                    i += 2;
+                } else {
+                    ++i;
+                }
+                break;
+            case '*':
+                // `(* attribute *)`; a lone '*' is an operator.
+                if (i > 0 && data[i - 1] == '(') {
+                    ++i;
+                    while (i < len && !(data[i] == '*' && i + 1 < len && data[i + 1] == ')')) i = skipTo(i + 1, '*');
+                    i += 2;
+                } else {
+                    ++i;
+                }
+                break;
+            case '\\':
+                while (i < len && !isSpace(data[i])) ++i;
+                break;
+            case '"':
+                i = skipTo(i + 1, '"') + 1;
+                break;
+            case ';': {
+                size_t j = i + 1;
+                while (j < len && (data[j] == ' ' || data[j] == '\t' || data[j] == '\r')) ++j;
+                if (j >= len) return len;
+                if (data[j] == '\n' && j + 1 >= pos) return j + 1;
+                i = j;
+                break;
+            }
+            default:
+                ++i;
+                while (i < len && !kBoundarySpecial[static_cast<unsigned char>(data[i])]) ++i;
+                break;
+        }
+    }
+    return len;
+}
+
+std::string_view NetlistTokenizer::text(size_t begin, size_t end) const {
+    return trim(std::string_view(data_ + begin, end - begin));
+}
+
+void NetlistTokenizer::onStructural(size_t pos) {
+    switch (data_[pos]) {
+        case '\\': {
+            size_t i = pos + 1;
+            while (i < len_ && !isSpace(data_[i])) ++i;
+            skip_until_ = i;
+            break;
+        }
+        case '/':
+            skipComment(pos);
+            break;
+        case ';':
+            endStatement(pos);
+            break;
+        case '(':
+            if (pos + 1 < len_ && data_[pos + 1] == '*')
+                skipComment(pos);  // (* attribute *)
+            else
+                openParen(pos);
+            break;
+        case ')':
+            closeParen(pos);
+            break;
+        case '.':
+            if (depth_ == 1 && stmt_ == Statement::Instance) {
+                in_pin_ = true;
+                pin_begin_ = pos + 1;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void NetlistTokenizer::skipComment(size_t pos) {
+    if (pos + 1 >= len_) return;
+    size_t end;
+    if (data_[pos] == '/' && data_[pos + 1] == '/') {
+        const void* nl = std::memchr(data_ + pos, '\n', len_ - pos);
+        end = nl ? static_cast<const char*>(nl) - data_ : len_;
+    } else if (data_[pos + 1] == '*') {
+        // Block comments end at */, attributes (* ... *) at *).
+        const char close = data_[pos] == '(' ? ')' : '/';
+        end = len_;
+        for (size_t i = pos + 2; i + 1 < len_; ++i) {
+            if (data_[i] == '*' && data_[i + 1] == close) {
+                end = i + 2;
+                break;
+            }
+        }
+    } else {
+        return;
+    }
+    skip_until_ = end;
+
+    // A comment ahead of a statement must not leak into its leading text.
+    if (stmt_ == Statement::None && text(stmt_begin_, pos).empty())
+        stmt_begin_ = end;
+}
+
+void NetlistTokenizer::openParen(size_t pos) {
+    if (depth_ == 0 && stmt_ == Statement::None) {
+        auto words = splitWords(std::string_view(data_ + stmt_begin_, pos - stmt_begin_));
+        dropEndmodule(words);
+        if (!words.empty() && words[0] == "module") {
+            stmt_ = Statement::Module;
+            if (words.size() > 1 && out_.module.empty()) out_.module = words[1];
+        } else if (params_master_.empty() && words.size() == 2 && words[1] == "#") {
+            // `master #(.W(4)) name (...)`: the instance name follows the
+            // parameter list, which is skipped.
+            stmt_ = Statement::Parameters;
+            params_master_ = words[0];
+        } else if (params_master_.empty() && words.size() == 1 && words[0].size() > 1 && words[0].back() == '#') {
+            stmt_ = Statement::Parameters;
+            params_master_ = words[0].substr(0, words[0].size() - 1);
+        } else if (!params_master_.empty() && words.size() == 1 && words[0].front() != '#') {
+            stmt_ = Statement::Instance;
+            out_.cells.push_back({params_master_, words[0], params_});
+        } else if (params_master_.empty() && words.size() == 2 && words[1].front() != '#') {
+            stmt_ = Statement::Instance;
+            out_.cells.push_back({words[0], words[1], {}});
+        } else {
+            stmt_ = Statement::Other;
+        }
+        list_begin_ = pos + 1;
+        depth_ = 1;
+        return;
+    }
+    if (depth_ == 1 && stmt_ == Statement::Instance && in_pin_) {
+        pin_ = text(pin_begin_, pos);
+        net_begin_ = pos + 1;
+    }
+    ++depth_;
+}
+
+void NetlistTokenizer::closeParen(size_t pos) {
+    if (depth_ == 0) return;
+    if (depth_ == 2 && stmt_ == Statement::Instance && in_pin_) {
+        out_.pins.push_back({static_cast<uint32_t>(out_.cells.size() - 1), pin_, text(net_begin_, pos)});
+        in_pin_ = false;
+    } else if (depth_ == 1 && stmt_ == Statement::Module) {
+        addPorts(std::string_view(data_ + list_begin_, pos - list_begin_));
+    }
+    --depth_;
+    if (depth_ == 0 && stmt_ == Statement::Parameters) {
+        // Back to the statement's leading words; the name comes next.
+        params_ = std::string_view(data_ + list_begin_ - 1, pos + 2 - list_begin_);
+        stmt_ = Statement::None;
+        stmt_begin_ = pos + 1;
+    }
+}
+
+void NetlistTokenizer::endStatement(size_t pos) {
+    ++out_.statements;
+    // An assign's right-hand side may hold parentheses, so it can look like
+    // an unknown construct by now.
+    if (stmt_ == Statement::None || stmt_ == Statement::Other) {
+        const std::string_view body(data_ + stmt_begin_, pos - stmt_begin_);
+        if (!addAssigns(body) && stmt_ == Statement::None) addDeclaration(body);
+    }
+
+    stmt_ = Statement::None;
+    depth_ = 0;
+    in_pin_ = false;
+    stmt_begin_ = pos + 1;
+    params_master_ = params_ = std::string_view();
+}
+
+void NetlistTokenizer::addDeclaration(std::string_view decl) {
+    auto words = splitWords(decl);
+    dropEndmodule(words);
+    if (words.empty()) return;
+
+    PortDirection direction = directionOf(words[0]);
+    bool is_wire = words[0] == "wire";
+    if (!is_wire && direction == PortDirection::Unknown) return;
+
+    // input [msb:lsb] a, b, \c[0] ;   also `output wire [3:0] d`
+    size_t first = (words[0].data() - decl.data()) + words[0].size();
+    std::string_view rest = trim(decl.substr(first));
+    if (!is_wire && rest.substr(0, 4) == "wire" && (rest.size() == 4 || isSpace(rest[4])))
+        rest = trim(rest.substr(4));
+    std::string_view range;
+    if (!rest.empty() && rest.front() == '[') {
+        size_t close = rest.find(']');
+        if (close == std::string_view::npos) return;
+        range = rest.substr(0, close + 1);
+        rest = rest.substr(close + 1);
+    }
+    addNames(rest, range, direction, is_wire);
+}
+
+bool NetlistTokenizer::addAssigns(std::string_view body) {
+    auto words = splitWords(body);
+    dropEndmodule(words);
+    if (words.empty() || words[0] != "assign") return false;
+
+    // assign a = b, \c = {d[1:0], 2'b01};   commas inside braces, brackets
+    // or parentheses and anything in an escaped name belong to one side.
+    std::string_view rest = body.substr((words[0].data() - body.data()) + words[0].size());
+    int depth = 0;
+    size_t begin = 0, equals = std::string_view::npos;
+    for (size_t i = 0; i <= rest.size(); ++i) {
+        const char c = i < rest.size() ? rest[i] : ',';
+        if (c == '\\') {
+            while (i < rest.size() && !isSpace(rest[i])) ++i;
+        } else if (c == '(' || c == '{' || c == '[') {
+            ++depth;
+        } else if (c == ')' || c == '}' || c == ']') {
+            --depth;
+        } else if (c == '=' && depth == 0 && equals == std::string_view::npos) {
+            equals = i;
+        } else if (c == ',' && (depth == 0 || i == rest.size())) {
+            if (equals != std::string_view::npos)
+                out_.assigns.push_back({trim(rest.substr(begin, equals - begin)),
+                                        trim(rest.substr(equals + 1, i - equals - 1))});
+            begin = i + 1;
+            equals = std::string_view::npos;
+        }
+    }
+    return true;
+}
+
+void NetlistTokenizer::addNames(std::string_view names, std::string_view range, PortDirection direction,
+                                bool is_wire) {
+    while (!names.empty()) {
+        size_t comma = names.find(',');
+        std::string_view name = trim(names.substr(0, comma));
+        if (!name.empty()) {
+            if (is_wire)
+                out_.nets.push_back({name, range, PortDirection::Unknown});
+            else
+                out_.port_decls.push_back({name, range, direction});
+        }
+        if (comma == std::string_view::npos) break;
+        names = names.substr(comma + 1);
+    }
+}
+
+void NetlistTokenizer::addPorts(std::string_view list) {
+    // Accepts both `module m(a, b)` and ANSI `module m(input [3:0] a, b,
+    // output c)`, where a name without a keyword inherits the previous one.
+    PortDirection direction = PortDirection::Unknown;
+    std::string_view range;
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view piece = list.substr(0, comma);
+        auto words = splitWords(piece);
+        if (!words.empty()) {
+            out_.ports.emplace_back(words.back());
+            if (words.size() > 1) {
+                direction = directionOf(words[0]);
+                // The range sits before the name, outside escaped words:
+                // in `output \esc[0] ` the brackets are part of the name.
+                range = std::string_view();
+                const std::string_view head = piece.substr(0, words.back().data() - piece.data());
+                for (size_t i = 0; i < head.size(); ++i) {
+                    if (head[i] == '\\') {
+                        while (i < head.size() && !isSpace(head[i])) ++i;
+                    } else if (head[i] == '[') {
+                        const size_t close = head.find(']', i);
+                        if (close != std::string_view::npos) range = head.substr(i, close - i + 1);
+                        break;
+                    }
+                }
+            }
+            if (direction != PortDirection::Unknown)
+                out_.port_decls.push_back({words.back(), range, direction});
+        }
+        if (comma == std::string_view::npos) break;
+        list = list.substr(comma + 1);
+    }
+}
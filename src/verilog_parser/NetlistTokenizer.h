@@ -0,0 +1,104 @@
+// File: src/verilog_parser/NetlistTokenizer.h
+#pragma once
+
+#include "StructuralScanner.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class PortDirection : uint8_t { Unknown, Input, Output, Inout };
+
+// Everything the tokenizer pulls out of one statement-aligned chunk of text.
+// Names are views into the tokenized buffer and die with it.
+struct ParsedChunk {
+    struct Instance {
+        std::string_view master;
+        std::string_view name;
+        std::string_view params;  // "(.W(4))" of `master #(.W(4)) name`, or empty
+    };
+    struct PinConnection {
+        uint32_t cell;  // index into cells
+        std::string_view pin;
+        std::string_view net;
+    };
+    // `input`/`output`/`inout`/`wire` declaration of one name.
+    struct Declaration {
+        std::string_view name;
+        std::string_view range;  // "[msb:lsb]" or empty
+        PortDirection direction = PortDirection::Unknown;
+    };
+
+    std::string_view module;  // first module header in the chunk
+    std::vector<std::string_view> ports;
+    std::vector<Declaration> port_decls;
+    std::vector<Declaration> nets;
+    std::vector<Instance> cells;
+    std::vector<PinConnection> pins;
+    // `assign lhs = rhs;`, one per assignment, sides as written.
+    struct Assign {
+        std::string_view lhs;
+        std::string_view rhs;
+    };
+    std::vector<Assign> assigns;
+
+    uint64_t lines = 0;       // only counted when the tokenizer is asked to
+    uint64_t statements = 0;
+};
+
+// Structural netlist tokenizer driven by StructuralScanner bitmaps. Only the
+// positions of ; ( ) . / and \ are visited; identifiers are the trimmed text
+// between them. Comments, (* attributes *) and escaped identifiers are
+// skipped as a whole.
+class NetlistTokenizer {
+public:
+    NetlistTokenizer(const StructuralScanner& scanner, ParsedChunk& out);
+
+    // `data` must begin and end on statement boundaries.
+    void tokenize(const char* data, size_t len);
+
+    // Line counting costs a popcount per block; off unless stats want it.
+    void setCountLines(bool count) { count_lines_ = count; }
+
+    // First offset at or after `pos` that starts a new line following a ';'
+    // outside comments, attributes, strings and escaped identifiers.
+    // Scanning starts at `from`, a boundary at or before `pos`, so a ';'
+    // inside a comment that spans `pos` is never taken. Used to cut a file
+    // into chunks that tokenize independently.
+    static size_t nextStatementBoundary(const char* data, size_t len, size_t from, size_t pos);
+
+private:
+    // Parameters: inside the `#( ... )` of `master #(...) name (...)`.
+    enum class Statement { None, Module, Parameters, Instance, Other };
+
+    void onStructural(size_t pos);
+    void skipComment(size_t pos);
+    void openParen(size_t pos);
+    void closeParen(size_t pos);
+    void endStatement(size_t pos);
+    void addDeclaration(std::string_view text);
+    bool addAssigns(std::string_view text);
+    void addPorts(std::string_view list);
+    void addNames(std::string_view names, std::string_view range, PortDirection direction, bool is_wire);
+
+    std::string_view text(size_t begin, size_t end) const;
+
+    const StructuralScanner& scanner_;
+    ParsedChunk& out_;
+
+    const char* data_ = nullptr;
+    size_t len_ = 0;
+    size_t skip_until_ = 0;
+    size_t stmt_begin_ = 0;
+    size_t list_begin_ = 0;
+    size_t pin_begin_ = 0;
+    size_t net_begin_ = 0;
+    int depth_ = 0;
+    bool in_pin_ = false;
+    bool count_lines_ = false;
+    Statement stmt_ = Statement::None;
+    std::string_view pin_;
+    std::string_view params_master_;  // master of a statement past its `#(...)`
+    std::string_view params_;         // that `(...)`
+};
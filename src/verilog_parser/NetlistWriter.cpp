@@ -0,0 +1,195 @@
+// File: src/verilog_parser/NetlistWriter.cpp
+
+#include "NetlistWriter.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kWiresPerBlock = 1 << 16;
+constexpr size_t kCellsPerBlock = 1 << 14;
+
+// Escaped identifiers end at whitespace, so they need one after them.
+inline void appendName(std::string& out, std::string_view name) {
+    out.append(name.data(), name.size());
+    if (!name.empty() && name.front() == '\\') out += ' ';
+}
+
+const char* directionKeyword(PortDirection direction) {
+    switch (direction) {
+        case PortDirection::Input:  return "input";
+        case PortDirection::Output: return "output";
+        case PortDirection::Inout:  return "inout";
+        default:                    return nullptr;
+    }
+}
+
+}  // namespace
+
+NetlistWriter::NetlistWriter(const NetlistDb& db, int num_threads)
+    : db_(db), num_threads_(std::max(1, num_threads)) {}
+
+void NetlistWriter::formatHeader(std::string& out) const {
+    out += "module ";
+    appendName(out, db_.moduleName().empty() ? std::string_view("top") : db_.moduleName());
+    out += '(';
+    const NameRange ports = db_.portNames();
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (i) out += ", ";
+        appendName(out, ports[i]);
+    }
+    out += ");\n";
+
+    for (size_t i = 0; i < ports.size(); ++i) {
+        const char* keyword = directionKeyword(db_.portDirection(i));
+        if (!keyword) continue;
+        out += "  ";
+        out += keyword;
+        out += ' ';
+        if (!db_.portRange(i).empty()) {
+            out.append(db_.portRange(i).data(), db_.portRange(i).size());
+            out += ' ';
+        }
+        appendName(out, ports[i]);
+        out += ";\n";
+    }
+}
+
+void NetlistWriter::formatWires(size_t begin, size_t end, std::string& out) const {
+    const NameRange wires = db_.wireNames();
+    for (size_t i = begin; i < end; ++i) {
+        out += "  wire ";
+        std::string_view range = db_.wireRange(i);
+        if (!range.empty()) {
+            out.append(range.data(), range.size());
+            out += ' ';
+        }
+        appendName(out, wires[i]);
+        out += ";\n";
+    }
+}
+
+void NetlistWriter::formatCells(size_t begin, size_t end, std::string& out) const {
+    for (NetlistDb::Id c = static_cast<NetlistDb::Id>(begin); c < end; ++c) {
+        out += "  ";
+        appendName(out, db_.cellMaster(c));
+        out += ' ';
+        const std::string_view params = db_.cellParameters(c);
+        if (!params.empty()) {
+            out += '#';
+            out.append(params.data(), params.size());
+            out += ' ';
+        }
+        appendName(out, db_.cellName(c));
+        out += " (";
+        for (NetlistDb::Id p = db_.pinBegin(c); p < db_.pinEnd(c); ++p) {
+            if (p != db_.pinBegin(c)) out += ", ";
+            out += '.';
+            appendName(out, db_.pinName(p));
+            out += '(';
+            appendName(out, db_.netName(db_.pinNet(p)));
+            out += ')';
+        }
+        out += ");\n";
+    }
+}
+
+void NetlistWriter::formatAssigns(std::string& out) const {
+    for (size_t i = 0; i < db_.assignCount(); ++i) {
+        out += "  assign ";
+        out += db_.assignLhs(i);
+        out += " = ";
+        const std::string_view rhs = db_.assignRhs(i);
+        out += rhs;
+        // An escaped name at the end needs whitespace before the ';'.
+        out += rhs.find('\\') == std::string_view::npos ? ";\n" : " ;\n";
+    }
+}
+
+void NetlistWriter::format(const Block& block, std::string& out) const {
+    out.clear();
+    switch (block.section) {
+        case Section::Header:  formatHeader(out); break;
+        case Section::Wires:   formatWires(block.begin, block.end, out); break;
+        case Section::Cells:   formatCells(block.begin, block.end, out); break;
+        case Section::Assigns: formatAssigns(out); break;
+        case Section::Footer:  out += "endmodule\n"; break;
+    }
+}
+
+bool NetlistWriter::writeBuffers(int fd, const std::vector<std::string>& buffers, size_t count) {
+    std::vector<iovec> iov;
+    iov.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (!buffers[i].empty()) iov.push_back({const_cast<char*>(buffers[i].data()), buffers[i].size()});
+    }
+
+    size_t next = 0;
+    while (next < iov.size()) {
+        const int n = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+        ssize_t written = ::writev(fd, &iov[next], n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes_written_ += static_cast<uint64_t>(written);
+        // Skip fully written buffers; trim a partially written one.
+        size_t left = static_cast<size_t>(written);
+        while (next < iov.size() && left >= iov[next].iov_len) left -= iov[next++].iov_len;
+        if (left) {
+            iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + left;
+            iov[next].iov_len -= left;
+        }
+    }
+    return true;
+}
+
+bool NetlistWriter::write(const std::string& file_path) {
+    TraceScope trace("write", "write_verilog", file_path);
+    bytes_written_ = 0;
+
+    std::vector<Block> blocks;
+    blocks.push_back({Section::Header, 0, 0});
+    for (size_t b = 0; b < db_.wires().size(); b += kWiresPerBlock)
+        blocks.push_back({Section::Wires, b, std::min(b + kWiresPerBlock, db_.wires().size())});
+    for (size_t b = 0; b < db_.cellCount(); b += kCellsPerBlock)
+        blocks.push_back({Section::Cells, b, std::min(b + kCellsPerBlock, db_.cellCount())});
+    if (db_.assignCount() > 0) blocks.push_back({Section::Assigns, 0, 0});
+    blocks.push_back({Section::Footer, 0, 0});
+
+    int fd = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[ERROR] Failed to open file for writing: " << file_path << std::endl;
+        return false;
+    }
+
+    // Format a few blocks per thread at a time so memory stays bounded by
+    // the wave, not the design.
+    const size_t wave = static_cast<size_t>(num_threads_) * 4;
+    std::vector<std::string> buffers(std::min(wave, blocks.size()));
+    bool ok = true;
+    for (size_t first = 0; first < blocks.size() && ok; first += wave) {
+        const size_t count = std::min(wave, blocks.size() - first);
+        {
+            TraceScope format_trace("write", "format");
+            ThreadPool::instance().parallelFor(0, count, 1, [&](size_t i, size_t) {
+                format(blocks[first + i], buffers[i]);
+            });
+        }
+        TraceScope write_trace("write", "writev");
+        ok = writeBuffers(fd, buffers, count);
+    }
+
+    if (!ok) std::cerr << "[ERROR] Failed to write " << file_path << ": " << std::strerror(errno) << std::endl;
+    if (::close(fd) != 0) ok = false;
+    return ok;
+}
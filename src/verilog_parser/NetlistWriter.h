@@ -0,0 +1,41 @@
+// File: src/verilog_parser/NetlistWriter.h
+#pragma once
+
+#include "NetlistDb.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Writes a NetlistDb back out as flat structural Verilog that load_verilog
+// reads into the same database, parameter lists and assigns included. The wire and instance sections are cut into
+// fixed-size blocks; each pool thread formats whole blocks into its own
+// buffer, and every wave of finished buffers goes to the file in order
+// with writev.
+class NetlistWriter {
+public:
+    NetlistWriter(const NetlistDb& db, int num_threads);
+
+    bool write(const std::string& file_path);
+
+    uint64_t bytesWritten() const { return bytes_written_; }
+
+private:
+    enum class Section { Header, Wires, Cells, Assigns, Footer };
+    struct Block {
+        Section section;
+        size_t begin;
+        size_t end;
+    };
+
+    void format(const Block& block, std::string& out) const;
+    void formatHeader(std::string& out) const;
+    void formatWires(size_t begin, size_t end, std::string& out) const;
+    void formatCells(size_t begin, size_t end, std::string& out) const;
+    void formatAssigns(std::string& out) const;
+    bool writeBuffers(int fd, const std::vector<std::string>& buffers, size_t count);
+
+    const NetlistDb& db_;
+    int num_threads_;
+    uint64_t bytes_written_ = 0;
+};
@@ -0,0 +1,118 @@
+// File: src/verilog_parser/ParseStats.cpp
+
+#include "ParseStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+
+const char* ParseStats::phaseName(Phase phase) {
+    switch (phase) {
+        case Read:     return "read";
+        case Chunk:    return "chunk";
+        case Tokenize: return "tokenize";
+        case Intern:   return "intern";
+        case Merge:    return "merge";
+        case Index:    return "index";
+        default:       return "unknown";
+    }
+}
+
+namespace {
+
+// A "Key:   1234 kB" line of /proc/self/status; -1 when it is missing.
+long statusKb(const char* key) {
+    FILE* f = std::fopen("/proc/self/status", "r");
+    if (!f) return -1;
+    const size_t key_len = std::strlen(key);
+    long kb = -1;
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        if (std::strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+            kb = std::strtol(line + key_len + 1, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(f);
+    return kb;
+}
+
+}  // namespace
+
+// Both come from /proc/self/status when it is there, so the peak is never
+// below the current value; getrusage() only backs up the peak.
+long peakRssKb() {
+    const long hwm = statusKb("VmHWM");
+    if (hwm >= 0) return std::max(hwm, currentRssKb());
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+long currentRssKb() {
+    return std::max(0L, statusKb("VmRSS"));
+}
+
+std::string ParseStats::toText() const {
+    if (!valid) return "No parse statistics recorded. Run load_verilog with parse stats enabled.\n";
+
+    char buf[256];
+    std::string out = "Parse statistics for " + file + "\n";
+    std::snprintf(buf, sizeof(buf), "  threads      %d\n", threads);
+    out += buf;
+    out += "  Phase            seconds      %\n";
+    for (int p = 0; p < NumPhases; ++p) {
+        double pct = total_seconds > 0 ? 100.0 * seconds[p] / total_seconds : 0.0;
+        std::snprintf(buf, sizeof(buf), "  %-12s %11.6f %6.1f\n", phaseName(static_cast<Phase>(p)), seconds[p], pct);
+        out += buf;
+    }
+    std::snprintf(buf, sizeof(buf), "  %-12s %11.6f\n", "total", total_seconds);
+    out += buf;
+
+    const double mb = bytes / 1048576.0;
+    std::snprintf(buf, sizeof(buf),
+                  "  bytes        %llu (%.1f MB, %.1f MB/s)\n"
+                  "  lines        %llu\n"
+                  "  statements   %llu\n"
+                  "  instances    %llu\n"
+                  "  pins         %llu\n"
+                  "  hash probes  %llu\n"
+                  "  lock waits   %llu\n"
+                  "  peak RSS     %ld kB\n",
+                  static_cast<unsigned long long>(bytes), mb, total_seconds > 0 ? mb / total_seconds : 0.0,
+                  static_cast<unsigned long long>(lines), static_cast<unsigned long long>(statements),
+                  static_cast<unsigned long long>(instances), static_cast<unsigned long long>(pins),
+                  static_cast<unsigned long long>(hash_probes), static_cast<unsigned long long>(lock_waits),
+                  peak_rss_kb);
+    out += buf;
+    return out;
+}
+
+std::string ParseStats::toJson() const {
+    std::string escaped;
+    for (char c : file) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    char buf[256];
+    std::string out = "{\"file\": \"" + escaped + "\", ";
+    std::snprintf(buf, sizeof(buf), "\"valid\": %s, \"threads\": %d, \"phases\": {", valid ? "true" : "false", threads);
+    out += buf;
+    for (int p = 0; p < NumPhases; ++p) {
+        std::snprintf(buf, sizeof(buf), "%s\"%s\": %.6f", p ? ", " : "", phaseName(static_cast<Phase>(p)), seconds[p]);
+        out += buf;
+    }
+    std::snprintf(buf, sizeof(buf),
+                  "}, \"total_seconds\": %.6f, \"bytes\": %llu, \"lines\": %llu, \"statements\": %llu, "
+                  "\"instances\": %llu, \"pins\": %llu, \"hash_probes\": %llu, \"lock_waits\": %llu, "
+                  "\"peak_rss_kb\": %ld}",
+                  total_seconds, static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(lines),
+                  static_cast<unsigned long long>(statements), static_cast<unsigned long long>(instances),
+                  static_cast<unsigned long long>(pins), static_cast<unsigned long long>(hash_probes),
+                  static_cast<unsigned long long>(lock_waits), peak_rss_kb);
+    out += buf;
+    return out;
+}
@@ -0,0 +1,63 @@
+// File: src/verilog_parser/ParseStats.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Where the time and work of the last load went. Filled by VerilogParser
+// when stats are enabled; reported by report_parse_stats.
+struct ParseStats {
+    enum Phase {
+        Read,      // reading/mapping the file
+        Chunk,     // cutting it at statement boundaries
+        Tokenize,  // parallel tokenizer pass
+        Intern,    // name interning
+        Merge,     // sizing the combined pin arrays
+        Index,     // building lookup indexes
+        NumPhases
+    };
+
+    static const char* phaseName(Phase phase);
+
+    std::string file;
+    int threads = 0;
+    bool valid = false;
+
+    double seconds[NumPhases] = {};
+    double total_seconds = 0.0;
+
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t statements = 0;
+    uint64_t instances = 0;
+    uint64_t pins = 0;
+    uint64_t hash_probes = 0;
+    uint64_t lock_waits = 0;
+    long peak_rss_kb = 0;
+
+    std::string toText() const;
+    std::string toJson() const;
+};
+
+// Adds the lifetime of the scope to `slot`; does nothing when disabled.
+class PhaseTimer {
+public:
+    PhaseTimer(bool enabled, double& slot) : slot_(enabled ? &slot : nullptr) {
+        if (slot_) start_ = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if (slot_) *slot_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    double* slot_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Peak and current resident set size of this process in kB.
+long peakRssKb();
+long currentRssKb();
@@ -0,0 +1,57 @@
+// File: src/verilog_parser/PinDirections.cpp
+
+#include "PinDirections.h"
+
+namespace {
+
+// Glob match with '*' only.
+bool matches(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0, star = std::string_view::npos, resume = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        } else if (p < pattern.size() && pattern[p] == text[t]) {
+            ++p;
+            ++t;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            t = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+}  // namespace
+
+PinDirections::PinDirections() {
+    for (const char* pin : {"Z", "ZN", "Q", "QN", "Y", "YN", "X", "CO"}) set("*", pin, PortDirection::Output);
+    // Adder sums; S is a select input everywhere else.
+    set("FA_*", "S", PortDirection::Output);
+    set("HA_*", "S", PortDirection::Output);
+}
+
+void PinDirections::set(std::string_view master, std::string_view pin, PortDirection direction) {
+    rules_.push_back({std::string(master), std::string(pin), direction});
+}
+
+PortDirection PinDirections::lookup(std::string_view master, std::string_view pin) const {
+    for (auto it = rules_.rbegin(); it != rules_.rend(); ++it) {
+        if (it->pin == pin && matches(it->master, master)) return it->direction;
+    }
+    return PortDirection::Input;
+}
+
+PinDirections::Table PinDirections::resolve(const NetlistDb& db) const {
+    Table table;
+    table.stride_ = db.pinNameCount();
+    table.dirs_.resize(db.masterCount() * table.stride_);
+    for (NetlistDb::Id m = 0; m < db.masterCount(); ++m) {
+        for (NetlistDb::Id n = 0; n < table.stride_; ++n)
+            table.dirs_[m * table.stride_ + n] = lookup(db.masterName(m), db.pinNameById(n));
+    }
+    return table;
+}
@@ -0,0 +1,44 @@
+// File: src/verilog_parser/PinDirections.h
+#pragma once
+
+#include "NetlistDb.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Instance pin directions. Netlists carry no library, so directions come
+// from rules keyed on master and pin name: the common output pin names of
+// standard-cell libraries are preset, and set_pin_direction adds more.
+// Later rules win over earlier ones.
+class PinDirections {
+public:
+    PinDirections();
+
+    // `master` may contain '*' wildcards; "*" matches every master.
+    void set(std::string_view master, std::string_view pin, PortDirection direction);
+    PortDirection lookup(std::string_view master, std::string_view pin) const;
+
+    // Directions resolved for every (master, pin name) pair of one design;
+    // pins no rule covers are inputs.
+    class Table {
+    public:
+        PortDirection of(const NetlistDb& db, NetlistDb::Id pin) const {
+            return dirs_[db.cellMasterId(db.pinCell(pin)) * stride_ + db.pinNameId(pin)];
+        }
+
+    private:
+        friend class PinDirections;
+        size_t stride_ = 0;
+        std::vector<PortDirection> dirs_;
+    };
+    Table resolve(const NetlistDb& db) const;
+
+private:
+    struct Rule {
+        std::string master;
+        std::string pin;
+        PortDirection direction;
+    };
+    std::vector<Rule> rules_;
+};
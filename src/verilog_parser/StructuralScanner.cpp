@@ -0,0 +1,132 @@
+// File: src/verilog_parser/StructuralScanner.cpp
+
+#include "StructuralScanner.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VERILOG_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+void scanBlockScalar(const char* block, StructuralBlock& out) {
+    out = StructuralBlock{};
+    for (int i = 0; i < 64; ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        switch (block[i]) {
+            case '\n': out.newline |= bit; break;
+            case ';':  out.semicolon |= bit; break;
+            case '(':  out.open_paren |= bit; break;
+            case ')':  out.close_paren |= bit; break;
+            case '.':  out.dot |= bit; break;
+            case '/':  out.slash |= bit; break;
+            case '\\': out.backslash |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#ifdef VERILOG_SCANNER_X86
+
+__attribute__((target("sse4.2")))
+inline uint64_t matchSSE(const __m128i chunk[4], char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    uint64_t m0 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk[0], needle)));
+    uint64_t m1 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk[1], needle)));
+    uint64_t m2 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk[2], needle)));
+    uint64_t m3 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk[3], needle)));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+__attribute__((target("sse4.2")))
+void scanBlockSSE42(const char* block, StructuralBlock& out) {
+    const __m128i chunk[4] = {
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)),
+    };
+    out.newline = matchSSE(chunk, '\n');
+    out.semicolon = matchSSE(chunk, ';');
+    out.open_paren = matchSSE(chunk, '(');
+    out.close_paren = matchSSE(chunk, ')');
+    out.dot = matchSSE(chunk, '.');
+    out.slash = matchSSE(chunk, '/');
+    out.backslash = matchSSE(chunk, '\\');
+}
+
+__attribute__((target("avx2")))
+inline uint64_t matchAVX2(__m256i lo, __m256i hi, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    uint64_t m0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    uint64_t m1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return m0 | (m1 << 32);
+}
+
+__attribute__((target("avx2")))
+void scanBlockAVX2(const char* block, StructuralBlock& out) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    out.newline = matchAVX2(lo, hi, '\n');
+    out.semicolon = matchAVX2(lo, hi, ';');
+    out.open_paren = matchAVX2(lo, hi, '(');
+    out.close_paren = matchAVX2(lo, hi, ')');
+    out.dot = matchAVX2(lo, hi, '.');
+    out.slash = matchAVX2(lo, hi, '/');
+    out.backslash = matchAVX2(lo, hi, '\\');
+}
+
+#endif  // VERILOG_SCANNER_X86
+
+}  // namespace
+
+StructuralScanner::StructuralScanner() : StructuralScanner(detectKernel()) {}
+
+StructuralScanner::StructuralScanner(ScanKernel kernel) {
+    if (!isSupported(kernel)) kernel = ScanKernel::Scalar;
+    kernel_ = kernel;
+    switch (kernel) {
+#ifdef VERILOG_SCANNER_X86
+        case ScanKernel::AVX2:  fn_ = scanBlockAVX2; break;
+        case ScanKernel::SSE42: fn_ = scanBlockSSE42; break;
+#endif
+        default:                fn_ = scanBlockScalar; break;
+    }
+}
+
+ScanKernel StructuralScanner::detectKernel() {
+    if (isSupported(ScanKernel::AVX2)) return ScanKernel::AVX2;
+    if (isSupported(ScanKernel::SSE42)) return ScanKernel::SSE42;
+    return ScanKernel::Scalar;
+}
+
+bool StructuralScanner::isSupported(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::Scalar:
+            return true;
+#ifdef VERILOG_SCANNER_X86
+        case ScanKernel::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case ScanKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* StructuralScanner::kernelName(ScanKernel kernel) {
+    switch (kernel) {
+        case ScanKernel::AVX2:  return "avx2";
+        case ScanKernel::SSE42: return "sse4.2";
+        default:                return "scalar";
+    }
+}
+
+void StructuralScanner::scanPartialBlock(const char* block, size_t len, StructuralBlock& out) const {
+    char padded[64];
+    std::memset(padded, ' ', sizeof(padded));
+    std::memcpy(padded, block, len < 64 ? len : 64);
+    fn_(padded, out);
+}
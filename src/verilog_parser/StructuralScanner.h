@@ -0,0 +1,51 @@
+// File: src/verilog_parser/StructuralScanner.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Bitmaps of the structural characters in one 64-byte block of netlist text.
+// Bit i is set when byte i of the block is that character.
+struct StructuralBlock {
+    uint64_t newline = 0;
+    uint64_t semicolon = 0;
+    uint64_t open_paren = 0;
+    uint64_t close_paren = 0;
+    uint64_t dot = 0;
+    uint64_t slash = 0;
+    uint64_t backslash = 0;
+};
+
+enum class ScanKernel {
+    Scalar,
+    SSE42,
+    AVX2
+};
+
+// Classifies netlist text 64 bytes at a time. The kernel is picked once at
+// construction from what the running CPU supports; all kernels produce
+// identical bitmaps.
+class StructuralScanner {
+public:
+    StructuralScanner();
+    explicit StructuralScanner(ScanKernel kernel);
+
+    // Widest kernel the running CPU supports.
+    static ScanKernel detectKernel();
+    static bool isSupported(ScanKernel kernel);
+    static const char* kernelName(ScanKernel kernel);
+
+    ScanKernel kernel() const { return kernel_; }
+
+    // Classifies exactly 64 readable bytes at `block`.
+    void scanBlock(const char* block, StructuralBlock& out) const { fn_(block, out); }
+
+    // Classifies `len` (< 64) bytes; the missing tail reads as no structurals.
+    void scanPartialBlock(const char* block, size_t len, StructuralBlock& out) const;
+
+private:
+    using BlockFn = void (*)(const char*, StructuralBlock&);
+
+    ScanKernel kernel_;
+    BlockFn fn_;
+};
@@ -1,244 +1,174 @@
 // File: src/verilog_parser/VerilogParser.cpp
 
 #include "VerilogParser.h"
+#include "util/ThreadPool.h"
+#include "util/Tracer.h"
 #include <fstream>
-#include <sstream>
 #include <algorithm>
-#include <regex>
+#include <chrono>
 #include <iostream>
-#include <cctype>
-#include <thread>
-#include <mutex>
-#include <QMap>
-#include <QString>
-#include <QStringList>
-#include <QPair>
+#include <iterator>
 
+VerilogParser::VerilogParser() : db_(std::make_shared<const NetlistDb>()) {}
 
+VerilogParser::~VerilogParser() {
+    waitForLoad();
+}
 
-bool VerilogParser::parseFile(const std::string& file_path) {
-    std::ifstream file(file_path);
+bool VerilogParser::read_file(const std::string& file_path, std::string& buffer) {
+    std::ifstream file(file_path, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "[ERROR] Failed to open file: " << file_path << std::endl;
         return false;
     }
+    file.seekg(0, std::ios::end);
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&buffer[0], buffer.size());
+    return true;
+}
 
-    std::string line;
-    int line_num = 0;
-    while (std::getline(file, line)) {
-        ++line_num;
-        std::cout << "[INFO] Line " << line_num << ": " << line << std::endl;
-        parse_line(strip_comments(line));
-    }
+bool VerilogParser::parseFile(const std::string& file_path) {
+    if (!load(file_path, 1)) return false;
     std::cout << "[INFO] Parsing complete." << std::endl;
     return true;
 }
 
 bool VerilogParser::parseFileMultithreaded(const std::string& file_path, int num_threads) {
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        std::cerr << "[ERROR] Failed to open file: " << file_path << std::endl;
-        return false;
-    }
-
-    std::vector<std::string> lines;
-    std::string line;
-    while (std::getline(file, line)) {
-        lines.push_back(strip_comments(line));
-    }
-
-    std::vector<std::vector<std::string>> thread_ports(num_threads);
-    std::vector<std::vector<std::string>> thread_cells(num_threads);
-    std::vector<std::vector<std::string>> thread_nets(num_threads);
-    std::mutex mutex_;
-
-    std::vector<std::thread> threads;
-    auto worker = [&](int id_thread, int start, int end) {
-        std::regex module_decl(R"(^\s*module\s+(\w+)\s*\(([^;]*)\);)");
-        std::regex wire_decl(R"(^\s*wire\s+(\S+);)");
-        std::regex instance_decl(R"(^\s*(\w+)\s+(\w+)\s*\(.*\);)");
-        std::regex instance_start(R"(^\s*(\w+)\s+(\w+)\s*\(\s*$)");
-        std::regex pin_conn(R"(\.([A-Za-z0-9_]+)\s*\(\s*([A-Za-z0-9_]+)\s*\))");
-        std::regex instance_full(R"(^\s*(\w+)\s+(\w+)\s*\(.*\)\s*;\s*$)");
-
-        bool buffer_mode = false;
-        std::string buffer, current_cell;
-
-        for (int i = start; i < end; ++i) {
-            const std::string& line = lines[i];
-            std::smatch match;
-
-            if (buffer_mode) {
-                buffer += " " + line;
-                if (line.find(");") != std::string::npos) {
-                    if (std::regex_match(buffer, match, instance_full)) {
-                        std::lock_guard<std::mutex> lock(mutex_);
-                        thread_cells[id_thread].push_back(match[2]);
-                        current_cell = match[2];
-
-                        std::sregex_iterator it(buffer.begin(), buffer.end(), pin_conn);
-                        std::sregex_iterator end_it;
-                        while (it != end_it) {
-                            std::string pin = (*it)[1];
-                            std::string net = (*it)[2];
-                            pins_by_cell_[current_cell].push_back(pin);
-                            net_by_pin_[{current_cell, pin}] = net;
-                            ++it;
-                        }
-                    }
-                    buffer.clear();
-                    buffer_mode = false;
-                }
-                continue;
-            }
-
-            if (std::regex_search(line, match, module_decl)) {
-                std::stringstream ss(match[2]);
-                std::string port_id;
-                while (std::getline(ss, port_id, ',')) {
-                    port_id.erase(std::remove_if(port_id.begin(), port_id.end(), ::isspace), port_id.end());
-                    if (!port_id.empty()) thread_ports[id_thread].push_back(port_id);
-                }
-            } else if (std::regex_search(line, match, wire_decl)) {
-                thread_nets[id_thread].push_back(match[1]);
-            } else if (std::regex_match(line, match, instance_decl)) {
-                std::lock_guard<std::mutex> lock(mutex_);
-                thread_cells[id_thread].push_back(match[2]);
-                current_cell = match[2];
-
-                std::sregex_iterator it(line.begin(), line.end(), pin_conn);
-                std::sregex_iterator end_it;
-                while (it != end_it) {
-                    std::string pin = (*it)[1];
-                    std::string net = (*it)[2];
-                    pins_by_cell_[current_cell].push_back(pin);
-                    net_by_pin_[{current_cell, pin}] = net;
-                    ++it;
-                }
-            } else if (std::regex_match(line, match, instance_start)) {
-                buffer = line;
-                buffer_mode = true;
-            }
-        }
-    };
-
-    int chunk = lines.size() / num_threads;
-    for (int i = 0; i < num_threads; ++i) {
-        int start = i * chunk;
-        int end = (i == num_threads - 1) ? lines.size() : (i + 1) * chunk;
-        threads.emplace_back(worker, i, start, end);
-    }
-
-    for (auto& t : threads) t.join();
-
-    for (int i = 0; i < num_threads; ++i) {
-        ports_.insert(ports_.end(), thread_ports[i].begin(), thread_ports[i].end());
-        nets_.insert(nets_.end(), thread_nets[i].begin(), thread_nets[i].end());
-        cells_.insert(cells_.end(), thread_cells[i].begin(), thread_cells[i].end());
-    }
-
-    return true;
+    return load(file_path, std::max(1, num_threads));
 }
 
-std::string VerilogParser::strip_comments(const std::string& line) {
-    auto pos = line.find("//");
-    return (pos != std::string::npos) ? line.substr(0, pos) : line;
+void VerilogParser::parseFileAsync(const std::string& file_path, int num_threads) {
+    waitForLoad();
+    pending_ = std::async(std::launch::async, [this, file_path, num_threads]() {
+        Tracer::instance().setThreadName("loader");
+        return parseFileMultithreaded(file_path, num_threads);
+    });
 }
 
+bool VerilogParser::waitForLoad() {
+    if (!pending_.valid()) return true;
+    return pending_.get();
+}
 
+ParseStats VerilogParser::get_parse_stats() const {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    return stats_;
+}
 
-void VerilogParser::parse_line(const std::string& line) {
-    if (line.empty()) return;
+bool VerilogParser::load(const std::string& file_path, int num_threads) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    // The last load's numbers never describe this one, even when this one
+    // is not timed or fails.
+    stats_ = ParseStats();
+    ParseStats stats;
+    stats.file = file_path;
+    stats.threads = num_threads;
+    const bool timed = stats_enabled_;
+    TraceScope trace_load("parse", "load", file_path);
+    const uint64_t lock_waits_before = ThreadPool::instance().lockWaits();
+    auto start = std::chrono::steady_clock::now();
+
+    std::string buffer;
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Read]);
+        TraceScope trace("parse", "read");
+        if (!read_file(file_path, buffer)) return false;
+    }
 
-    std::regex module_decl(R"(^\s*module\s+(\w+)\s*\(([^;]*)\);)");
-    std::regex wire_decl(R"(^\s*wire\s+(\S+);)");
-    std::regex instance_decl(R"(^\s*(\w+)\s+(\w+)\s*\(.*\);)");
-    std::regex instance_start(R"(^\s*(\w+)\s+(\w+)\s*\(\s*$)");
-    std::regex instance_full(R"(^\s*(\w+)\s+(\w+)\s*\(.*\)\s*;\s*$)");
+    // Cut the file at statement boundaries so every chunk tokenizes on its own
+    // and no instance straddles two workers. Each search resumes from the
+    // previous cut, so a comment is never mistaken for code.
+    std::vector<size_t> bounds{0};
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Chunk]);
+        TraceScope trace("parse", "chunk");
+        for (int i = 1; i < num_threads; ++i) {
+            size_t nominal = buffer.size() / num_threads * i;
+            size_t cut = NetlistTokenizer::nextStatementBoundary(buffer.data(), buffer.size(), bounds.back(),
+                                                                 std::max(nominal, bounds.back()));
+            bounds.push_back(cut);
+        }
+        bounds.push_back(buffer.size());
+    }
 
-    std::smatch match;
+    std::vector<ParsedChunk> chunks(num_threads);
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Tokenize]);
+        TraceScope trace("parse", "tokenize");
+        ThreadPool::instance().parallelFor(0, num_threads, 1, [&](size_t i, size_t) {
+            TraceScope trace("parse", "tokenize chunk", "chunk " + std::to_string(i));
+            NetlistTokenizer tokenizer(scanner_, chunks[i]);
+            tokenizer.setCountLines(timed);
+            tokenizer.tokenize(buffer.data() + bounds[i], bounds[i + 1] - bounds[i]);
+        });
+    }
 
-    if (buffering_instance_) {
-        instance_buffer_ += " " + line;
-        if (line.find(");") != std::string::npos) {
-            if (std::regex_match(instance_buffer_, match, instance_full)) {
-                cells_.push_back(match[2]);
+    // Size the per-pin arrays once, then copy every name into the new
+    // database. Readers keep seeing the old design until it is published.
+    auto db = std::make_shared<NetlistDb>();
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Merge]);
+        TraceScope trace("parse", "merge");
+        size_t cells = 0, pins = 0;
+        for (const auto& chunk : chunks) {
+            cells += chunk.cells.size();
+            pins += chunk.pins.size();
+            if (timed) {
+                stats.lines += chunk.lines;
+                stats.statements += chunk.statements;
             }
-            buffering_instance_ = false;
-            instance_buffer_.clear();
         }
-        return;
+        stats.instances = cells;
+        stats.pins = pins;
+        db->reserve(cells, pins);
     }
 
-    if (std::regex_search(line, match, module_decl)) {
-        extract_identifiers(match[2], ports_);
-        inside_module_ = true;
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Intern]);
+        TraceScope trace("parse", "intern");
+        for (const auto& chunk : chunks) intern_chunk(chunk, *db);
     }
-    else if (std::regex_search(line, match, wire_decl)) {
-        nets_.push_back(match[1]);
-    }
-    else if (std::regex_match(line, match, instance_decl)) {
-        cells_.push_back(match[2]);
-    }
-    else if (std::regex_match(line, match, instance_start)) {
-        instance_buffer_ = line;
-        buffering_instance_ = true;
-    }
-}
 
-void VerilogParser::extract_identifiers(const std::string& text, std::vector<std::string>& target) {
-    std::stringstream ss(text);
-    std::string id;
-    while (std::getline(ss, id, ',')) {
-        id.erase(std::remove_if(id.begin(), id.end(), ::isspace), id.end());
-        if (!id.empty()) target.push_back(id);
+    {
+        PhaseTimer t(timed, stats.seconds[ParseStats::Index]);
+        TraceScope trace("parse", "index");
+        db->finish();
     }
-}
-
-std::vector<std::string> VerilogParser::get_ports() const {
-    return ports_;
-}
-
-std::vector<std::string> VerilogParser::get_cells() const {
-    return cells_;
-}
-
-std::vector<std::string> VerilogParser::get_nets() const {
-    return nets_;
-}
-
-std::vector<std::string> VerilogParser::get_pins(const std::string& cell) const {
-    auto it = pins_by_cell_.find(cell);
-    if (it != pins_by_cell_.end()) return it->second;
-    return {};
-}
 
-std::string VerilogParser::get_net_for_pin(const std::string& cell, const std::string& pin) const {
-    auto it = net_by_pin_.find({cell, pin});
-    return (it != net_by_pin_.end()) ? it->second : "";
-}
+    const uint64_t hash_probes = db->hashProbes();
+    {
+        // Publish, then drop our reference to the previous design; it is
+        // freed here unless a reader still holds it.
+        TraceScope trace("parse", "publish");
+        Snapshot previous = std::atomic_exchange(&db_, Snapshot(std::move(db)));
+    }
 
-QMap<QString, QStringList> VerilogParser::getPinsByCell() const {
-    QMap<QString, QStringList> result;
-    for (const auto& [cell, pins] : pins_by_cell_) {
-        QString qcell = QString::fromStdString(cell);
-        QStringList qpins;
-        for (const auto& pin : pins) {
-            qpins.append(QString::fromStdString(pin));
-        }
-        result[qcell] = qpins;
+    if (timed) {
+        stats.total_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.bytes = buffer.size();
+        stats.hash_probes = hash_probes;
+        stats.lock_waits = ThreadPool::instance().lockWaits() - lock_waits_before;
+        stats.peak_rss_kb = peakRssKb();
+        stats.valid = true;
+        stats_ = std::move(stats);
     }
-    return result;
+    return true;
 }
 
-QMap<QPair<QString, QString>, QString> VerilogParser::getNetByPin() const {
-    QMap<QPair<QString, QString>, QString> result;
-    for (const auto& [pin_key, net] : net_by_pin_) {
-        QString qcell = QString::fromStdString(pin_key.first);
-        QString qpin  = QString::fromStdString(pin_key.second);
-        QString qnet  = QString::fromStdString(net);
-        result[{qcell, qpin}] = qnet;
+void VerilogParser::intern_chunk(const ParsedChunk& chunk, NetlistDb& db) {
+    if (db.moduleName().empty() && !chunk.module.empty()) db.setModuleName(chunk.module);
+    for (auto port : chunk.ports) db.addPort(port);
+    for (const auto& decl : chunk.port_decls) db.addPortDeclaration(decl.name, decl.range, decl.direction);
+    for (const auto& net : chunk.nets) db.addWire(net.name, net.range);
+
+    // Pins come grouped by cell, in cell order.
+    size_t p = 0;
+    for (uint32_t c = 0; c < chunk.cells.size(); ++c) {
+        db.addCell(chunk.cells[c].name, chunk.cells[c].master);
+        db.setCellParameters(chunk.cells[c].params);
+        for (; p < chunk.pins.size() && chunk.pins[p].cell == c; ++p)
+            db.addPin(chunk.pins[p].pin, chunk.pins[p].net);
     }
-    return result;
+    for (const auto& assign : chunk.assigns) db.addAssign(assign.lhs, assign.rhs);
 }
-
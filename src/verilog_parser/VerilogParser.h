@@ -1,53 +1,65 @@
 #pragma once
-#include <QMap>
-#include <QString>
-#include <QStringList>
-#include <QPair>
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
-#include <unordered_map>
-
-// Hash and Equal function for std::pair<std::string, std::string>
-struct PairHash {
-    std::size_t operator()(const std::pair<std::string, std::string>& p) const {
-        std::hash<std::string> hasher;
-        return hasher(p.first) ^ (hasher(p.second) << 1);
-    }
-};
 
-struct PairEqual {
-    bool operator()(const std::pair<std::string, std::string>& lhs,
-                    const std::pair<std::string, std::string>& rhs) const {
-        return lhs.first == rhs.first && lhs.second == rhs.second;
-    }
-};
+#include "NetlistDb.h"
+#include "NetlistTokenizer.h"
+#include "ParseStats.h"
+#include "StructuralScanner.h"
 
+// Loads netlists and publishes each one as an immutable snapshot. A load
+// builds a complete new NetlistDb off to the side and swaps it in with one
+// atomic pointer store; readers that took a snapshot keep using it
+// untouched, and the old design is freed when the last of them lets go.
 class VerilogParser {
 public:
+    using Snapshot = std::shared_ptr<const NetlistDb>;
+
+    VerilogParser();
+    ~VerilogParser();
+
+    VerilogParser(const VerilogParser&) = delete;
+    VerilogParser& operator=(const VerilogParser&) = delete;
+
     bool parseFile(const std::string& file_path);
     bool parseFileMultithreaded(const std::string& file_path, int num_threads);
-    std::vector<std::string> get_ports() const;
-    std::vector<std::string> get_cells() const;
-    std::vector<std::string> get_nets() const;
-    std::vector<std::string> get_pins(const std::string& cell) const;
-    std::string get_net_for_pin(const std::string& cell, const std::string& pin) const;
-    QMap<QString, QStringList> getPinsByCell() const;
-    QMap<QPair<QString, QString>, QString> getNetByPin() const;
+
+    // Starts parseFileMultithreaded on a background thread and returns at
+    // once. Waits for a load that is still running first.
+    void parseFileAsync(const std::string& file_path, int num_threads);
+    // Blocks until the background load is done; its result, or true if none
+    // was started.
+    bool waitForLoad();
+    bool loadPending() const { return pending_.valid(); }
+
+    // The current design. Never null; empty before the first load. Names
+    // and spans taken from it stay valid while the snapshot is held.
+    Snapshot snapshot() const { return std::atomic_load(&db_); }
+
+    // Per-phase timings and counters of the last load. Collection is on by
+    // default; when off, loads skip every timer and counter.
+    ParseStats get_parse_stats() const;
+    void set_stats_enabled(bool enabled) { stats_enabled_ = enabled; }
+    bool stats_enabled() const { return stats_enabled_; }
+
+    MemoryUsage get_memory_usage() const { return snapshot()->memoryUsage(); }
 
 private:
-    std::string strip_comments(const std::string& line);
-    void parse_line(const std::string& line);
-    void extract_identifiers(const std::string& text, std::vector<std::string>& target);
-
-    bool inside_module_ = false;
-    bool buffering_instance_ = false;
-    std::string instance_buffer_;
-
-    std::vector<std::string> ports_;
-    std::vector<std::string> nets_;
-    std::vector<std::string> cells_;
-    std::unordered_map<std::string, std::vector<std::string>> pins_by_cell_;
-    std::unordered_map<std::pair<std::string, std::string>, std::string, PairHash, PairEqual> net_by_pin_;
-};
+    bool load(const std::string& file_path, int num_threads);
+    bool read_file(const std::string& file_path, std::string& buffer);
+    static void intern_chunk(const ParsedChunk& chunk, NetlistDb& db);
 
+    StructuralScanner scanner_;
+    std::atomic<bool> stats_enabled_{true};
+
+    mutable std::mutex load_mutex_;  // one load at a time; guards stats_
+    ParseStats stats_;
+    std::future<bool> pending_;
+
+    Snapshot db_;  // accessed only through std::atomic_load/atomic_store
+};